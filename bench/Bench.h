@@ -0,0 +1,81 @@
+#pragma once
+// Minimaler Benchmark-Rahmen für env:native.
+//
+//   BENCH(mapSplit) {
+//       while (state.keepRunning()) benchKeep(mapSplit(0.5));
+//   }
+//
+// Jeder Fall wird mit wachsender Iterationszahl wiederholt, bis eine Messung
+// mindestens BENCH_MIN_TIME_MS dauert; ausgegeben wird die Zeit pro Iteration.
+
+#include <stdint.h>
+
+#ifndef BENCH_MIN_TIME_MS
+#define BENCH_MIN_TIME_MS 200
+#endif
+
+class BenchState {
+public:
+    explicit BenchState(uint64_t iterations) : remaining_(iterations), iterations_(iterations) {}
+
+    /** true, solange noch Iterationen ausstehen; startet die Uhr beim ersten Aufruf. */
+    bool keepRunning() {
+        if (!started_) start();
+        if (remaining_ > 0) {
+            remaining_--;
+            return true;
+        }
+        stop();
+        return false;
+    }
+
+    /** Hält die Uhr an, z. B. um Vorbereitungen innerhalb der Schleife auszuklammern. */
+    void pauseTiming();
+    void resumeTiming();
+
+    /** Hängt eine zusätzliche Kennzahl an die Ausgabezeile an (letzter Lauf gewinnt). */
+    void counter(const char* name, double value);
+
+    uint64_t iterations() const { return iterations_; }
+    int64_t elapsedNs() const { return elapsedNs_; }
+
+    static const int MAX_COUNTERS = 6;
+    struct Counter { const char* name; double value; };
+    int counterCount() const { return counterCount_; }
+    const Counter& counterAt(int i) const { return counters_[i]; }
+
+private:
+    uint64_t remaining_;
+    uint64_t iterations_;
+    bool started_ = false;
+    bool running_ = false;
+    int64_t startNs_ = 0;
+    int64_t elapsedNs_ = 0;
+    Counter counters_[MAX_COUNTERS];
+    int counterCount_ = 0;
+
+    void start();
+    void stop();
+};
+
+typedef void (*BenchFunction)(BenchState&);
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* name, BenchFunction fn);
+};
+
+#define BENCH(name) \
+    static void bench_##name(BenchState& state); \
+    static BenchRegistrar benchRegistrar_##name(#name, bench_##name); \
+    static void bench_##name(BenchState& state)
+
+/** Verhindert, dass der Compiler ein Ergebnis wegoptimiert. */
+template <typename T>
+inline void benchKeep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/** Verhindert, dass der Compiler Speicherzugriffe über diese Stelle hinweg umordnet. */
+inline void benchClobber() {
+    asm volatile("" : : : "memory");
+}
@@ -0,0 +1,154 @@
+#include <atomic>
+
+#include "Bench.h"
+#include "BinaryLink.h"
+#include "NativeHal.h"
+#include "SerialCommandTask.h"
+
+namespace {
+
+// Vier Sollwerte in einem Rahmen, wie ein Prüfstand sie mit 1 kHz schickt
+size_t setpointFrame(uint8_t seq, float rpm, uint8_t* out, size_t cap) {
+    uint8_t p[4 * 6];
+    for (int i = 0; i < 4; i++) {
+        p[i * 6] = (uint8_t)(i + 1);
+        p[i * 6 + 1] = (uint8_t)VescCommand::SET_RPM;
+        binaryPutFloat(p + i * 6 + 2, rpm + i);
+    }
+    return encodeBinaryFrame(MSG_SETPOINTS, seq, p, sizeof(p), out, cap);
+}
+
+// Befehlsschnittstelle wie in main.cpp, einmal für alle Fälle dieser Datei
+SerialCommands& commands() {
+    static char buffer[96];
+    static SerialCommands cmds(&Serial, buffer, sizeof(buffer), "\r\n", " ");
+    static SerialCommandTask task(Serial, cmds);
+    static bool started = [] {
+        task.begin();
+        return true;
+    }();
+    (void)started;
+    return cmds;
+}
+
+// PC-Seite: liest die Ausgabe von Serial mit
+struct HostSide {
+    FrameDecoder decoder;
+    std::atomic<uint32_t> pongs{0};
+    std::atomic<uint32_t> telemetry{0};
+    std::atomic<uint32_t> lastTelemetryUs{0};
+    std::atomic<uint32_t> telemetryGapMaxUs{0};
+
+    void tap(const uint8_t* data, size_t len) {
+        for (size_t i = 0; i < len; i++) {
+            if (decoder.push(data[i]) != FrameDecoder::FRAME) continue;
+            if (decoder.type() == MSG_PONG) pongs.fetch_add(1, std::memory_order_release);
+            if (decoder.type() == MSG_TELEMETRY) {
+                uint32_t now = (uint32_t)nativehal::nowUs();
+                uint32_t last = lastTelemetryUs.exchange(now);
+                if (last && now - last > telemetryGapMaxUs.load()) telemetryGapMaxUs.store(now - last);
+                telemetry.fetch_add(1, std::memory_order_release);
+            }
+        }
+    }
+};
+
+}  // namespace
+
+BENCH(BinaryFrame_encodeSetpoints4) {
+    uint8_t out[BINARY_MAX_ENCODED];
+    float rpm = 0;
+    while (state.keepRunning()) {
+        benchKeep(setpointFrame(0, rpm, out, sizeof(out)));
+        rpm += 1.0f;
+    }
+    state.counter("bytes", setpointFrame(0, 1234.0f, out, sizeof(out)));
+}
+
+BENCH(BinaryFrame_decodeSetpoints4) {
+    uint8_t frame[BINARY_MAX_ENCODED];
+    size_t n = setpointFrame(7, 1234.0f, frame, sizeof(frame));
+    FrameDecoder dec;
+    uint32_t frames = 0;
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < n; i++) {
+            if (dec.push(frame[i]) == FrameDecoder::FRAME) frames++;
+        }
+    }
+    benchKeep(frames);
+    state.counter("crc_errors", dec.crcErrors());
+}
+
+// PC -> Befehls-Task -> Sende-Task -> PC, über die Serial-Attrappe
+BENCH(BinaryLink_pingRoundTrip) {
+    Joystick js(GPIO_NUM_10);
+    VescCan vesc(GPIO_NUM_14, GPIO_NUM_13, 500000);
+    BinaryLink link(Serial, js, vesc);
+    HostSide host;
+    link.attach(commands());
+    link.begin();
+    nativehal::serialTap([&host](const uint8_t* d, size_t n) { host.tap(d, n); });
+
+    uint8_t frame[BINARY_MAX_ENCODED];
+    const uint8_t payload[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint8_t seq = 0;
+    while (state.keepRunning()) {
+        uint32_t before = host.pongs.load(std::memory_order_acquire);
+        size_t n = encodeBinaryFrame(MSG_PING, seq++, payload, sizeof(payload), frame, sizeof(frame));
+        nativehal::serialFeed((const char*)frame, n);
+        while (host.pongs.load(std::memory_order_acquire) == before) {
+        }
+    }
+
+    nativehal::serialTap(nullptr);
+    link.detach(commands());
+    state.counter("crc_errors", host.decoder.crcErrors());
+}
+
+// Sollwerte für 4 Controller Rahmen für Rahmen, bis jeder übernommen ist; daneben
+// Telemetrie mit 1 kHz. ns/iter ist die Zeit bis zur Übernahme eines Rahmens.
+BENCH(BinaryLink_setpointStream) {
+    Joystick js(GPIO_NUM_10);
+    VescCan vesc(GPIO_NUM_14, GPIO_NUM_13, 500000);
+    for (uint8_t id = 1; id <= 4; id++) vesc.addController(id, 0);
+    vesc.begin();
+    BinaryLink link(Serial, js, vesc);
+    HostSide host;
+    link.attach(commands());
+    link.begin();
+    nativehal::serialTap([&host](const uint8_t* d, size_t n) { host.tap(d, n); });
+
+    uint8_t frame[BINARY_MAX_ENCODED];
+    const uint8_t stream[] = {0xE8, 0x03, 1, 2, 3, 4};     // 1000 Hz, Controller 1..4
+    size_t n = encodeBinaryFrame(MSG_STREAM, 0, stream, sizeof(stream), frame, sizeof(frame));
+    nativehal::serialFeed((const char*)frame, n);
+
+    int64_t startUs = nativehal::nowUs();
+    uint32_t telemetryStart = host.telemetry.load();
+    uint8_t seq = 0;
+    float rpm = 0;
+    while (state.keepRunning()) {
+        uint32_t before = link.stats().setpoints;
+        n = setpointFrame(seq++, rpm, frame, sizeof(frame));
+        rpm += 1.0f;
+        nativehal::serialFeed((const char*)frame, n);
+        while (link.stats().setpoints - before < 4) {
+        }
+    }
+    // Telemetrierate über mindestens 200 ms
+    while (nativehal::nowUs() - startUs < 200000) delay(1);
+    double seconds = (nativehal::nowUs() - startUs) / 1e6;
+
+    nativehal::serialTap(nullptr);
+    link.detach(commands());
+
+    VescCommand cmd;
+    int32_t last = 0;
+    vesc.getSetpoint(4, cmd, last);
+    BinaryLink::Stats st = link.stats();
+    state.counter("telemetry_hz", (host.telemetry.load() - telemetryStart) / seconds);
+    state.counter("telemetry_gap_max_us", host.telemetryGapMaxUs.load());
+    state.counter("last_rpm_ok", last == (int32_t)(rpm - 1.0f + 3));
+    state.counter("rejected", st.rejected);
+    state.counter("crc_errors", st.crcErrors);
+}
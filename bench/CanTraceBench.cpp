@@ -0,0 +1,121 @@
+#include <LittleFS.h>
+
+#include "Bench.h"
+#include "CanTrace.h"
+#include "NativeHal.h"
+#include "VescCan.h"
+
+namespace {
+
+twai_message_t rpmMessage(uint8_t id, int32_t rpm) {
+    twai_message_t msg = {};
+    msg.extd = 1;
+    msg.identifier = ((uint32_t)VescCommand::SET_RPM << 8) | id;
+    msg.data_length_code = 4;
+    vescPutInt32BE(msg.data, rpm);
+    return msg;
+}
+
+void freshTraceFiles() {
+    LittleFS.begin(true);
+    LittleFS.remove(CanTrace::FILE_PATH);
+    LittleFS.remove(CanTrace::OLD_FILE_PATH);
+}
+
+}  // namespace
+
+// Was der CAN-Sendetask je Frame zusätzlich bezahlt. Die Ringe werden außerhalb der
+// Messung geleert, bevor sie voll sind.
+BENCH(CanTrace_recordTx) {
+    freshTraceFiles();
+    CanTrace trace(LittleFS);
+    trace.begin();
+    twai_message_t msg = rpmMessage(1, 0);
+    uint32_t recorded = 0;
+    while (state.keepRunning()) {
+        trace.recordTx(msg, ESP_OK);
+        msg.data[3]++;
+        if (++recorded % (CanTrace::RING_SIZE / 2 - 1) == 0) {
+            state.pauseTiming();
+            trace.requestFlush();
+            while (trace.stats().frames + trace.stats().lost < recorded) delay(1);
+            state.resumeTiming();
+        }
+    }
+    state.counter("lost", trace.stats().lost);
+}
+
+BENCH(CanTrace_recordTxDisabled) {
+    CanTrace trace(LittleFS);
+    trace.setEnabled(false);
+    twai_message_t msg = rpmMessage(1, 0);
+    while (state.keepRunning()) {
+        trace.recordTx(msg, ESP_OK);
+        benchClobber();
+    }
+}
+
+// Dateigröße je Frame: SET_RPM vom Gerät, STATUS_1 vom Controller
+BENCH(CanTrace_encodeEntry) {
+    CanTraceEntry e = {};
+    e.id = (3u << 8) | 1;
+    e.flags = CAN_TRACE_TX | CAN_TRACE_EXT | 4;
+    CanTraceEntry status = {};
+    status.id = (9u << 8) | 1;
+    status.flags = CAN_TRACE_EXT | 8;
+    uint8_t out[24];
+    size_t bytes = 0;
+    while (state.keepRunning()) {
+        bytes = CanTrace::encodeEntry(e, 1000, out);
+        benchClobber();
+        e.data[3]++;
+    }
+    benchKeep(bytes);
+    state.counter("bytes_rpm", bytes);
+    state.counter("bytes_status", CanTrace::encodeEntry(status, 300, out));
+}
+
+// 4 Controller eine Sekunde lang: Heartbeat alle 10 ms, je Controller 3 STATUS-Frames
+// alle 20 ms zurück. Alles muss in der Datei landen, in ganzen Seiten bis auf die letzte.
+BENCH(CanTrace_busToFile) {
+    freshTraceFiles();
+    CanTrace trace(LittleFS);
+    VescCan vesc(GPIO_NUM_14, GPIO_NUM_13, 500000);
+    vesc.setCanTrace(&trace);
+    for (uint8_t id = 1; id <= 4; id++) {
+        vesc.addController(id, 10);
+        vesc.setRpm(id, 1000 * id);
+    }
+    vesc.begin();
+    trace.begin();
+    vesc.startHeartbeatTask();
+
+    twai_message_t status = {};
+    status.extd = 1;
+    status.data_length_code = 8;
+    while (state.keepRunning()) {
+        int64_t start = nativehal::nowUs();
+        while (nativehal::nowUs() - start < 1000000) {
+            for (uint8_t id = 1; id <= 4; id++) {
+                for (uint32_t pkt : {9u, 14u, 16u}) {
+                    status.identifier = (pkt << 8) | id;
+                    status.data[7]++;
+                    nativehal::twaiInjectRx(status);
+                }
+            }
+            delay(20);
+        }
+    }
+    vesc.stopHeartbeatTask();
+    delay(50);
+    trace.requestFlush();
+    delay(50);
+
+    CanTrace::Stats st = trace.stats();
+    state.counter("frames", st.frames);
+    state.counter("bytes_per_frame", st.frames ? (double)(st.bytes - 4) / st.frames : 0);
+    state.counter("write_amp", st.writeAmplification);
+    state.counter("partial_pages", st.partialPages);
+    state.counter("lost", st.lost);
+    state.counter("bus_frames", vesc.txStats().sent + vesc.rxFrames());
+}
@@ -0,0 +1,84 @@
+#include <math.h>
+
+#include <Preferences.h>
+
+#include "Bench.h"
+#include "ControlLoop.h"
+#include "NativeHal.h"
+#include "ThrottleCurve.h"
+
+namespace {
+
+const int JOYSTICK_PIN = GPIO_NUM_10;
+
+// Ein laufender, kalibrierter Joystick für alle Fälle; sein Task läuft bis Programmende.
+Joystick& joystick() {
+    static Joystick* js = [] {
+        Preferences prefs;
+        prefs.begin("joystick", false);
+        // 0 V, 1 V, 3 V bei 3,3 V Referenz, in ADC-Einheiten (Zählwert × 16), als Schlüssel
+        // von vor dem Blob, die begin() übernimmt
+        prefs.clear();
+        prefs.putInt("min_raw", 0);
+        prefs.putInt("center_raw", 19855);
+        prefs.putInt("max_raw", 59564);
+        prefs.end();
+        // langsame Sinusbewegung über den ganzen Weg
+        nativehal::setAnalogSource(JOYSTICK_PIN, [] {
+            return (int)(2048 + 2000 * sin(nativehal::nowUs() * 1e-6 * 2 * M_PI * 0.5));
+        });
+        Joystick* j = new Joystick(JOYSTICK_PIN);
+        j->begin();
+        return j;
+    }();
+    return *js;
+}
+
+int32_t joystickToRpm(q15_t value) {
+    static ThrottleCurve curve;
+    return curve.map(value);
+}
+
+}  // namespace
+
+// Messung im Joystick-Task bis twai_transmit fertig, eine Sekunde lang.
+BENCH(ControlLoop_stickToBus) {
+    Joystick& js = joystick();
+    VescCan vesc(GPIO_NUM_14, GPIO_NUM_13, 500000);
+    vesc.addController(1, 0);
+    vesc.begin();
+    ControlLoop control(js, vesc, 1, joystickToRpm);
+    control.begin(100);
+
+    while (state.keepRunning()) {
+        delay(1000);
+    }
+
+    LatencyHistogram::Summary total = vesc.txTrace(VescCan::TX_TOTAL).summary();
+    state.counter("frames", total.count);
+    state.counter("wake_p50_us", control.trace(ControlLoop::STAGE_WAKE).summary().p50);
+    state.counter("queue_p50_us", vesc.txTrace(VescCan::TX_QUEUE).summary().p50);
+    state.counter("total_p50_us", total.p50);
+    state.counter("total_p99_us", total.p99);
+    state.counter("total_max_us", total.max);
+}
+
+// Kosten einer verfolgten Stufe: Zeitstempel nehmen und ins Histogramm eintragen.
+BENCH(LatencyTrace_stage) {
+    LatencyHistogram hist;
+    uint32_t last = (uint32_t)esp_timer_get_time();
+    while (state.keepRunning()) {
+        uint32_t now = (uint32_t)esp_timer_get_time();
+        hist.record(now - last);
+        last = now;
+    }
+    benchKeep(hist);
+}
+
+BENCH(LatencyHistogram_summary) {
+    LatencyHistogram hist;
+    for (uint32_t i = 0; i < 10000; i++) hist.record(i * 7 % 5000);
+    while (state.keepRunning()) {
+        benchKeep(hist.summary());
+    }
+}
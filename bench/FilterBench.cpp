@@ -0,0 +1,172 @@
+#include <math.h>
+#include <algorithm>
+
+#include "AdcSampler.h"
+#include "Bench.h"
+#include "AxisFilterBank.h"
+
+namespace {
+
+// Eine Achse, wie im Joystick
+class OneAxis {
+public:
+    explicit OneAxis(const FilterConfig& config) : bank(config) {}
+    int32_t process(int32_t x) {
+        uint16_t in = (uint16_t)x, out;
+        bank.process(&in, &out);
+        return out;
+    }
+
+private:
+    AxisFilterBank<1> bank;
+};
+
+// Verrauschte Messreihe mit gelegentlichen Ausreißern in ADC-Einheiten (Zählwert × 16,
+// 3,3 V Referenz), einmal vorberechnet.
+const int SIGNAL_LEN = 1024;
+
+const int32_t* noisySignal() {
+    static int32_t signal[SIGNAL_LEN];
+    static bool ready = false;
+    if (!ready) {
+        uint32_t seed = 12345;
+        for (int i = 0; i < SIGNAL_LEN; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            float noise = ((seed >> 8) & 0xFFFF) / 65536.0f - 0.5f;
+            float volts = 1.65f + 0.8f * sinf(i * 0.01f) + 0.02f * noise;
+            if (i % 97 == 0) volts += 1.0f;
+            signal[i] = std::min((int32_t)lrintf(volts / 3.3f * ADC_FULL_SCALE), (int32_t)ADC_FULL_SCALE);
+        }
+        ready = true;
+    }
+    return signal;
+}
+
+// Messungen, bis der Ausgang nach einem Sprung über den ganzen Bereich die Hälfte
+// erreicht; vorher eingeschwungen, damit der Kalman-Filter seine Dauerverstärkung hat.
+int stepDelay(const FilterConfig& config) {
+    OneAxis chain(config);
+    for (int n = 0; n < 1000; n++) chain.process(0);
+    for (int n = 0; n < 10000; n++) {
+        if (chain.process(ADC_FULL_SCALE) >= ADC_FULL_SCALE / 2) return n;
+    }
+    return -1;
+}
+
+// Die frühere Kette in double, als Maßstab für die Ganzzahl-Rechnung
+class ReferenceChain {
+public:
+    explicit ReferenceChain(const FilterConfig& cfg) : cfg(cfg) {}
+
+    double process(double x) {
+        if (!primed) {
+            for (int i = 0; i < cfg.median; i++) med[i] = x;
+            for (int i = 0; i < cfg.average; i++) avg[i] = x;
+            iir = kalmanX = x;
+            kalmanP = cfg.kalmanR;
+            primed = true;
+        }
+        if (cfg.median > 1) {
+            med[medIndex] = x;
+            medIndex = (medIndex + 1) % cfg.median;
+            double sorted[FilterChain::MAX_MEDIAN];
+            for (int i = 0; i < cfg.median; i++) {
+                int k = i;
+                for (; k > 0 && sorted[k - 1] > med[i]; k--) sorted[k] = sorted[k - 1];
+                sorted[k] = med[i];
+            }
+            x = sorted[cfg.median / 2];
+        }
+        if (cfg.average > 1) {
+            avg[avgIndex] = x;
+            avgIndex = (avgIndex + 1) % cfg.average;
+            double sum = 0;
+            for (int i = 0; i < cfg.average; i++) sum += avg[i];
+            x = sum / cfg.average;
+        }
+        if (cfg.iirAlpha < 1.0f) x = iir += cfg.iirAlpha * (x - iir);
+        if (cfg.kalmanR > 0.0f) {
+            kalmanP += cfg.kalmanQ;
+            double k = kalmanP / (kalmanP + cfg.kalmanR);
+            x = kalmanX += k * (x - kalmanX);
+            kalmanP *= 1.0 - k;
+        }
+        return x;
+    }
+
+private:
+    FilterConfig cfg;
+    bool primed = false;
+    double med[FilterChain::MAX_MEDIAN], avg[FilterChain::MAX_AVERAGE];
+    int medIndex = 0, avgIndex = 0;
+    double iir = 0, kalmanX = 0, kalmanP = 0;
+};
+
+// Größte Abweichung vom Maßstab über die Messreihe, in ADC-Einheiten (1/16 Zählwert)
+double maxReferenceError(const FilterConfig& config) {
+    OneAxis chain(config);
+    ReferenceChain ref(config);
+    const int32_t* signal = noisySignal();
+    double worst = 0;
+    for (int i = 0; i < 4 * SIGNAL_LEN; i++) {
+        int32_t x = signal[i & (SIGNAL_LEN - 1)];
+        worst = std::max(worst, fabs(chain.process(x) - ref.process(x)));
+    }
+    return worst;
+}
+
+void runFilter(BenchState& state, const FilterConfig& config) {
+    OneAxis chain(config);
+    const int32_t* signal = noisySignal();
+    int i = 0;
+    while (state.keepRunning()) {
+        benchKeep(chain.process(signal[i]));
+        i = (i + 1) & (SIGNAL_LEN - 1);
+    }
+    state.counter("delay_samples", FilterChain::groupDelay(config));
+    state.counter("step50_samples", stepDelay(config));
+    state.counter("max_err_lsb", maxReferenceError(config));
+}
+
+FilterConfig makeConfig(uint8_t median, uint8_t average, float alpha, float q = 0, float r = 0) {
+    FilterConfig cfg;
+    cfg.median = median;
+    cfg.average = average;
+    cfg.iirAlpha = alpha;
+    cfg.kalmanQ = q;
+    cfg.kalmanR = r;
+    return cfg;
+}
+
+}  // namespace
+
+// Bisheriges Verhalten: Mittelwert über 32 Messungen, jetzt mit laufender Summe.
+BENCH(Filter_average32) { runFilter(state, makeConfig(1, 32, 1.0f)); }
+
+BENCH(Filter_average8) { runFilter(state, makeConfig(1, 8, 1.0f)); }
+
+BENCH(Filter_iir) { runFilter(state, makeConfig(1, 1, 0.1f)); }
+
+BENCH(Filter_median5) { runFilter(state, makeConfig(5, 1, 1.0f)); }
+
+BENCH(Filter_median5_iir) { runFilter(state, makeConfig(5, 1, 0.2f)); }
+
+BENCH(Filter_kalman) { runFilter(state, makeConfig(1, 1, 1.0f, 1e-5f, 4e-4f)); }
+
+BENCH(Filter_median9_average16_kalman) { runFilter(state, makeConfig(9, 16, 1.0f, 1e-5f, 4e-4f)); }
+
+// Zum Vergleich: die frühere Glättung, die bei jeder Messung alle 32 Werte neu aufaddiert.
+BENCH(Filter_resum32) {
+    float buffer[32] = {};
+    int index = 0;
+    const int32_t* signal = noisySignal();
+    int i = 0;
+    while (state.keepRunning()) {
+        buffer[index] = signal[i];
+        index = (index + 1) % 32;
+        float sum = 0;
+        for (int k = 0; k < 32; k++) sum += buffer[k];
+        benchKeep(sum / 32);
+        i = (i + 1) & (SIGNAL_LEN - 1);
+    }
+}
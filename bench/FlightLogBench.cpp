@@ -0,0 +1,84 @@
+#include <LittleFS.h>
+#include <math.h>
+
+#include "Bench.h"
+#include "FlightLog.h"
+#include "NativeHal.h"
+
+namespace {
+
+// Fahrt mit langsamem Sinus am Stick; Drehzahl folgt mit Verzögerung, Strom und Duty
+// rauschen in der letzten Stelle wie echte STATUS-Werte
+bool sampleCruise(FlightLogRecord& rec) {
+    static uint32_t noise = 1;
+    noise = noise * 1103515245u + 12345u;
+    double t = nativehal::nowUs() * 1e-6;
+    double stick = sin(t * 2 * M_PI * 0.05);
+    rec.stick = (int16_t)(stick * 32767);
+    rec.rpm = (int32_t)(stick * 4000);
+    rec.erpm = (int32_t)(sin((t - 0.3) * 2 * M_PI * 0.05) * 4000) + (int32_t)(noise >> 29) - 4;
+    rec.current = (int16_t)(fabs(stick) * 300) + (int16_t)((noise >> 20) & 3);
+    rec.duty = (int16_t)(stick * 660);
+    rec.vin = 240 - (int16_t)((noise >> 24) & 1);
+    rec.flags = FLIGHT_LOG_CALIBRATED | FLIGHT_LOG_SETPOINT | FLIGHT_LOG_STATUS;
+    return true;
+}
+
+void freshLogFiles() {
+    LittleFS.begin(true);
+    LittleFS.remove(FlightLog::FILE_PATH);
+    LittleFS.remove(FlightLog::OLD_FILE_PATH);
+}
+
+}  // namespace
+
+// Kosten je Takt im Abtasttask, ohne Dateisystem
+BENCH(FlightLog_encodeRecord) {
+    FlightLogRecord prev, rec;
+    memset(&prev, 0, sizeof(prev));
+    sampleCruise(prev);
+    rec = prev;
+    uint8_t out[FlightLog::MAX_RECORD_BYTES];
+    size_t bytes = 0;
+    while (state.keepRunning()) {
+        rec.erpm += 3;
+        rec.current ^= 1;
+        bytes = FlightLog::encodeRecord(rec, prev, 10000, out);
+        benchClobber();
+    }
+    benchKeep(bytes);
+    state.counter("bytes_cruise", bytes);
+    state.counter("bytes_idle", FlightLog::encodeRecord(prev, prev, 10000, out));
+    FlightLogRecord zero;
+    memset(&zero, 0, sizeof(zero));
+    state.counter("bytes_first", FlightLog::encodeRecord(prev, zero, 0, out));
+}
+
+// Zehn Minuten mit 100 Hz in virtueller Zeit: Rate, Kompression und Schreibverstärkung.
+// Eine Seite enthält gut 10 s; das Schreiben nach LittleFS ist echte Datei-E/A des Hosts.
+BENCH(FlightLog_tenMinutes100Hz) {
+    FlightLog::Stats st = {};
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        freshLogFiles();
+        nativehal::virtualTime(true);
+        {
+            FlightLog log(LittleFS, sampleCruise);
+            log.begin(100);
+            state.resumeTiming();
+            delay(600000);
+            log.requestFlush();
+            delay(100);
+            state.pauseTiming();
+            st = log.stats();
+        }
+        nativehal::virtualTime(false);
+        state.resumeTiming();
+    }
+    state.counter("records_per_s", st.recordsPerSec);
+    state.counter("bytes_per_record", st.records ? (double)st.recordBytes / st.records : 0);
+    state.counter("compression", st.compression);
+    state.counter("write_amp", st.writeAmplification);
+    state.counter("file_writes", st.pages);
+    state.counter("lost", st.lost);
+}
@@ -0,0 +1,90 @@
+#include <math.h>
+
+#include "Bench.h"
+#include "Joystick.h"
+#include "JoystickAxes.h"
+
+namespace {
+
+const int PINS[ADC_MAX_CHANNELS] = {GPIO_NUM_10, GPIO_NUM_11, GPIO_NUM_12, GPIO_NUM_13};
+
+// je Achse eine andere Kette, Achse 0 mit allen Stufen, damit jeder Zweig der Bank mitläuft
+FilterConfig axisChain(int axis) {
+    static const uint8_t median[ADC_MAX_CHANNELS] = {5, 3, 9, 1};
+    static const uint8_t average[ADC_MAX_CHANNELS] = {16, 32, 8, 64};
+    static const float alpha[ADC_MAX_CHANNELS] = {0.3f, 1.0f, 0.5f, 0.2f};
+    static const float r[ADC_MAX_CHANNELS] = {1.0f, 0.0f, 0.5f, 2.0f};
+    FilterConfig cfg;
+    cfg.median = median[axis];
+    cfg.average = average[axis];
+    cfg.iirAlpha = alpha[axis];
+    cfg.kalmanQ = 0.01f;
+    cfg.kalmanR = r[axis];
+    return cfg;
+}
+
+// Verrauschter Sinus je Achse mit eigener Phase, gelegentliche Ausreißer
+uint16_t axisSample(int axis, int i, uint32_t& seed) {
+    seed = seed * 1664525u + 1013904223u;
+    float noise = ((seed >> 8) & 0xFFFF) / 65536.0f - 0.5f;
+    float volts = 1.65f + 1.2f * sinf(i * 0.01f + axis) + 0.03f * noise;
+    if ((i + axis) % 89 == 0) volts += 0.8f;
+    int32_t v = lrintf(volts / 3.3f * ADC_FULL_SCALE);
+    return (uint16_t)(v < 0 ? 0 : v > ADC_FULL_SCALE ? ADC_FULL_SCALE : v);
+}
+
+// Ein Durchgang für N Achsen; verglichen mit N einzelnen Joysticks mit je eigenen Tasks.
+// mismatch zählt Werte, in denen eine Achse der Bank von einer Bank mit nur dieser
+// Achse und ihrer Einstellung abweicht.
+template <int N>
+void axesBench(BenchState& state) {
+    int pins[N];
+    for (int a = 0; a < N; a++) pins[a] = PINS[a];
+    JoystickAxes<N> axes(pins);
+    AxisFilterBank<N> bank;
+    AxisFilterBank<1> single[N];
+    for (int a = 0; a < N; a++) {
+        axes.setFilter(a, axisChain(a));
+        bank.configure(a, axisChain(a));
+        single[a].configure(0, axisChain(a));
+    }
+    uint32_t seed = 4711;
+    int mismatch = 0;
+    for (int i = 0; i < 5000; i++) {
+        uint16_t in[N], out[N];
+        for (int a = 0; a < N; a++) in[a] = axisSample(a, i, seed);
+        bank.process(in, out);
+        for (int a = 0; a < N; a++) {
+            uint16_t alone;
+            single[a].process(&in[a], &alone);
+            if (alone != out[a]) mismatch++;
+        }
+    }
+
+    uint16_t raw[N];
+    for (int a = 0; a < N; a++) raw[a] = (uint16_t)(20000 + 1000 * a);
+    int64_t iterations = 0;
+    while (state.keepRunning()) {
+        axes.update(raw);
+        for (int a = 0; a < N; a++) raw[a] = raw[a] < 45000 ? raw[a] + 200 : 20000;
+        iterations++;
+    }
+    benchKeep(axes);
+
+    // RAM: Objekt plus Stacks von Abtast- und Kalibriertask, einmal für alle Achsen bzw. je Achse ein Joystick
+    uint32_t stacks = TASK_JOYSTICK.stackBytes + TASK_JOYSTICK_CAL.stackBytes;
+    double shared = sizeof(JoystickAxes<N>) + stacks;
+    double separate = sizeof(Joystick) + stacks;
+    state.counter("ns_per_axis", (double)state.elapsedNs() / iterations / N);
+    state.counter("bytes_per_axis", shared / N);
+    state.counter("joystick_bytes", separate);
+    state.counter("tasks_saved", 2 * (N - 1));
+    state.counter("mismatch", mismatch);
+}
+
+}  // namespace
+
+BENCH(JoystickAxes_update1) { axesBench<1>(state); }
+BENCH(JoystickAxes_update2) { axesBench<2>(state); }
+BENCH(JoystickAxes_update3) { axesBench<3>(state); }
+BENCH(JoystickAxes_update4) { axesBench<4>(state); }
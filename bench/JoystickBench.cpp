@@ -0,0 +1,168 @@
+#include <math.h>
+
+#include <Preferences.h>
+
+#include "Bench.h"
+#include "Joystick.h"
+#include "NativeHal.h"
+
+// Ein Durchlauf des Reader-Tasks ohne ADC-Zugriff und ohne vTaskDelay:
+// filtern, normieren, Schnappschuss veröffentlichen.
+BENCH(Joystick_update) {
+    Joystick js(GPIO_NUM_10);
+    uint16_t raw = 20000;
+    while (state.keepRunning()) {
+        js.update(raw);
+        raw = raw < 45000 ? raw + 200 : 20000;
+    }
+    benchKeep(js);
+}
+
+// Abbildung über den ganzen ADC-Bereich gegen eine Rechnung in double: Kalibrierung
+// bei 0,4 / 1,65 / 2,9 V, jeder ADC-Wert einmal. Die Mitte muss auf die Messung genau
+// gespeichert sein (früher auf ganze Volt abgeschnitten), die Abweichung höchstens
+// die Rundung des Q15-Werts.
+BENCH(Joystick_mapAccuracy) {
+    Joystick js(GPIO_NUM_10);
+    FilterConfig passthrough;
+    passthrough.average = 1;
+    js.setFilter(passthrough);
+
+    auto counts = [](float volts) { return (uint16_t)lrintf(volts / 3.3f * ADC_FULL_SCALE); };
+    js.update(counts(1.65f));
+    js.calibrateCenter();
+    js.update(counts(0.4f));
+    js.calibrateMin();
+    js.update(counts(2.9f));
+    js.calibrateMax();
+    JoystickCalibration cal = js.getCalibration();
+
+    double worst = 0;
+    uint32_t deadzone = 0;
+    while (state.keepRunning()) {
+        worst = 0;
+        deadzone = 0;
+        for (uint32_t raw = 0; raw <= ADC_FULL_SCALE; raw++) {
+            js.update((uint16_t)raw);
+            JoystickSnapshot s = js.getSnapshot();
+            double d = (double)raw - cal.center;
+            double ref = d / (d >= 0 ? cal.maxVal - cal.center : cal.center - cal.minVal);
+            ref = fmax(-1.0, fmin(1.0, ref));
+            if (fabs(ref) * Q15_ONE < q15FromFloat(0.05f)) {
+                ref = 0;
+                deadzone++;
+            }
+            worst = fmax(worst, fabs(s.value - ref * Q15_ONE));
+        }
+    }
+    js.resetCalibration();
+
+    state.counter("max_err_q15", worst);
+    state.counter("center_err_mv", (js.toVolts(cal.center) - 1.65f) * 1000);
+    state.counter("deadzone_pct", 100.0 * deadzone / (ADC_FULL_SCALE + 1));
+}
+
+// Lesen des Zustands, während niemand schreibt.
+BENCH(Joystick_snapshot) {
+    Joystick js(GPIO_NUM_10);
+    js.update(20000);
+    while (state.keepRunning()) {
+        benchKeep(js.getSnapshot());
+    }
+}
+
+namespace {
+
+// Stick mit Feder in virtueller Zeit, Spannung über der Zeit:
+//   0..10 s Ruhe bei 1,62 V; 10..22 s einmal ganz nach unten (0,25 V) und oben (3,05 V);
+//   danach fünf Minuten Ruhe mit gelegentlichen Ausschlägen, die Mitte wandert dabei
+//   um 40 mV (Erwärmung), jede Rückkehr landet bis 6 mV neben der Mitte.
+// Dazu Rauschen von etwa 4 mV Standardabweichung auf jeder Messung.
+const int AUTO_PIN = GPIO_NUM_12;
+const float REST_VOLTS = 1.62f;
+const float DRIFT_VOLTS = 0.04f;
+const float LOW_VOLTS = 0.25f;
+const float HIGH_VOLTS = 3.05f;
+const float RUN_S = 325.0f;
+
+float restVolts(float t) {
+    float drift = t > 22.0f ? DRIFT_VOLTS * (t - 22.0f) / (RUN_S - 22.0f) : 0.0f;
+    float offset = 0.006f * sinf(floorf(t / 30.0f) * 2.1f);    // Rückstellfehler je Ausschlag
+    return REST_VOLTS + drift + offset;
+}
+
+float stickVolts(float t) {
+    if (t >= 10.0f && t < 16.0f) return t < 12.0f ? REST_VOLTS + (LOW_VOLTS - REST_VOLTS) * (t - 10.0f) / 2 : LOW_VOLTS;
+    if (t >= 16.0f && t < 22.0f) return t < 18.0f ? LOW_VOLTS + (HIGH_VOLTS - LOW_VOLTS) * (t - 16.0f) / 2 : HIGH_VOLTS;
+    if (t >= 22.0f && fmodf(t, 30.0f) < 1.0f) return restVolts(t) + 0.7f;     // kurzer Ausschlag
+    return restVolts(t);
+}
+
+// Spielt das Profil ab start in virtueller Zeit auf AUTO_PIN ab; kehrt nach RUN_S zurück
+int64_t runStick(int64_t start) {
+    uint32_t seed = 99;
+    nativehal::setAnalogSource(AUTO_PIN, [start, seed]() mutable {
+        float noise = 0;
+        for (int i = 0; i < 4; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            noise += ((seed >> 8) & 0xFFFF) / 65536.0f - 0.5f;
+        }
+        float volts = stickVolts((nativehal::nowUs() - start) * 1e-6f) + 0.007f * noise;   // σ ≈ 4 mV
+        return (int)lrintf(volts / 3.3f * 4095.0f);
+    });
+    while (nativehal::nowUs() - start < (int64_t)(RUN_S * 1e6f)) delay(100);
+    return start;
+}
+
+}  // namespace
+
+// Selbstkalibrierung auf einer knapp daneben liegenden Kalibrierung von Hand: wie genau
+// Mitte und Endlagen am Ende liegen, welche Totzone das gemessene Rauschen ergibt und wie
+// oft dafür ins NVS geschrieben wurde. Fehler in mV gegen die wahren Werte der Vorgabe.
+// Danach zurückgesetzt und dasselbe Profil noch einmal: relearned muss 0 bleiben, ohne
+// Kalibrierung von Hand legt die Selbstkalibrierung keine an.
+BENCH(Joystick_autoCalibrate) {
+    double centerErr = 0, spanErr = 0, deadzonePct = 0, noiseMv = 0;
+    uint32_t saves = 0, relearned = 0;
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        Preferences prefs;
+        prefs.begin("joystick", false);
+        prefs.clear();
+        prefs.putInt("min_raw", lrintf((LOW_VOLTS + 0.1f) / 3.3f * ADC_FULL_SCALE));
+        prefs.putInt("center_raw", lrintf((REST_VOLTS - 0.03f) / 3.3f * ADC_FULL_SCALE));
+        prefs.putInt("max_raw", lrintf((HIGH_VOLTS - 0.1f) / 3.3f * ADC_FULL_SCALE));
+        prefs.end();
+        nativehal::virtualTime(true);
+        {
+            Joystick js(AUTO_PIN);
+            js.begin(Joystick::ADC_POLLING);
+            js.setAutoCalibration(true);
+            state.resumeTiming();
+            int64_t start = runStick(nativehal::nowUs());
+            state.pauseTiming();
+
+            float end = (nativehal::nowUs() - start) * 1e-6f;
+            JoystickCalibration cal = js.getCalibration();
+            centerErr = (js.toVolts(cal.center) - restVolts(end)) * 1000;
+            spanErr = fmax(fabs(js.toVolts(cal.minVal) - LOW_VOLTS), fabs(js.toVolts(cal.maxVal) - HIGH_VOLTS)) * 1000;
+            deadzonePct = 100.0 * js.getDeadzone() / Q15_ONE;
+            noiseMv = js.getAutoStatus().noise * 3.3 / ADC_FULL_SCALE * 1000;
+            saves = js.getAutoSaves();
+
+            js.resetCalibration();
+            runStick(nativehal::nowUs());
+            cal = js.getCalibration();
+            relearned = js.isCalibrated() || cal.minVal != -1 || cal.maxVal != -1 || cal.center != -1;
+            js.resetCalibration();
+        }
+        nativehal::virtualTime(false);
+        state.resumeTiming();
+    }
+    state.counter("center_err_mv", centerErr);
+    state.counter("span_err_mv", spanErr);
+    state.counter("deadzone_pct", deadzonePct);
+    state.counter("noise_mv", noiseMv);
+    state.counter("saves", saves);
+    state.counter("relearned", relearned);
+}
@@ -0,0 +1,107 @@
+#include <math.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <thread>
+
+#include "Bench.h"
+#include "RpmMapping.h"
+#include "ThrottleCurve.h"
+
+BENCH(mapSplit) {
+    double x = -1.0;
+    while (state.keepRunning()) {
+        benchKeep(mapSplit(x));
+        x = x < 1.0 ? x + 0.001 : -1.0;
+    }
+}
+
+// Standardkennlinie entspricht mapSplit; Abweichung über alle Q15-Werte
+BENCH(ThrottleCurve_map) {
+    ThrottleCurve curve;
+    q15_t x = -Q15_ONE;
+    while (state.keepRunning()) {
+        benchKeep(curve.map(x));
+        x = x < Q15_ONE - 32 ? x + 33 : -Q15_ONE;
+    }
+
+    int32_t maxErr = 0;
+    for (int32_t q = -Q15_ONE; q <= Q15_ONE; q++) {
+        int32_t ref = (int32_t)lround(mapSplit(q15ToFloat(q)));
+        int32_t err = abs(curve.map(q) - ref);
+        if (err > maxErr) maxErr = err;
+    }
+    state.counter("max_err_rpm", maxErr);
+}
+
+// Expo mit Totband und unterschiedlichen Richtungen; Abweichung zur Float-Rechnung
+BENCH(ThrottleCurve_mapExpo) {
+    CurveConfig cfg;
+    cfg.forward.deadband = 0.05f;
+    cfg.forward.expo = 0.6f;
+    cfg.reverse.deadband = 0.08f;
+    cfg.reverse.minRpm = 800;
+    cfg.reverse.maxRpm = 2500;
+    cfg.reverse.points = 2;
+    cfg.reverse.point[0] = {0.5f, 0.25f};
+    cfg.reverse.point[1] = {0.8f, 0.6f};
+    ThrottleCurve curve(cfg);
+
+    q15_t x = -Q15_ONE;
+    while (state.keepRunning()) {
+        benchKeep(curve.map(x));
+        x = x < Q15_ONE - 32 ? x + 33 : -Q15_ONE;
+    }
+
+    float maxErr = 0;
+    for (int32_t q = -Q15_ONE; q <= Q15_ONE; q++) {
+        float err = fabsf(curve.map(q) - ThrottleCurve::evaluate(cfg, q15ToFloat(q)));
+        if (err > maxErr) maxErr = err;
+    }
+    state.counter("max_err_rpm", maxErr);
+}
+
+BENCH(ThrottleCurve_evaluateFloat) {
+    CurveConfig cfg;
+    cfg.forward.expo = cfg.reverse.expo = 0.6f;
+    float x = -1.0f;
+    while (state.keepRunning()) {
+        benchKeep(ThrottleCurve::evaluate(cfg, x));
+        x = x < 1.0f ? x + 0.001f : -1.0f;
+    }
+}
+
+// Umschalten im Dauerlauf: jedes Ergebnis muss vollständig aus einer der beiden
+// Kennlinien stammen, nie aus einer halb geschriebenen Tabelle
+BENCH(ThrottleCurve_switchStress) {
+    CurveConfig a;
+    CurveConfig b;
+    b.forward.minRpm = b.reverse.minRpm = 2000;
+    b.forward.maxRpm = b.reverse.maxRpm = 6000;
+    b.forward.expo = b.reverse.expo = 1.0f;
+    ThrottleCurve refA(a), refB(b), curve(a);
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint32_t> switches{0};
+    std::thread writer([&] {
+        bool useB = false;
+        while (!stop.load(std::memory_order_relaxed)) {
+            useB = !useB;
+            curve.setCurve(useB ? b : a);
+            switches.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    uint32_t torn = 0;
+    q15_t x = -Q15_ONE;
+    while (state.keepRunning()) {
+        int32_t rpm = curve.map(x);
+        if (rpm != refA.map(x) && rpm != refB.map(x)) torn++;
+        x = x < Q15_ONE - 32 ? x + 33 : -Q15_ONE;
+    }
+
+    stop = true;
+    writer.join();
+    state.counter("torn", torn);
+    state.counter("switches", switches.load());
+}
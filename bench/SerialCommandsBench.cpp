@@ -0,0 +1,143 @@
+#include <stdio.h>
+
+#include <atomic>
+
+#include "Bench.h"
+#include "NativeHal.h"
+#include "SerialCommandTask.h"
+#include "SerialCommands.h"
+
+namespace {
+
+// Liefert eine Zeile pro load(), damit ReadSerial() nach jeder Zeile zurückkehrt.
+class LineStream : public Stream {
+public:
+    void load(const char* line) { line_ = line; pos_ = 0; }
+    int available() override { return line_[pos_] ? 1 : 0; }
+    int read() override { return line_[pos_] ? line_[pos_++] : -1; }
+    int peek() override { return line_[pos_] ? line_[pos_] : -1; }
+    size_t write(uint8_t) override { return 1; }
+
+private:
+    const char* line_ = "";
+    size_t pos_ = 0;
+};
+
+int32_t lastRpm = 0;
+
+void cmd_rpm(SerialCommands* sender) {
+    char* arg = sender->Next();
+    if (arg) lastRpm = atoi(arg);
+}
+
+void cmd_noop(SerialCommands*) {}
+
+float lastGain = 0;
+
+void cmd_gain(SerialCommands* sender) {
+    long channel;
+    float gain;
+    if (sender->NextInt(channel) && sender->NextFloat(gain)) lastGain = gain * channel;
+}
+
+std::atomic<uint32_t> handled{0};
+
+void cmd_count(SerialCommands*) {
+    handled.fetch_add(1, std::memory_order_release);
+}
+
+void cmd_unrecognized(SerialCommands*, const char*) {}
+
+}  // namespace
+
+// Zeile "rpm 1234" wie in main.cpp, mit dem Befehl am Ende einer Liste von 8 Einträgen.
+BENCH(SerialCommands_ReadSerial) {
+    static SerialCommand filler[] = {
+        SerialCommand("duty", cmd_noop), SerialCommand("current", cmd_noop),
+        SerialCommand("brake", cmd_noop), SerialCommand("hb", cmd_noop),
+        SerialCommand("stat", cmd_noop), SerialCommand("cal", cmd_noop),
+        SerialCommand("reset", cmd_noop),
+    };
+    static SerialCommand rpm("rpm", cmd_rpm);
+
+    LineStream stream;
+    char buffer[32];
+    SerialCommands commands(&stream, buffer, sizeof(buffer), "\r\n", " ");
+    commands.SetDefaultHandler(cmd_unrecognized);
+    for (auto& cmd : filler) commands.AddCommand(&cmd);
+    commands.AddCommand(&rpm);
+
+    while (state.keepRunning()) {
+        stream.load("rpm 1234\r\n");
+        commands.ReadSerial();
+    }
+    benchKeep(lastRpm);
+}
+
+// Dieselbe Zeile mit 60 registrierten Befehlen: die Hash-Tabelle hält die Zeit konstant.
+BENCH(SerialCommands_ReadSerial60) {
+    static char names[59][8];
+    static SerialCommand* filler[59];
+    for (int i = 0; i < 59; i++) {
+        snprintf(names[i], sizeof(names[i]), "cmd%02d", i);
+        filler[i] = new SerialCommand(names[i], cmd_noop);
+    }
+    static SerialCommand rpm("rpm", cmd_rpm);
+
+    LineStream stream;
+    char buffer[32];
+    SerialCommands commands(&stream, buffer, sizeof(buffer), "\r\n", " ");
+    commands.SetDefaultHandler(cmd_unrecognized);
+    for (SerialCommand* cmd : filler) commands.AddCommand(cmd);
+    commands.AddCommand(&rpm);
+
+    while (state.keepRunning()) {
+        stream.load("rpm 1234\r\n");
+        commands.ReadSerial();
+    }
+    benchKeep(lastRpm);
+    for (SerialCommand* cmd : filler) delete cmd;
+}
+
+// Typisierte Argumente: Ganzzahl und Kommazahl werden beim Zerlegen einmal umgewandelt.
+BENCH(SerialCommands_typedArgs) {
+    static SerialCommand gain("gain", cmd_gain);
+
+    LineStream stream;
+    char buffer[32];
+    SerialCommands commands(&stream, buffer, sizeof(buffer), "\r\n", " ");
+    commands.AddCommand(&gain);
+
+    while (state.keepRunning()) {
+        stream.load("gain 3 0.125\r\n");
+        commands.ReadSerial();
+    }
+    state.counter("gain", lastGain);
+}
+
+// Zeile empfangen -> Handler im Befehls-Task gelaufen. Der Task schläft zwischen den
+// Zeilen; wakeups_per_line zeigt, dass er nur bei Eingang geweckt wird.
+BENCH(SerialCommandTask_lineToHandler) {
+    static char buffer[96];
+    static SerialCommands commands(&Serial, buffer, sizeof(buffer), "\r\n", " ");
+    static SerialCommand count("count", cmd_count);
+    static SerialCommandTask task(Serial, commands);
+    static bool started = [] {
+        commands.AddCommand(&count);
+        task.begin();
+        return true;
+    }();
+    (void)started;
+
+    uint32_t wakesBefore = task.wakeups();
+    uint64_t lines = 0;
+    while (state.keepRunning()) {
+        uint32_t before = handled.load(std::memory_order_acquire);
+        nativehal::serialFeed("count\r\n", 7);
+        while (handled.load(std::memory_order_acquire) == before) {
+        }
+        lines++;
+    }
+
+    state.counter("wakeups_per_line", (double)(task.wakeups() - wakesBefore) / lines);
+}
@@ -0,0 +1,68 @@
+#include <string.h>
+
+#include "Bench.h"
+#include "NativeHal.h"
+#include "TaskProfiler.h"
+
+namespace {
+
+// Rechnet BUSY_MS und schläft den Rest jeder Periode: etwa 30 % eines Kerns
+const uint32_t BUSY_MS = 3;
+const uint32_t PERIOD_MS = 10;
+
+void busyTask(void*) {
+    TickType_t wake = xTaskGetTickCount();
+    while (true) {
+        int64_t until = esp_timer_get_time() + BUSY_MS * 1000;
+        volatile uint32_t spin = 0;
+        while (esp_timer_get_time() < until) spin++;
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(PERIOD_MS));
+    }
+}
+
+void idleTask(void*) {
+    while (true) vTaskDelay(pdMS_TO_TICKS(10));
+}
+
+}  // namespace
+
+// Eine Auswertung im Profiler-Task bei etwa so vielen Tasks wie auf dem Gerät
+BENCH(TaskProfiler_sample) {
+    static const char* const names[] = {"t0", "t1", "t2", "t3", "t4", "t5", "t6", "t7", "t8", "t9",
+                                        "t10", "t11", "t12", "t13", "t14", "t15", "t16", "t17",
+                                        "t18", "t19", "t20", "t21", "t22", "t23"};
+    const int count = sizeof(names) / sizeof(names[0]);
+    TaskHandle_t handles[count];
+    for (int i = 0; i < count; i++) {
+        xTaskCreatePinnedToCore(idleTask, names[i], 2048, nullptr, i % 8, &handles[i], i % 2);
+    }
+    delay(20);
+    TaskProfiler profiler;
+    while (state.keepRunning()) profiler.sample();
+    state.counter("tasks", profiler.taskCount());
+    for (TaskHandle_t h : handles) vTaskDelete(h);
+}
+
+// Lastanzeige gegen einen Task mit bekanntem Tastverhältnis; dazu die Planungslatenz
+// der Fühler. Auf dem Host misst ulRunTimeCounter die CPU-Zeit des Threads.
+BENCH(TaskProfiler_busyTask) {
+    uint16_t busy = TaskProfiler::CPU_UNKNOWN;
+    LatencyHistogram::Summary lat = {};
+    while (state.keepRunning()) {
+        TaskProfiler profiler;
+        TaskHandle_t handle = nullptr;
+        xTaskCreatePinnedToCore(busyTask, "busy", 2048, nullptr, 2, &handle, 1);
+        profiler.begin();
+        delay(2 * TaskProfiler::INTERVAL_MS + 100);
+        for (int i = 0; i < profiler.taskCount(); i++) {
+            TaskLoad t = profiler.task(i);
+            if (strcmp(t.name, "busy") == 0) busy = t.cpuPermille;
+        }
+        lat = profiler.schedulingLatency(1).summary();
+        vTaskDelete(handle);
+    }
+    state.counter("busy_permille", busy);
+    state.counter("expected_permille", 1000 * BUSY_MS / PERIOD_MS);
+    state.counter("probe_p99_us", lat.p99);
+    state.counter("probe_max_us", lat.max);
+}
@@ -0,0 +1,56 @@
+#include <string.h>
+
+#include "Bench.h"
+#include "Telemetry.h"
+
+namespace {
+
+TelemetrySample exampleSample() {
+    TelemetrySample s = {};
+    s.timeMs = 123456;
+    s.js.value = q15FromFloat(-0.42f);
+    s.js.calibrated = true;
+    s.js.raw = 24501;
+    s.voltage = 1.234f;
+    s.js.samples = 98765;
+    s.hasSetpoint = true;
+    s.setpoint = -2260;
+    s.hasStatus = true;
+    s.status.erpm = -2251;
+    s.status.current = 12.3f;
+    s.status.duty = -0.231f;
+    s.status.inputVoltage = 24.8f;
+    s.status.tempFet = 41.5f;
+    s.status.tempMotor = 38.0f;
+    s.statusAgeMs = 7;
+    s.txSent = 500000;
+    return s;
+}
+
+}  // namespace
+
+// Ein Takt: einmal kodieren, egal wie viele Clients zuschauen.
+BENCH(Telemetry_encodeJson) {
+    TelemetrySample s = exampleSample();
+    char buf[512];
+    size_t len = 0;
+    while (state.keepRunning()) {
+        s.js.samples++;
+        len = encodeTelemetryJson(s, buf, sizeof(buf));
+        benchKeep(buf);
+    }
+    state.counter("bytes", len);
+}
+
+// Verteilen an 4 Clients: nur noch Kopien desselben Puffers.
+BENCH(Telemetry_fanOut4) {
+    TelemetrySample s = exampleSample();
+    char buf[512];
+    char client[4][512];
+    while (state.keepRunning()) {
+        s.js.samples++;
+        size_t len = encodeTelemetryJson(s, buf, sizeof(buf));
+        for (auto& c : client) memcpy(c, buf, len);
+        benchClobber();
+    }
+}
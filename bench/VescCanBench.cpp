@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+#include "CanTxQueue.h"
+#include "NativeHal.h"
+#include "VescCan.h"
+
+namespace {
+
+// Gestarteter Bus mit den Controllern 1..controllers.
+struct Bus {
+    VescCan vesc{GPIO_NUM_14, GPIO_NUM_13, 500000};
+
+    explicit Bus(int controllers = 1, int refresh_ms = 0) {
+        for (int i = 1; i <= controllers; i++) vesc.addController(i, refresh_ms);
+        vesc.begin();
+    }
+};
+
+}  // namespace
+
+// Kodierung und Einreihen in die Sendewarteschlange: das, was der Aufrufer bezahlt.
+// Sendet der Task gerade noch, werden die Sollwerte im selben Slot zusammengefasst.
+BENCH(VescCan_setDuty) {
+    Bus bus;
+    float duty = 0.0f;
+    while (state.keepRunning()) {
+        benchKeep(bus.vesc.setDuty(1, duty));
+        duty = duty < 1.0f ? duty + 0.001f : 0.0f;
+    }
+}
+
+BENCH(VescCan_setCurrent) {
+    Bus bus;
+    float current = 0.0f;
+    while (state.keepRunning()) {
+        benchKeep(bus.vesc.setCurrent(1, current));
+        current = current < 50.0f ? current + 0.1f : 0.0f;
+    }
+}
+
+BENCH(VescCan_sendRpm) {
+    Bus bus;
+    int32_t rpm = -4000;
+    while (state.keepRunning()) {
+        benchKeep(bus.vesc.sendRpm(1, rpm));
+        rpm = rpm < 4000 ? rpm + 1 : -4000;
+    }
+}
+
+// Ein Sollwert rein, einer raus: Kosten von Slot-Schreiben, Ring und Seqlock.
+BENCH(CanTxQueue_pushPop) {
+    CanTxQueue queue;
+    CanFrame frame = {(3u << 8) | 1, 4, {0, 0, 0x0F, 0xA0}, 0, 0};
+    CanFrame out;
+    while (state.keepRunning()) {
+        queue.push(frame, true);
+        queue.pop(out);
+        frame.data[3]++;
+    }
+    benchKeep(out);
+}
+
+namespace {
+
+// Referenz: die bis dahin handgeschriebene Kodierung aus VescCan::setDuty().
+void appendInt32BE(uint8_t *buf, int32_t val) {
+    buf[0] = (val >> 24) & 0xFF;
+    buf[1] = (val >> 16) & 0xFF;
+    buf[2] = (val >> 8)  & 0xFF;
+    buf[3] = val & 0xFF;
+}
+
+__attribute__((noinline)) void encodeDutyHandwritten(CanFrame &frame, uint8_t controller_id, float duty) {
+    int32_t v = (int32_t)(duty * 100000.0f);
+    appendInt32BE(frame.data, v);
+    frame.id = (0u << 8) | controller_id;
+    frame.len = 4;
+}
+
+__attribute__((noinline)) void encodeDutyTable(CanFrame &frame, uint8_t controller_id, float duty) {
+    encodeVesc<VescCommand::SET_DUTY>(frame, controller_id, duty);
+}
+
+__attribute__((noinline)) void encodeLimitsTable(CanFrame &frame, uint8_t controller_id, float lo, float hi) {
+    encodeVesc<VescCommand::CONF_CURRENT_LIMITS>(frame, controller_id, lo, hi);
+}
+
+}  // namespace
+
+// Nur Kodierung in einen CanFrame, ohne Warteschlange.
+BENCH(encode_duty_handwritten) {
+    CanFrame frame;
+    float duty = 0.0f;
+    while (state.keepRunning()) {
+        encodeDutyHandwritten(frame, 1, duty);
+        benchClobber();
+        duty += 0.0001f;
+    }
+    benchKeep(frame);
+}
+
+BENCH(encode_duty_table) {
+    CanFrame frame;
+    float duty = 0.0f;
+    while (state.keepRunning()) {
+        encodeDutyTable(frame, 1, duty);
+        benchClobber();
+        duty += 0.0001f;
+    }
+    benchKeep(frame);
+}
+
+BENCH(encode_current_limits_table) {
+    CanFrame frame;
+    float hi = 0.0f;
+    while (state.keepRunning()) {
+        encodeLimitsTable(frame, 1, -hi, hi);
+        benchClobber();
+        hi += 0.001f;
+    }
+    benchKeep(frame);
+}
+
+// STATUS-Frame dekodieren (ohne Treiber und Seqlock).
+BENCH(decodeVescStatus) {
+    const uint8_t status1[8] = {0x00, 0x00, 0x3A, 0x98, 0x00, 0x7B, 0x01, 0xF4};
+    VescStatus st = {};
+    while (state.keepRunning()) {
+        decodeVescStatus(9, status1, 8, st);
+        benchClobber();
+    }
+    benchKeep(st);
+}
+
+namespace {
+
+// Heartbeat-Task mit n Controllern, alle mit derselben Periode, eine Sekunde lang.
+// Gemessen wird am (Attrappen-)Bus: Frames/s, Abweichung der Abstände je Controller
+// von der Periode (p99/max über alle Controller) und die Spreizung eines Durchlaufs;
+// dazu die Abweichung, die der Task selbst in heartbeatJitter() zählt.
+void runHeartbeat(BenchState& state, int controllers) {
+    const int PERIOD_MS = 10;
+    const int RUN_MS = 1000;
+
+    std::mutex mutex;
+    std::vector<int64_t> stamps[VescCan::MAX_CONTROLLERS + 1];
+    nativehal::setTwaiTxHook([&](const twai_message_t& msg) {
+        int64_t now = esp_timer_get_time();
+        std::lock_guard<std::mutex> lock(mutex);
+        stamps[msg.identifier & 0xFF].push_back(now);
+        return ESP_OK;
+    });
+    LatencyHistogram::Summary task = {};
+    {
+        Bus bus(controllers, PERIOD_MS);
+        for (int i = 1; i <= controllers; i++) bus.vesc.setRpm(i, 1000 * i);
+        while (state.keepRunning()) {
+            bus.vesc.startHeartbeatTask();
+            delay(RUN_MS);
+            bus.vesc.stopHeartbeatTask();
+        }
+        task = bus.vesc.heartbeatJitter().summary();
+    }
+    nativehal::setTwaiTxHook(nullptr);
+
+    size_t frames = 0;
+    std::vector<double> jitterUs;
+    for (int c = 1; c <= controllers; c++) {
+        frames += stamps[c].size();
+        // ab dem zweiten Abstand: der erste Durchlauf liegt nicht auf einer Tick-Grenze
+        for (size_t k = 2; k < stamps[c].size(); k++) {
+            double dt = (double)(stamps[c][k] - stamps[c][k - 1]);
+            jitterUs.push_back(dt > PERIOD_MS * 1000.0 ? dt - PERIOD_MS * 1000.0 : PERIOD_MS * 1000.0 - dt);
+        }
+    }
+    size_t passes = stamps[1].size();
+    for (int c = 2; c <= controllers; c++) passes = std::min(passes, stamps[c].size());
+    double spreadSum = 0;
+    for (size_t k = 0; k < passes; k++) {
+        int64_t lo = stamps[1][k], hi = stamps[1][k];
+        for (int c = 2; c <= controllers; c++) {
+            lo = std::min(lo, stamps[c][k]);
+            hi = std::max(hi, stamps[c][k]);
+        }
+        spreadSum += (double)(hi - lo);
+    }
+    std::sort(jitterUs.begin(), jitterUs.end());
+
+    state.counter("frames_s", frames * 1000.0 / RUN_MS);
+    if (!jitterUs.empty()) {
+        state.counter("jitter_p99_us", jitterUs[(jitterUs.size() * 99) / 100]);
+        state.counter("jitter_max_us", jitterUs.back());
+    }
+    if (passes > 0) state.counter("pass_spread_us", spreadSum / passes);
+    state.counter("task_jitter_p99_us", task.p99);
+}
+
+// Totmannschaltung: Heartbeat alle 10 ms, Sollwert nur einmal gesetzt, Grenze 50 ms.
+// Gezählt werden die Frames mit dem alten Sollwert und mit Strom 0 sowie die Zeit vom
+// Setzen bis zum ersten stromlosen Frame (mindestens 50 ms, höchstens eine Periode mehr).
+BENCH(VescCan_failsafe) {
+    const int PERIOD_MS = 10;
+    const int TIMEOUT_MS = 50;
+
+    std::mutex mutex;
+    int rpmFrames = 0, zeroFrames = 0;
+    int64_t firstZeroUs = 0;
+    nativehal::setTwaiTxHook([&](const twai_message_t& msg) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if ((msg.identifier >> 8) == (uint32_t)VescCommand::SET_RPM) rpmFrames++;
+        if ((msg.identifier >> 8) == (uint32_t)VescCommand::SET_CURRENT) {
+            if (zeroFrames++ == 0) firstZeroUs = esp_timer_get_time();
+        }
+        return ESP_OK;
+    });
+    int64_t setUs = 0;
+    uint32_t trips = 0;
+    {
+        Bus bus(1, PERIOD_MS);
+        bus.vesc.setFailsafe(1, TIMEOUT_MS);
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                rpmFrames = zeroFrames = 0;
+            }
+            state.resumeTiming();
+            setUs = esp_timer_get_time();
+            bus.vesc.setRpm(1, 3000);
+            bus.vesc.startHeartbeatTask();
+            delay(200);
+            bus.vesc.stopHeartbeatTask();
+        }
+        trips = bus.vesc.failsafeTrips();
+    }
+    nativehal::setTwaiTxHook(nullptr);
+
+    state.counter("rpm_frames", rpmFrames);
+    state.counter("zero_frames", zeroFrames);
+    state.counter("trip_ms", (firstZeroUs - setUs) / 1000.0);
+    state.counter("trips", trips);
+}
+
+}  // namespace
+
+// Bus-Off dreimal kurz hintereinander: Zeit bis isOpen() wieder true ist. Der erste
+// Wiederanlauf folgt sofort (nach höchstens einer Prüfperiode), der zweite wartet
+// BUS_CHECK_MS, der dritte doppelt so lange.
+BENCH(VescCan_busOffRecovery) {
+    double firstMs = 0, lastMs = 0;
+    VescCan::BusHealth health = {};
+    while (state.keepRunning()) {
+        Bus bus(1, 10);
+        bus.vesc.setRpm(1, 1000);
+        bus.vesc.startHeartbeatTask();
+        delay(200);
+        for (int i = 0; i < 3; i++) {
+            int64_t offUs = esp_timer_get_time();
+            nativehal::twaiBusOff();
+            while (bus.vesc.isOpen()) delay(1);
+            while (!bus.vesc.isOpen()) delay(1);
+            double ms = (esp_timer_get_time() - offUs) / 1000.0;
+            if (i == 0) firstMs = ms;
+            lastMs = ms;
+        }
+        health = bus.vesc.busHealth();
+    }
+    state.counter("first_recover_ms", firstMs);
+    state.counter("third_recover_ms", lastMs);
+    state.counter("bus_offs", health.busOffs);
+    state.counter("recoveries", health.recoveries);
+}
+
+// Fremde STATUS-Frames fluten den Bus auf gut 60 %: Lastschätzung gegen die wahre Last,
+// Streckung der Heartbeat-Auffrischung (10 ms) und ihr Rückgang, wenn die Flut endet.
+BENCH(VescCan_busLoad) {
+    const int FLOOD_PER_MS = 2;
+    std::atomic<uint32_t> hbFrames{0};
+    nativehal::setTwaiTxHook([&](const twai_message_t&) {
+        hbFrames.fetch_add(1, std::memory_order_relaxed);
+        return ESP_OK;
+    });
+    VescCan::BusHealth loaded = {};
+    double quietFps = 0, loadedFps = 0;
+    uint32_t stretchAfter = 0;
+    while (state.keepRunning()) {
+        Bus bus(1, 10);
+        bus.vesc.setRpm(1, 1000);
+        bus.vesc.startHeartbeatTask();
+        delay(1000);
+        quietFps = hbFrames.exchange(0);
+
+        std::atomic<bool> flooding{true};
+        std::thread flood([&] {
+            twai_message_t msg{};
+            msg.extd = 1;
+            msg.identifier = (9u << 8) | 1;
+            msg.data_length_code = 8;
+            int64_t startUs = esp_timer_get_time();
+            int64_t sent = 0;
+            while (flooding.load()) {
+                int64_t due = (esp_timer_get_time() - startUs) * FLOOD_PER_MS / 1000;
+                for (; sent < due; sent++) nativehal::twaiInjectRx(msg);
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        });
+        delay(2000);
+        hbFrames.store(0);
+        delay(1000);
+        loadedFps = hbFrames.load();
+        loaded = bus.vesc.busHealth();
+        flooding.store(false);
+        flood.join();
+        delay(2000);
+        stretchAfter = bus.vesc.busHealth().refreshStretch;
+    }
+    nativehal::setTwaiTxHook(nullptr);
+
+    double expected = (FLOOD_PER_MS * 1000.0 * VescCan::frameBits(8) + loadedFps * VescCan::frameBits(4)) / 500.0;
+    state.counter("load_permille", loaded.loadPermille);
+    state.counter("expected_permille", expected);
+    state.counter("stretch", loaded.refreshStretch);
+    state.counter("hb_fps_quiet", quietFps);
+    state.counter("hb_fps_loaded", loadedFps);
+    state.counter("stretch_after", stretchAfter);
+}
+
+BENCH(VescCan_heartbeat_1) { runHeartbeat(state, 1); }
+BENCH(VescCan_heartbeat_4) { runHeartbeat(state, 4); }
+BENCH(VescCan_heartbeat_8) { runHeartbeat(state, 8); }
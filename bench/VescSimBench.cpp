@@ -0,0 +1,135 @@
+#include <chrono>
+
+#include <Preferences.h>
+
+#include "Bench.h"
+#include "ControlLoop.h"
+#include "NativeHal.h"
+#include "ThrottleCurve.h"
+#include "VescSim.h"
+
+namespace {
+
+// eigener Pin, der Joystick aus ControlBench läuft auf GPIO_NUM_10 weiter
+const int JOYSTICK_PIN = GPIO_NUM_11;
+const float V_REF = 3.3f;
+
+int64_t wallUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Kalibrierung wie in ControlBench: 0 V, 1 V, 3 V, als Schlüssel von vor dem Blob, die
+// begin() übernimmt; ohne clear() hätte ein Blob aus einem früheren Lauf Vorrang
+void calibrateJoystick() {
+    Preferences prefs;
+    prefs.begin("joystick", false);
+    prefs.clear();
+    prefs.putInt("min_raw", 0);
+    prefs.putInt("center_raw", (int)(1.0f / V_REF * ADC_FULL_SCALE + 0.5f));
+    prefs.putInt("max_raw", (int)(3.0f / V_REF * ADC_FULL_SCALE + 0.5f));
+    prefs.end();
+}
+
+void setStick(float value) {
+    float volts = value >= 0.0f ? 1.0f + 2.0f * value : 1.0f + value;
+    nativehal::setAnalogValue(JOYSTICK_PIN, (int)(volts / V_REF * 4095.0f + 0.5f));
+}
+
+int32_t joystickToRpm(q15_t value) {
+    static ThrottleCurve curve;
+    return curve.map(value);
+}
+
+void reportMetrics(BenchState& state, VescSim& sim, uint8_t id) {
+    VescSim::Metrics m;
+    sim.metrics(id, m);
+    state.counter("unsettled", m.unsettled);
+    state.counter("command_p50_us", m.commandUs.p50);
+    state.counter("response_p50_ms", m.responseMs.p50);
+    state.counter("settle_p99_ms", m.settleMs.p99);
+    state.counter("overshoot_max_pct", m.overshootMaxPct);
+}
+
+}  // namespace
+
+// Zehn Minuten Steuern in virtueller Zeit: Joystick -> Regeltask -> Kennlinie -> CAN ->
+// simulierter VESC mit Propeller, alle 5 s eine neue Stick-Stellung. Die Zeit pro
+// Iteration ist die Rechenzeit für das ganze Manöver.
+BENCH(VescSim_manoeuvre10min) {
+    calibrateJoystick();
+    setStick(0.0f);
+    double speedup = 0;
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        nativehal::virtualTime(true);
+        {
+            VescSim sim;
+            sim.addController(1);
+            Joystick js(JOYSTICK_PIN, V_REF);
+            VescCan vesc(GPIO_NUM_14, GPIO_NUM_13, 500000);
+            vesc.addController(1, 50);
+            vesc.begin();
+            sim.begin();
+            js.begin();
+            ControlLoop control(js, vesc, 1, joystickToRpm);
+            control.begin(100);
+            vesc.startHeartbeatTask();
+            delay(1000);
+
+            static const float positions[] = {0.0f, 0.25f, 0.5f, 1.0f, 0.1f, -0.3f, -1.0f, -0.6f, 0.8f};
+            uint32_t rng = 12345;
+            int64_t startWall = wallUs();
+            int64_t startSim = nativehal::nowUs();
+            state.resumeTiming();
+            for (int i = 0; i < 120; i++) {
+                rng = rng * 1103515245u + 12345u;
+                setStick(positions[(rng >> 16) % 9]);
+                sim.stimulus(1);
+                delay(5000);
+            }
+            sim.finish();
+            state.pauseTiming();
+            speedup = (double)(nativehal::nowUs() - startSim) / (wallUs() - startWall);
+            reportMetrics(state, sim, 1);
+
+            vesc.stopHeartbeatTask();
+        }
+        nativehal::virtualTime(false);
+        state.resumeTiming();
+    }
+    state.counter("speedup", speedup);
+}
+
+// Drehzahlregler des VESC allein: Sprünge direkt über die Sollwerttabelle.
+BENCH(VescSim_rpmSteps) {
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        nativehal::virtualTime(true);
+        {
+            VescSim sim;
+            sim.addController(2);
+            VescCan vesc(GPIO_NUM_14, GPIO_NUM_13, 500000);
+            vesc.addController(2, 50);
+            vesc.begin();
+            sim.begin();
+            vesc.startHeartbeatTask();
+            state.resumeTiming();
+            for (int32_t rpm : {2000, 4000, 1000, -3000, 0, 6000, 0}) {
+                sim.stimulus(2);
+                vesc.setRpm(2, rpm);
+                vesc.sendSetpoint(2);
+                delay(2000);
+            }
+            sim.finish();
+            state.pauseTiming();
+            reportMetrics(state, sim, 2);
+            VescSim::State st;
+            sim.state(2, st);
+            state.counter("vin_at_rest", st.inputVoltage);
+            vesc.stopHeartbeatTask();
+        }
+        nativehal::virtualTime(false);
+        state.resumeTiming();
+    }
+}
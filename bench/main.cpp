@@ -0,0 +1,98 @@
+// Einstiegspunkt der Host-Benchmarks:
+//   pio run -e native -t exec                  alle Fälle
+//   .pio/build/native/program <Teilstring>     nur passende Fälle
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+#include "Bench.h"
+#include "NativeHal.h"
+
+namespace {
+
+struct BenchCase {
+    const char* name;
+    BenchFunction fn;
+};
+
+const int MAX_CASES = 128;
+BenchCase cases[MAX_CASES];
+int caseCount = 0;
+
+int64_t monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+BenchRegistrar::BenchRegistrar(const char* name, BenchFunction fn) {
+    if (caseCount < MAX_CASES) cases[caseCount++] = {name, fn};
+}
+
+void BenchState::start() {
+    started_ = true;
+    resumeTiming();
+}
+
+void BenchState::stop() {
+    pauseTiming();
+}
+
+void BenchState::pauseTiming() {
+    if (!running_) return;
+    elapsedNs_ += monotonicNs() - startNs_;
+    running_ = false;
+}
+
+void BenchState::resumeTiming() {
+    if (running_) return;
+    startNs_ = monotonicNs();
+    running_ = true;
+}
+
+void BenchState::counter(const char* name, double value) {
+    for (int i = 0; i < counterCount_; i++) {
+        if (strcmp(counters_[i].name, name) == 0) {
+            counters_[i].value = value;
+            return;
+        }
+    }
+    if (counterCount_ < MAX_COUNTERS) counters_[counterCount_++] = {name, value};
+}
+
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    nativehal::serialMute(true);
+
+    printf("%-36s %14s %14s\n", "Benchmark", "ns/iter", "Iterationen");
+    for (int c = 0; c < caseCount; c++) {
+        if (filter && !strstr(cases[c].name, filter)) continue;
+
+        uint64_t iterations = 1;
+        BenchState result(0);
+        while (true) {
+            BenchState state(iterations);
+            cases[c].fn(state);
+            result = state;
+            if (state.elapsedNs() >= (int64_t)BENCH_MIN_TIME_MS * 1000000 || iterations >= (1ull << 34)) break;
+            // Auf die Zielzeit hochrechnen, höchstens verzehnfachen.
+            double scale = state.elapsedNs() > 0
+                ? (BENCH_MIN_TIME_MS * 1.2e6) / state.elapsedNs() : 10.0;
+            if (scale > 10.0) scale = 10.0;
+            if (scale < 2.0) scale = 2.0;
+            iterations = (uint64_t)(iterations * scale);
+        }
+
+        printf("%-36s %14.2f %14llu", cases[c].name,
+               (double)result.elapsedNs() / result.iterations(),
+               (unsigned long long)result.iterations());
+        for (int i = 0; i < result.counterCount(); i++) {
+            printf("  %s=%.6g", result.counterAt(i).name, result.counterAt(i).value);
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <cmath>
+
+// Frühere Abbildung in double, ersetzt durch ThrottleCurve; bleibt als Vergleich
+// für bench/MappingBench.cpp.
+// [-1,0)  -> [-4000,-1000]
+// 0       -> 0
+// (0,1]   -> [1000,4000]
+inline double mapSplit(double x) {
+  if (x == 0.0) return 0.0;
+  return std::copysign(1000.0 + std::fabs(x) * 3000.0, x);
+}
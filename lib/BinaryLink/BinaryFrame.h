@@ -0,0 +1,120 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Binärrahmen für die serielle Schnittstelle, gemeinsam für Gerät und PC-Seite.
+ *
+ *   0x00 | COBS( Typ | Folgenummer | Nutzdaten... | CRC16 lo | CRC16 hi ) | 0x00
+ *
+ * COBS entfernt alle Nullbytes aus dem Rahmen, 0x00 trennt also eindeutig. Da Text
+ * nie 0x00 enthält, laufen Rahmen und Textbefehle auf derselben Leitung: alles
+ * zwischen einem Rahmenende und der nächsten 0x00 ist Text. Jeder Rahmen braucht
+ * deshalb eine eigene führende und abschließende 0x00.
+ * CRC-16/XMODEM (Polynom 0x1021, Start 0) über Typ bis Nutzdatenende, wie beim VESC.
+ * Alle Zahlen in den Nutzdaten sind little-endian.
+ */
+
+enum BinaryMessage : uint8_t {
+    // PC -> Gerät
+    MSG_PING = 0x01,            // beliebige Nutzdaten, Antwort MSG_PONG mit denselben Daten
+    MSG_SETPOINTS = 0x02,       // n x { id u8, VescCommand u8, Wert f32 }
+    MSG_STREAM = 0x03,          // Rate Hz u16 (0 = aus), n x id u8: Telemetrie dieser Controller
+    MSG_CONTROL = 0x04,         // Modus u8: 0 = Joystick, 1 = PC
+    // Gerät -> PC
+    MSG_PONG = 0x81,
+    MSG_TELEMETRY = 0x82,       // siehe BinaryLink.h
+};
+
+static const size_t BINARY_MAX_PAYLOAD = 128;
+static const size_t BINARY_MAX_RAW = 2 + BINARY_MAX_PAYLOAD + 2;
+// COBS: ein Codebyte je angefangene 254 Bytes, dazu die beiden Trennbytes
+static const size_t BINARY_MAX_ENCODED = BINARY_MAX_RAW + BINARY_MAX_RAW / 254 + 1 + 2;
+
+uint16_t crc16(const uint8_t* data, size_t len);
+
+/** @return Länge der Ausgabe, 0 wenn cap nicht reicht */
+size_t cobsEncode(const uint8_t* src, size_t len, uint8_t* dst, size_t cap);
+/** @brief Darf in place dekodieren (dst == src); 0 bei ungültiger Kodierung oder zu kleinem cap */
+size_t cobsDecode(const uint8_t* src, size_t len, uint8_t* dst, size_t cap);
+
+/**
+ * @brief Baut einen vollständigen Rahmen samt Trennbytes
+ * @return Anzahl Bytes in out, 0 wenn len oder cap nicht passen
+ */
+size_t encodeBinaryFrame(uint8_t type, uint8_t seq, const uint8_t* payload, size_t len,
+                         uint8_t* out, size_t cap);
+
+/**
+ * @brief Zerlegt einen Bytestrom in Rahmen und lässt Text durch
+ *
+ *   FrameDecoder dec;
+ *   switch (dec.push(byte)) {
+ *       case FrameDecoder::TEXT:  ... byte gehört zu einer Textzeile ...
+ *       case FrameDecoder::FRAME: handle(dec.type(), dec.payload(), dec.length());
+ *       default: break;
+ *   }
+ */
+class FrameDecoder {
+public:
+    enum Result {
+        TEXT,           // kein Rahmenbyte, an den Textparser weitergeben
+        CONSUMED,       // Teil eines Rahmens
+        FRAME,          // Rahmen vollständig und gültig
+        DROPPED         // Rahmen verworfen (CRC, Kodierung, zu lang)
+    };
+
+    Result push(uint8_t byte);
+
+    // gültig nach FRAME bis zum nächsten push()
+    uint8_t type() const { return buf[0]; }
+    uint8_t seq() const { return buf[1]; }
+    const uint8_t* payload() const { return buf + 2; }
+    size_t length() const { return payloadLen; }
+
+    uint32_t frames() const { return frameCount; }
+    uint32_t crcErrors() const { return crcErrorCount; }
+    uint32_t formatErrors() const { return formatErrorCount; }
+
+private:
+    enum State { IDLE, IN_FRAME, DISCARD };
+    State state = IDLE;
+    uint8_t buf[BINARY_MAX_ENCODED];
+    size_t len = 0;
+    size_t payloadLen = 0;
+    uint32_t frameCount = 0;
+    uint32_t crcErrorCount = 0;
+    uint32_t formatErrorCount = 0;
+
+    Result finish();
+};
+
+// Little-endian-Felder in Nutzdaten
+inline void binaryPut16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+inline void binaryPut32(uint8_t* p, uint32_t v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = v >> 24;
+}
+inline void binaryPutFloat(uint8_t* p, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, 4);
+    binaryPut32(p, bits);
+}
+inline uint16_t binaryGet16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+inline uint32_t binaryGet32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+inline float binaryGetFloat(const uint8_t* p) {
+    uint32_t bits = binaryGet32(p);
+    float v;
+    memcpy(&v, &bits, 4);
+    return v;
+}
@@ -0,0 +1,243 @@
+#include <math.h>
+
+#include "BinaryLink.h"
+#include "Q15.h"
+#include "TaskPlacement.h"
+
+static const size_t SETPOINT_SIZE = 6;        // id, Kommando, f32
+static const size_t TELEMETRY_HEADER = 8;
+static const size_t TELEMETRY_ENTRY = 15;
+
+static int16_t clamp16(float v) {
+    if (!(v == v)) return 0;
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return (int16_t)lrintf(v);
+}
+
+BinaryLink::BinaryLink(Print& out, Joystick& js, VescCan& vesc, ControlLoop* control)
+    : out(out), js(js), vesc(vesc), control(control) {
+    for (std::atomic<uint32_t>& t : touched) t.store(0, std::memory_order_relaxed);
+    stream.store(StreamConfig{0, 0, {}});
+}
+
+BinaryLink::~BinaryLink() {
+    if (taskHandle) {
+        vTaskDelete(taskHandle);
+        taskHandle = nullptr;
+    }
+}
+
+void BinaryLink::attach(SerialCommands& commands) {
+    commands.SetByteFilter(filter, this);
+}
+
+void BinaryLink::detach(SerialCommands& commands) {
+    commands.SetByteFilter(nullptr, nullptr);
+}
+
+void BinaryLink::begin() {
+    if (taskHandle) return;
+    startTask(taskWrapper, TASK_BINARY_LINK, this, &taskHandle);
+}
+
+BinaryLink::Stats BinaryLink::stats() const {
+    Stats st;
+    st.frames = decoder.frames();
+    st.crcErrors = decoder.crcErrors();
+    st.formatErrors = decoder.formatErrors() + unknownCount.load(std::memory_order_relaxed);
+    st.setpoints = setpointCount.load(std::memory_order_relaxed);
+    st.rejected = rejectedCount.load(std::memory_order_relaxed);
+    st.telemetry = telemetryCount.load(std::memory_order_relaxed);
+    st.pongs = pongCount.load(std::memory_order_relaxed);
+    st.hostTimeouts = timeoutCount.load(std::memory_order_relaxed);
+    return st;
+}
+
+// --- Empfang, im Befehls-Task ---
+
+bool BinaryLink::filter(void* context, uint8_t byte) {
+    BinaryLink* self = static_cast<BinaryLink*>(context);
+    FrameDecoder::Result r = self->decoder.push(byte);
+    if (r == FrameDecoder::FRAME) self->handleFrame();
+    return r != FrameDecoder::TEXT;
+}
+
+void BinaryLink::handleFrame() {
+    const uint8_t* p = decoder.payload();
+    size_t len = decoder.length();
+    lastRxSeq.store(decoder.seq(), std::memory_order_relaxed);
+
+    switch (decoder.type()) {
+    case MSG_PING:
+        // läuft noch eine Antwort, fällt dieser PING aus
+        if (pongPending.load(std::memory_order_acquire)) break;
+        pongSeq = decoder.seq();
+        pongLen = (uint8_t)len;
+        memcpy(pongData, p, len);
+        pongPending.store(true, std::memory_order_release);
+        if (taskHandle) xTaskNotifyGive(taskHandle);
+        break;
+
+    case MSG_SETPOINTS:
+        handleSetpoints(p, len);
+        break;
+
+    case MSG_STREAM:
+        handleStream(p, len);
+        break;
+
+    case MSG_CONTROL:
+        if (len != 1 || p[0] > 1) {
+            unknownCount.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        lastSetpointMs.store(millis(), std::memory_order_relaxed);
+        hostMode.store(p[0] == 1, std::memory_order_relaxed);
+        if (control) control->setEnabled(p[0] == 0);
+        break;
+
+    default:
+        unknownCount.fetch_add(1, std::memory_order_relaxed);
+        break;
+    }
+}
+
+void BinaryLink::handleSetpoints(const uint8_t* p, size_t len) {
+    if (len == 0 || len % SETPOINT_SIZE != 0) {
+        unknownCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // vor dem ersten Sollwert, damit die Zeitüberwachung ihn nicht sofort zurücknimmt
+    lastSetpointMs.store(millis());
+    for (size_t i = 0; i < len; i += SETPOINT_SIZE) {
+        uint8_t id = p[i];
+        VescCommand cmd = (VescCommand)p[i + 1];
+        float value = binaryGetFloat(p + i + 2);
+        // Skalierung in int32 darf nicht überlaufen
+        if (!(fabsf(value) < 20000.0f) || !vesc.setSetpoint(id, cmd, value)) {
+            rejectedCount.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        vesc.sendSetpoint(id);
+        touched[id >> 5].fetch_or(1u << (id & 31), std::memory_order_relaxed);
+        setpointCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void BinaryLink::handleStream(const uint8_t* p, size_t len) {
+    if (len < 2 || len - 2 > (size_t)MAX_STREAM_IDS) {
+        unknownCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    StreamConfig cfg = {};
+    cfg.rateHz = binaryGet16(p);
+    if (cfg.rateHz > MAX_RATE_HZ) cfg.rateHz = MAX_RATE_HZ;
+    cfg.count = (uint8_t)(len - 2);
+    memcpy(cfg.ids, p + 2, cfg.count);
+    stream.store(cfg);
+    if (taskHandle) xTaskNotifyGive(taskHandle);
+}
+
+// --- Senden, im eigenen Task ---
+
+void BinaryLink::taskWrapper(void* param) {
+    static_cast<BinaryLink*>(param)->sendTask();
+}
+
+void BinaryLink::sendTask() {
+    uint32_t version = 0;
+    TickType_t next = xTaskGetTickCount();
+    while (true) {
+        StreamConfig cfg = stream.load();
+        TickType_t period = cfg.rateHz ? pdMS_TO_TICKS(1000 / cfg.rateHz) : 0;
+        if (cfg.rateHz && period == 0) period = 1;
+
+        // neue Einstellung: Takt ab jetzt
+        if (stream.version() != version) {
+            version = stream.version();
+            next = xTaskGetTickCount();
+        }
+
+        // ohne Takt nur für PING und die Zeitüberwachung aufwachen
+        TickType_t wait = pdMS_TO_TICKS(HOST_TIMEOUT_MS / 5);
+        if (period) {
+            int32_t due = (int32_t)(next - xTaskGetTickCount());
+            if (due < (int32_t)wait) wait = due > 0 ? due : 0;
+        }
+        if (wait) ulTaskNotifyTake(pdTRUE, wait);
+
+        if (pongPending.load(std::memory_order_acquire)) {
+            send(MSG_PONG, pongSeq, pongData, pongLen);
+            pongPending.store(false, std::memory_order_release);
+            pongCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        checkHostTimeout();
+
+        if (period && (int32_t)(xTaskGetTickCount() - next) >= 0) {
+            sendTelemetry(stream.load());
+            next += period;
+            // zu weit zurück (z. B. Leitung blockiert): nicht nachholen
+            if ((int32_t)(xTaskGetTickCount() - next) > (int32_t)period) next = xTaskGetTickCount() + period;
+        }
+    }
+}
+
+void BinaryLink::send(uint8_t type, uint8_t seq, const uint8_t* payload, size_t len) {
+    size_t n = encodeBinaryFrame(type, seq, payload, len, txBuf, sizeof(txBuf));
+    if (n) out.write(txBuf, n);
+}
+
+void BinaryLink::sendTelemetry(const StreamConfig& cfg) {
+    uint8_t p[TELEMETRY_HEADER + MAX_STREAM_IDS * TELEMETRY_ENTRY];
+    JoystickSnapshot s = js.getSnapshot();
+
+    binaryPut32(p, (uint32_t)esp_timer_get_time());
+    p[4] = lastRxSeq.load(std::memory_order_relaxed);
+    binaryPut16(p + 5, s.calibrated ? (uint16_t)s.value : 0x8000);
+
+    size_t len = TELEMETRY_HEADER;
+    uint8_t n = 0;
+    uint32_t nowMs = millis();
+    for (uint8_t i = 0; i < cfg.count; i++) {
+        VescStatus st;
+        if (!vesc.getStatus(cfg.ids[i], st)) continue;
+        uint8_t* e = p + len;
+        uint32_t age = st.updatedMs ? nowMs - st.updatedMs : 0xFFFF;
+        e[0] = cfg.ids[i];
+        binaryPut32(e + 1, (uint32_t)st.erpm);
+        binaryPut16(e + 5, (uint16_t)clamp16(st.current * 10.0f));
+        binaryPut16(e + 7, (uint16_t)clamp16(st.duty * 1000.0f));
+        binaryPut16(e + 9, (uint16_t)clamp16(st.inputVoltage * 10.0f));
+        binaryPut16(e + 11, (uint16_t)clamp16(st.tempFet * 10.0f));
+        binaryPut16(e + 13, (uint16_t)(age < 0xFFFF ? age : 0xFFFF));
+        len += TELEMETRY_ENTRY;
+        n++;
+    }
+    p[7] = n;
+
+    send(MSG_TELEMETRY, txSeq++, p, len);
+    telemetryCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void BinaryLink::checkHostTimeout() {
+    bool any = false;
+    for (std::atomic<uint32_t>& t : touched) any |= t.load(std::memory_order_relaxed) != 0;
+    if (!any && !hostMode.load(std::memory_order_relaxed)) return;
+    if (millis() - lastSetpointMs.load() <= HOST_TIMEOUT_MS) return;
+
+    // PC schweigt: seine Controller stromlos, Joystick übernimmt wieder
+    for (int w = 0; w < 8; w++) {
+        uint32_t bits = touched[w].exchange(0, std::memory_order_relaxed);
+        for (int b = 0; bits; b++, bits >>= 1) {
+            if (!(bits & 1)) continue;
+            uint8_t id = (uint8_t)(w * 32 + b);
+            vesc.setSetpoint(id, VescCommand::SET_CURRENT, 0.0f);
+            vesc.sendSetpoint(id);
+        }
+    }
+    hostMode.store(false, std::memory_order_relaxed);
+    if (control) control->setEnabled(true);
+    timeoutCount.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+#include "BinaryFrame.h"
+#include "ControlLoop.h"
+#include "Joystick.h"
+#include "SeqLock.h"
+#include "SerialCommands.h"
+#include "VescCan.h"
+
+/**
+ * @brief Binärprotokoll auf der Befehlsschnittstelle: Sollwerte vom PC, Telemetrie zurück
+ *
+ * Die Rahmen (BinaryFrame.h) laufen neben den Textbefehlen über dieselbe Leitung:
+ * attach() hängt den Dekoder als Bytefilter vor SerialCommands, Rahmen werden also im
+ * Befehls-Task ausgewertet. Sollwerte gehen sofort in die Sollwerttabelle von VescCan
+ * und auf den Bus. Ein eigener Task sendet Telemetrie mit bis zu 1 kHz und die
+ * Antworten auf PING; er ist der einzige, der Rahmen schreibt.
+ *
+ * Kommen HOST_TIMEOUT_MS lang keine Sollwerte mehr, werden alle vom PC gesetzten
+ * Controller auf Strom 0 gesetzt und der Joystick übernimmt wieder.
+ *
+ * MSG_TELEMETRY, Nutzdaten (little-endian):
+ *   Zeit us u32 | letzte empfangene Folgenummer u8 | Joystick Q15 i16 (-32768 = nicht
+ *   kalibriert) | n u8 | n x { id u8, eRPM i32, Strom 0.1 A i16, Duty 0.001 i16,
+ *   Eingangsspannung 0.1 V u16, FET-Temperatur 0.1 °C i16, Alter ms u16 }
+ */
+class BinaryLink {
+public:
+    static const int MAX_STREAM_IDS = 8;
+    static const int MAX_RATE_HZ = 1000;
+    static const uint32_t HOST_TIMEOUT_MS = 250;
+
+    /**
+     * @param out Ausgabe der Rahmen, normalerweise dieselbe Schnittstelle wie die Befehle
+     * @param control wird abgeschaltet, solange der PC per MSG_CONTROL steuert (optional)
+     */
+    BinaryLink(Print& out, Joystick& js, VescCan& vesc, ControlLoop* control = nullptr);
+    ~BinaryLink();
+
+    /** @brief Rahmen aus dem Eingang von commands herausfiltern */
+    void attach(SerialCommands& commands);
+    void detach(SerialCommands& commands);
+
+    /** @brief Startet den Sende-Task */
+    void begin();
+
+    struct Stats {
+        uint32_t frames;        // gültige Rahmen empfangen
+        uint32_t crcErrors;
+        uint32_t formatErrors;  // Kodierung, Länge, unbekannter Typ
+        uint32_t setpoints;     // übernommene Sollwerte
+        uint32_t rejected;      // abgelehnte Sollwerte (Controller, Kommando, Wert)
+        uint32_t telemetry;     // gesendete Telemetrierahmen
+        uint32_t pongs;
+        uint32_t hostTimeouts;
+    };
+    Stats stats() const;
+
+    bool hostControl() const { return hostMode.load(std::memory_order_relaxed); }
+    int streamRate() const { return stream.load().rateHz; }
+
+private:
+    Print& out;
+    Joystick& js;
+    VescCan& vesc;
+    ControlLoop* control;
+
+    // nur im Befehls-Task
+    FrameDecoder decoder;
+
+    struct StreamConfig {
+        uint16_t rateHz;
+        uint8_t count;
+        uint8_t ids[MAX_STREAM_IDS];
+    };
+    SeqLock<StreamConfig> stream;
+
+    // PING -> PONG: der Befehls-Task legt ab, der Sende-Task verschickt
+    std::atomic<bool> pongPending{false};
+    uint8_t pongSeq = 0;
+    uint8_t pongLen = 0;
+    uint8_t pongData[BINARY_MAX_PAYLOAD];
+
+    std::atomic<uint8_t> lastRxSeq{0};
+    std::atomic<bool> hostMode{false};
+    std::atomic<uint32_t> lastSetpointMs{0};
+    std::atomic<uint32_t> touched[8];      // Bit je Controller-ID, die der PC gesetzt hat
+
+    std::atomic<uint32_t> setpointCount{0}, rejectedCount{0}, unknownCount{0};
+    std::atomic<uint32_t> telemetryCount{0}, pongCount{0}, timeoutCount{0};
+
+    uint8_t txSeq = 0;                     // Telemetrie; PONG übernimmt die Nummer des PING
+    uint8_t txBuf[BINARY_MAX_ENCODED];
+    TaskHandle_t taskHandle = nullptr;
+
+    static bool filter(void* context, uint8_t byte);
+    void handleFrame();
+    void handleSetpoints(const uint8_t* p, size_t len);
+    void handleStream(const uint8_t* p, size_t len);
+
+    static void taskWrapper(void* param);
+    void sendTask();
+    void send(uint8_t type, uint8_t seq, const uint8_t* payload, size_t len);
+    void sendTelemetry(const StreamConfig& cfg);
+    void checkHostTimeout();
+};
@@ -0,0 +1,186 @@
+#include "CanTrace.h"
+#include "TaskPlacement.h"
+
+const char* const CanTrace::FILE_PATH = "/cantrace.bin";
+const char* const CanTrace::OLD_FILE_PATH = "/cantrace.1.bin";
+
+static const uint8_t FILE_MAGIC[4] = {'C', 'T', 'R', '1'};
+static const uint8_t BLOCK_MARKER = 0xCB;
+
+static size_t putVarint(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+CanTrace::CanTrace(fs::FS& storage) : storage(storage) {}
+
+CanTrace::~CanTrace() {
+    if (taskHandle) {
+        vTaskDelete(taskHandle);
+        taskHandle = nullptr;
+    }
+}
+
+void CanTrace::begin() {
+    if (taskHandle) return;
+    fs::File f = storage.open(FILE_PATH, FILE_READ);
+    fileSize.store(f ? (uint32_t)f.size() : 0, std::memory_order_relaxed);
+    f.close();
+    startTask(taskWrapper, TASK_CAN_TRACE, this, &taskHandle);
+}
+
+void CanTrace::requestFlush() {
+    flushPending.store(true, std::memory_order_relaxed);
+    if (taskHandle) xTaskNotifyGive(taskHandle);
+}
+
+void CanTrace::clear() {
+    clearPending.store(true, std::memory_order_relaxed);
+    if (taskHandle) xTaskNotifyGive(taskHandle);
+}
+
+CanTrace::Stats CanTrace::stats() const {
+    Stats st;
+    st.frames = frameCount.load(std::memory_order_relaxed);
+    st.lost = txLost.load(std::memory_order_relaxed) + rxLost.load(std::memory_order_relaxed);
+    st.blocks = blockCount.load(std::memory_order_relaxed);
+    st.pages = pageCount.load(std::memory_order_relaxed);
+    st.partialPages = partialCount.load(std::memory_order_relaxed);
+    st.frameBytes = frameByteCount.load(std::memory_order_relaxed);
+    st.bytes = byteCount.load(std::memory_order_relaxed);
+    st.fileBytes = fileSize.load(std::memory_order_relaxed);
+    st.writeErrors = errorCount.load(std::memory_order_relaxed);
+    st.writeAmplification = st.frameBytes ? (float)st.bytes / st.frameBytes : 0.0f;
+    return st;
+}
+
+size_t CanTrace::encodeEntry(const CanTraceEntry& e, uint32_t deltaUs, uint8_t* out) {
+    size_t n = 0;
+    out[n++] = e.flags;
+    if (e.flags & CAN_TRACE_ERR) out[n++] = e.result;
+    n += putVarint(out + n, deltaUs);
+    n += putVarint(out + n, e.id);
+    if (!(e.flags & CAN_TRACE_RTR)) {
+        uint8_t len = e.flags & CAN_TRACE_LEN;
+        memcpy(out + n, e.data, len);
+        n += len;
+    }
+    return n;
+}
+
+// --- Schreib-Task ---
+
+void CanTrace::taskWrapper(void* param) {
+    static_cast<CanTrace*>(param)->writerTask();
+}
+
+void CanTrace::writerTask() {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FLUSH_MS));
+        if (clearPending.exchange(false, std::memory_order_relaxed)) {
+            storage.remove(OLD_FILE_PATH);
+            storage.remove(FILE_PATH);
+            fileSize.store(0, std::memory_order_relaxed);
+            // angefangene Seite gehört zur gelöschten Datei
+            pageLen = 0;
+            pageFrameBytes = 0;
+        }
+        flush();
+        if (flushPending.exchange(false, std::memory_order_relaxed) && pageLen > 0) writePage();
+    }
+}
+
+void CanTrace::flush() {
+    size_t nt = 0, nr = 0;
+    while (nt < RING_SIZE && txRing.pop(txBatch[nt])) nt++;
+    while (nr < RING_SIZE && rxRing.pop(rxBatch[nr])) nr++;
+    uint32_t lost = txLost.load(std::memory_order_relaxed) + rxLost.load(std::memory_order_relaxed);
+    if (nt + nr == 0 && lost == lostReported) return;
+
+    // Dateiwechsel nur an einer Blockgrenze, damit jede Datei für sich dekodierbar bleibt
+    uint32_t size = fileSize.load(std::memory_order_relaxed);
+    if (size + pageLen >= MAX_FILE_BYTES) {
+        if (pageLen > 0) writePage();
+        storage.remove(OLD_FILE_PATH);
+        storage.rename(FILE_PATH, OLD_FILE_PATH);
+        fileSize.store(size = 0, std::memory_order_relaxed);
+    }
+    if (size == 0 && pageLen == 0) stage(FILE_MAGIC, sizeof(FILE_MAGIC), false);
+
+    // Zeitstempel auf 64 Bit erweitern: alle Frames sind jünger als 71 Minuten
+    int64_t now = esp_timer_get_time();
+    size_t it = 0, ir = 0;
+    const CanTraceEntry* first = nullptr;
+    if (nt && nr) first = (int32_t)(txBatch[0].us - rxBatch[0].us) <= 0 ? &txBatch[0] : &rxBatch[0];
+    else if (nt + nr) first = nt ? &txBatch[0] : &rxBatch[0];
+    int64_t base = first ? now - (uint32_t)((uint32_t)now - first->us) : now;
+    if (base < lastUs) base = lastUs;
+
+    uint32_t lostDelta = lost - lostReported;
+    lostReported = lost;
+    uint8_t header[13];
+    header[0] = BLOCK_MARKER;
+    for (int i = 0; i < 8; i++) header[1 + i] = (uint8_t)((uint64_t)base >> (8 * i));
+    uint16_t count = (uint16_t)(nt + nr);
+    header[9] = count & 0xFF;
+    header[10] = count >> 8;
+    uint16_t lost16 = lostDelta > 0xFFFF ? 0xFFFF : (uint16_t)lostDelta;
+    header[11] = lost16 & 0xFF;
+    header[12] = lost16 >> 8;
+    stage(header, sizeof(header), false);
+
+    // beide Ringe sind für sich zeitlich sortiert: zusammenführen
+    int64_t prev = base;
+    uint8_t buf[24];
+    while (it < nt || ir < nr) {
+        const CanTraceEntry* e;
+        if (ir == nr || (it < nt && (int32_t)(txBatch[it].us - rxBatch[ir].us) <= 0)) e = &txBatch[it++];
+        else e = &rxBatch[ir++];
+        int64_t us = now - (uint32_t)((uint32_t)now - e->us);
+        // Zeitstempel und Einreihen sind nicht atomar; um Mikrosekunden rückwärts -> 0
+        if (us < prev) us = prev;
+        stage(buf, encodeEntry(*e, (uint32_t)(us - prev), buf), true);
+        prev = us;
+    }
+    lastUs = prev;
+
+    frameCount.fetch_add(nt + nr, std::memory_order_relaxed);
+    blockCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CanTrace::stage(const uint8_t* data, size_t len, bool frame) {
+    while (len > 0) {
+        size_t room = PAGE_BYTES - (fileSize.load(std::memory_order_relaxed) + pageLen) % PAGE_BYTES;
+        size_t n = len < room ? len : room;
+        memcpy(page + pageLen, data, n);
+        pageLen += n;
+        if (frame) pageFrameBytes += n;
+        data += n;
+        len -= n;
+        if (n == room) writePage();
+    }
+}
+
+void CanTrace::writePage() {
+    uint32_t size = fileSize.load(std::memory_order_relaxed);
+    bool full = (size + pageLen) % PAGE_BYTES == 0;
+    fs::File file = storage.open(FILE_PATH, FILE_APPEND);
+    size_t n = 0;
+    if (file) {
+        n = file.write(page, pageLen);
+        file.close();
+    }
+    if (n != pageLen) errorCount.fetch_add(1, std::memory_order_relaxed);
+    fileSize.store(size + n, std::memory_order_relaxed);
+    byteCount.fetch_add(n, std::memory_order_relaxed);
+    frameByteCount.fetch_add(pageFrameBytes, std::memory_order_relaxed);
+    pageCount.fetch_add(1, std::memory_order_relaxed);
+    if (!full) partialCount.fetch_add(1, std::memory_order_relaxed);
+    pageLen = 0;
+    pageFrameBytes = 0;
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include <driver/twai.h>
+#include <esp_timer.h>
+#include <atomic>
+
+#include "SpscRing.h"
+
+/** @brief Ein mitgeschnittener CAN-Frame, 20 Bytes */
+struct CanTraceEntry {
+    uint32_t us;            // esp_timer, untere 32 Bit
+    uint32_t id;
+    uint8_t flags;          // CAN_TRACE_TX | CAN_TRACE_EXT | CAN_TRACE_RTR | CAN_TRACE_ERR | Länge
+    uint8_t result;         // nur mit CAN_TRACE_ERR: CanTraceResult
+    uint8_t data[8];
+};
+
+enum : uint8_t {
+    CAN_TRACE_TX = 0x80,    // gesendet (sonst empfangen)
+    CAN_TRACE_EXT = 0x40,   // erweiterte ID
+    CAN_TRACE_RTR = 0x20,
+    CAN_TRACE_ERR = 0x10,   // twai_transmit hat abgelehnt, result gibt den Grund
+    CAN_TRACE_LEN = 0x0F,
+};
+
+enum CanTraceResult : uint8_t {
+    CAN_TRACE_TIMEOUT = 1,          // Sendewarteschlange des Treibers voll
+    CAN_TRACE_INVALID_STATE = 2,    // Treiber gestoppt oder Bus-Off
+    CAN_TRACE_FAIL = 3,             // sonstiger Fehler
+};
+
+/**
+ * @brief Ständig laufender Mitschnitt aller gesendeten und empfangenen CAN-Frames
+ *
+ * VescCan ruft recordTx() nach jedem twai_transmit und recordRx() für jeden Frame aus
+ * twai_receive. Beides kostet einen Zeitstempel und eine Kopie in einen lock-freien
+ * Ring; je Richtung gibt es einen eigenen Ring, weil Sende- und Empfangstask die
+ * einzigen Produzenten sind. Ist ein Ring voll, geht der Frame verloren und wird
+ * gezählt — der Sendepfad wartet nie.
+ *
+ * Ein eigener Task leert die Ringe alle FLUSH_MS (oder sobald einer halb voll ist) und
+ * kodiert die Frames als Block in eine Seite im RAM. Erst eine volle Seite geht in einem
+ * Stück an FILE_PATH auf LittleFS; die Seiten enden auf PAGE_BYTES-Grenzen der Datei,
+ * so dass LittleFS nie einen halb gefüllten Block für ein paar hundert Bytes neu
+ * schreibt. Eine angefangene Seite schreibt nur requestFlush(); bis dahin steht bis zu
+ * eine Seite Frames nur im RAM. Ab MAX_FILE_BYTES wird die Datei am nächsten
+ * Blockanfang nach OLD_FILE_PATH verschoben; tools/cantrace2candump.py wandelt beide in
+ * das candump-Format.
+ *
+ * Dateiformat (little-endian):
+ *   Kopf:   "CTR1"
+ *   Block:  0xCB | Startzeit us u64 | Anzahl u16 | verloren seit letztem Block u16 | Frames
+ *   Frame:  flags u8 | [result u8, nur mit CAN_TRACE_ERR] | Zeitdelta us varint |
+ *           ID varint | Daten (Länge aus flags, keine bei RTR)
+ * varint: LEB128, 7 Bit je Byte, niederwertige zuerst. Das Zeitdelta bezieht sich auf
+ * den vorigen Frame im Block, der erste auf die Startzeit. Ein typischer VESC-Frame
+ * braucht 9..13 Bytes statt 20.
+ */
+class CanTrace {
+public:
+    static const size_t RING_SIZE = 256;
+    static const uint32_t FLUSH_MS = 500;
+    static const size_t PAGE_BYTES = 4096;      // ein Flash-Sektor
+    static const size_t MAX_FILE_BYTES = 256 * 1024;
+    static const char* const FILE_PATH;
+    static const char* const OLD_FILE_PATH;
+
+    CanTrace(fs::FS& storage);
+    ~CanTrace();
+
+    /** @brief Startet den Schreib-Task; LittleFS muss gemountet sein */
+    void begin();
+
+    /** @brief Aufzeichnung an/aus (Standard: an); ausgeschaltet kostet recordTx nur den Test */
+    void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Nur aus dem CAN-Sendetask bzw. Empfangstask
+    void recordTx(const twai_message_t& msg, esp_err_t err) {
+        uint8_t result = 0;
+        if (err != ESP_OK) {
+            result = err == ESP_ERR_TIMEOUT ? CAN_TRACE_TIMEOUT
+                   : err == ESP_ERR_INVALID_STATE ? CAN_TRACE_INVALID_STATE : CAN_TRACE_FAIL;
+        }
+        record(txRing, txLost, msg, CAN_TRACE_TX, result);
+    }
+    void recordRx(const twai_message_t& msg) {
+        record(rxRing, rxLost, msg, 0, 0);
+    }
+
+    /** @brief Ringe sofort leeren und die angefangene Seite schreiben, auch wenn sie nicht voll ist */
+    void requestFlush();
+    /** @brief Beide Dateien löschen (im Schreib-Task, vor dem nächsten Block) */
+    void clear();
+
+    struct Stats {
+        uint32_t frames;            // in Seiten übernommen
+        uint32_t lost;              // Ring voll
+        uint32_t blocks;
+        uint32_t pages;             // geschrieben
+        uint32_t partialPages;      // davon vorzeitig durch requestFlush() oder Dateiwechsel
+        uint32_t frameBytes;        // kodierte Frames in geschriebenen Seiten
+        uint32_t bytes;             // an das Dateisystem übergeben
+        uint32_t fileBytes;         // aktuelle Größe von FILE_PATH
+        uint32_t writeErrors;
+        float writeAmplification;   // übergeben / kodiert: Dateikopf, Blockköpfe, vorzeitige Seiten
+    };
+    Stats stats() const;
+
+    /** @brief Kodiert einen Frame wie in der Datei; out braucht mindestens 24 Bytes */
+    static size_t encodeEntry(const CanTraceEntry& e, uint32_t deltaUs, uint8_t* out);
+
+private:
+    fs::FS& storage;
+    std::atomic<bool> enabled{true};
+
+    SpscRing<CanTraceEntry, RING_SIZE> txRing;
+    SpscRing<CanTraceEntry, RING_SIZE> rxRing;
+    std::atomic<uint32_t> txLost{0};
+    std::atomic<uint32_t> rxLost{0};
+
+    inline void record(SpscRing<CanTraceEntry, RING_SIZE>& ring, std::atomic<uint32_t>& lost,
+                       const twai_message_t& msg, uint8_t dir, uint8_t result) {
+        if (!enabled.load(std::memory_order_relaxed)) return;
+        CanTraceEntry e;
+        e.us = (uint32_t)esp_timer_get_time();
+        e.id = msg.identifier;
+        uint8_t len = msg.data_length_code <= 8 ? msg.data_length_code : 8;
+        e.flags = dir | (msg.extd ? CAN_TRACE_EXT : 0) | (msg.rtr ? CAN_TRACE_RTR : 0)
+                | (result ? CAN_TRACE_ERR : 0) | len;
+        e.result = result;
+        memcpy(e.data, msg.data, 8);
+        if (!ring.push(e)) {
+            lost.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // halb voll: Schreib-Task nicht erst nach FLUSH_MS wecken
+        if (ring.size() == RING_SIZE / 2 && taskHandle) xTaskNotifyGive(taskHandle);
+    }
+
+    // nur im Schreib-Task; die Seite endet dort, wo die Datei eine PAGE_BYTES-Grenze erreicht
+    CanTraceEntry txBatch[RING_SIZE];
+    CanTraceEntry rxBatch[RING_SIZE];
+    uint8_t page[PAGE_BYTES];
+    size_t pageLen = 0;
+    size_t pageFrameBytes = 0;
+    int64_t lastUs = 0;              // 64-Bit-Zeit des zuletzt übernommenen Frames
+    uint32_t lostReported = 0;
+
+    std::atomic<bool> flushPending{false};
+    std::atomic<bool> clearPending{false};
+    std::atomic<uint32_t> frameCount{0}, blockCount{0}, pageCount{0}, partialCount{0};
+    std::atomic<uint32_t> frameByteCount{0}, byteCount{0}, fileSize{0}, errorCount{0};
+    TaskHandle_t taskHandle = nullptr;
+
+    static void taskWrapper(void* param);
+    void writerTask();
+    void flush();
+    void stage(const uint8_t* data, size_t len, bool frame);
+    void writePage();
+};
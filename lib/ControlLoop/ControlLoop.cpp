@@ -0,0 +1,77 @@
+#include "ControlLoop.h"
+#include "TaskPlacement.h"
+
+ControlLoop::ControlLoop(Joystick& js, VescCan& vesc, uint8_t controller_id, MapFunction map)
+    : js(js), vesc(vesc), controllerId(controller_id), map(map) {}
+
+ControlLoop::~ControlLoop() {
+    if (taskHandle) {
+        js.setNotifyTask(nullptr);
+        vTaskDelete(taskHandle);
+        taskHandle = nullptr;
+    }
+}
+
+void ControlLoop::begin(int min_refresh_ms) {
+    if (taskHandle) return;
+    setMinRefresh(min_refresh_ms);
+
+    // über dem Joystick-Task und dem Sendetask (TaskPlacement.h): eine neue Messung
+    // verdrängt den Leser sofort, der fertige Frame danach sofort den Regeltask
+    startTask(taskWrapper, TASK_CONTROL, this, &taskHandle);
+    js.setNotifyTask(taskHandle);
+}
+
+void ControlLoop::setMinRefresh(int min_refresh_ms) {
+    minRefreshMs.store(min_refresh_ms > 0 ? min_refresh_ms : 1, std::memory_order_relaxed);
+}
+
+void ControlLoop::resetTrace() {
+    for (LatencyHistogram& h : stageTrace) h.reset();
+}
+
+void ControlLoop::setTracing(bool on) {
+    tracing.store(on, std::memory_order_relaxed);
+    vesc.setTracing(on);
+}
+
+void ControlLoop::taskWrapper(void* param) {
+    static_cast<ControlLoop*>(param)->controlTask();
+}
+
+void ControlLoop::controlTask() {
+    while (true) {
+        TickType_t timeout = pdMS_TO_TICKS(minRefreshMs.load(std::memory_order_relaxed));
+        bool fresh = ulTaskNotifyTake(pdTRUE, timeout > 0 ? timeout : 1) > 0;
+
+        if (!enabled.load(std::memory_order_relaxed)) continue;
+        JoystickSnapshot s = js.getSnapshot();
+        if (!s.calibrated) continue;   // noch nicht kalibriert
+
+        (fresh ? sampleWakes : refreshWakes).fetch_add(1, std::memory_order_relaxed);
+
+        // keine neue Messung seit dem letzten Durchlauf: nur wiederholen, nicht auffrischen
+        if (s.samples == lastSamples) {
+            vesc.sendSetpoint(controllerId);
+            continue;
+        }
+        lastSamples = s.samples;
+
+        // nur Durchläufe zu einer frischen Messung gehen in die Latenzstatistik ein
+        bool traced = fresh && tracing.load(std::memory_order_relaxed);
+        uint32_t wakeUs = traced ? (uint32_t)esp_timer_get_time() : 0;
+
+        int32_t rpm = map(s.value);
+        uint32_t mappedUs = traced ? (uint32_t)esp_timer_get_time() : 0;
+
+        vesc.setRpm(controllerId, rpm);
+        vesc.sendSetpoint(controllerId, traced ? s.timeUs : 0);
+
+        if (traced) {
+            uint32_t queuedUs = (uint32_t)esp_timer_get_time();
+            stageTrace[STAGE_WAKE].record(wakeUs - s.timeUs);
+            stageTrace[STAGE_MAP].record(mappedUs - wakeUs);
+            stageTrace[STAGE_ENQUEUE].record(queuedUs - mappedUs);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+#include "Joystick.h"
+#include "LatencyHistogram.h"
+#include "VescCan.h"
+
+/**
+ * @brief Ereignisgesteuerter Pfad Joystick -> Drehzahl -> CAN
+ *
+ * Der Joystick-Task weckt den Regeltask nach jeder gefilterten Messung; dieser rechnet
+ * den Wert sofort in eine Drehzahl um, trägt sie in die Sollwerttabelle ein und stößt
+ * den Versand an. Kommt länger als die Mindest-Auffrischperiode keine Messung, wird der
+ * letzte Sollwert trotzdem erneut gesendet, aber nicht neu eingetragen: steht der
+ * Joystick-Task, läuft so die Totmannschaltung von VescCan (setFailsafe) ab.
+ */
+class ControlLoop {
+public:
+    /** Abbildung normierter Joystick-Wert (Q15) -> Drehzahl */
+    typedef int32_t (*MapFunction)(q15_t value);
+
+    ControlLoop(Joystick& js, VescCan& vesc, uint8_t controller_id, MapFunction map);
+    ~ControlLoop();
+
+    /**
+     * @brief Startet den Regeltask und meldet ihn beim Joystick an
+     * @param min_refresh_ms spätestens nach dieser Zeit wird erneut gesendet
+     */
+    void begin(int min_refresh_ms = 100);
+
+    /** @brief Ändert die Mindest-Auffrischperiode zur Laufzeit */
+    void setMinRefresh(int min_refresh_ms);
+
+    /** @brief Aus: der Joystick schreibt keine Sollwerte mehr, z. B. solange der PC steuert */
+    void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    /** @brief Anzahl Durchläufe, ausgelöst durch eine neue Messung bzw. durch Zeitablauf */
+    uint32_t sampleWakeups() const { return sampleWakes.load(std::memory_order_relaxed); }
+    uint32_t refreshWakeups() const { return refreshWakes.load(std::memory_order_relaxed); }
+
+    // Latenzverfolgung im Regeltask, nur für Durchläufe nach einer neuen Messung
+    enum Stage {
+        STAGE_WAKE,           // Messung veröffentlicht -> Regeltask läuft
+        STAGE_MAP,            // Abbildung Wert -> Drehzahl
+        STAGE_ENQUEUE,        // Sollwert eintragen und einreihen
+        STAGES
+    };
+    const LatencyHistogram& trace(Stage stage) const { return stageTrace[stage]; }
+    void resetTrace();
+    /** @brief Schaltet die Zeitstempel hier und im Sendepfad von VescCan ein oder aus */
+    void setTracing(bool on);
+
+private:
+    Joystick& js;
+    VescCan& vesc;
+    uint8_t controllerId;
+    MapFunction map;
+
+    std::atomic<int> minRefreshMs{100};
+    std::atomic<bool> enabled{true};
+    std::atomic<uint32_t> sampleWakes{0};
+    std::atomic<uint32_t> refreshWakes{0};
+
+    std::atomic<bool> tracing{true};
+    LatencyHistogram stageTrace[STAGES];   // nur der Regeltask schreibt
+
+    uint32_t lastSamples = 0;              // nur der Regeltask
+    TaskHandle_t taskHandle = nullptr;
+    static void taskWrapper(void* param);
+    void controlTask();
+};
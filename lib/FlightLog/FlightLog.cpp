@@ -0,0 +1,225 @@
+#include "FlightLog.h"
+#include "TaskPlacement.h"
+
+const char* const FlightLog::FILE_PATH = "/flight.bin";
+const char* const FlightLog::OLD_FILE_PATH = "/flight.1.bin";
+
+static const uint8_t PAGE_MAGIC[4] = {'F', 'L', 'G', '1'};
+static const size_t PAGE_HEADER_BYTES = 12;
+static const uint8_t RECORD_MARK = 0x80;
+// Rohgröße eines Takts bei naivem Schreiben: Zeitstempel u32 und Felder ohne Füllbytes
+static const size_t RAW_RECORD_BYTES = 4 + 17;
+
+static size_t putVarint(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static size_t putDelta(uint8_t* out, int32_t cur, int32_t prev) {
+    int32_t d = (int32_t)((uint32_t)cur - (uint32_t)prev);
+    return putVarint(out, ((uint32_t)d << 1) ^ (uint32_t)(d >> 31));
+}
+
+FlightLog::FlightLog(fs::FS& storage, SampleFunction sample) : storage(storage), sample(sample) {
+    memset(&prev, 0, sizeof(prev));
+}
+
+FlightLog::~FlightLog() {
+    if (sampleTaskHandle) {
+        vTaskDelete(sampleTaskHandle);
+        sampleTaskHandle = nullptr;
+    }
+    if (writerTaskHandle) {
+        vTaskDelete(writerTaskHandle);
+        writerTaskHandle = nullptr;
+    }
+}
+
+void FlightLog::begin(int rate_hz) {
+    if (sampleTaskHandle) return;
+    setRate(rate_hz);
+    fs::File f = storage.open(FILE_PATH, FILE_READ);
+    fileSize.store(f ? (uint32_t)f.size() : 0, std::memory_order_relaxed);
+    f.close();
+    beginMs = millis();
+    // Schreiben mit niedrigster Priorität: ein Sektor braucht auf dem Flash einige ms
+    startTask(writerTaskWrapper, TASK_FLIGHT_LOG_WRITER, this, &writerTaskHandle);
+    startTask(sampleTaskWrapper, TASK_FLIGHT_LOG, this, &sampleTaskHandle);
+}
+
+void FlightLog::setRate(int rate_hz) {
+    if (rate_hz < 1) rate_hz = 1;
+    if (rate_hz > 200) rate_hz = 200;
+    rateHz.store(rate_hz, std::memory_order_relaxed);
+}
+
+void FlightLog::requestFlush() {
+    flushPending.store(true, std::memory_order_relaxed);
+}
+
+void FlightLog::clear() {
+    clearPending.store(true, std::memory_order_relaxed);
+    if (writerTaskHandle) xTaskNotifyGive(writerTaskHandle);
+}
+
+FlightLog::Stats FlightLog::stats() const {
+    Stats st;
+    st.records = recordCount.load(std::memory_order_relaxed);
+    st.lost = lostCount.load(std::memory_order_relaxed);
+    st.pages = pageCount.load(std::memory_order_relaxed);
+    st.partialPages = partialCount.load(std::memory_order_relaxed);
+    st.recordBytes = recordByteCount.load(std::memory_order_relaxed);
+    st.bytes = byteCount.load(std::memory_order_relaxed);
+    st.fileBytes = fileSize.load(std::memory_order_relaxed);
+    st.writeErrors = errorCount.load(std::memory_order_relaxed);
+    uint32_t ms = millis() - beginMs;
+    st.recordsPerSec = ms ? st.records * 1000.0f / ms : 0.0f;
+    // nur geschriebene Seiten: Datensätze in der angefangenen Seite zählen noch nicht
+    uint32_t written = writtenRecordCount.load(std::memory_order_relaxed);
+    st.compression = st.recordBytes ? (float)written * RAW_RECORD_BYTES / st.recordBytes : 0.0f;
+    st.writeAmplification = st.recordBytes ? (float)st.bytes / st.recordBytes : 0.0f;
+    return st;
+}
+
+size_t FlightLog::encodeRecord(const FlightLogRecord& rec, const FlightLogRecord& prev,
+                               uint32_t deltaUs, uint8_t* out) {
+    uint8_t mask = RECORD_MARK;
+    size_t n = 1;
+    n += putVarint(out + n, deltaUs);
+    const int32_t cur[6] = {rec.stick, rec.rpm, rec.erpm, rec.current, rec.duty, rec.vin};
+    const int32_t old[6] = {prev.stick, prev.rpm, prev.erpm, prev.current, prev.duty, prev.vin};
+    for (int i = 0; i < 6; i++) {
+        if (cur[i] == old[i]) continue;
+        mask |= 1 << i;
+        n += putDelta(out + n, cur[i], old[i]);
+    }
+    if (rec.flags != prev.flags) {
+        mask |= 1 << 6;
+        out[n++] = rec.flags;
+    }
+    out[0] = mask;
+    return n;
+}
+
+// --- Abtasttask ---
+
+void FlightLog::sampleTaskWrapper(void* param) {
+    static_cast<FlightLog*>(param)->sampleTask();
+}
+
+void FlightLog::sampleTask() {
+    TickType_t last = xTaskGetTickCount();
+    while (true) {
+        TickType_t period = pdMS_TO_TICKS(1000 / rateHz.load(std::memory_order_relaxed));
+        vTaskDelayUntil(&last, period ? period : 1);
+        if (enabled.load(std::memory_order_relaxed)) {
+            FlightLogRecord rec;
+            if (sample(rec)) append(rec, esp_timer_get_time());
+        }
+        if (flushPending.exchange(false, std::memory_order_relaxed) && curLen > 0) closePage(false);
+    }
+}
+
+void FlightLog::append(const FlightLogRecord& rec, int64_t now) {
+    if (curLen == 0 && !startPage(now)) {
+        lostCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    uint8_t buf[MAX_RECORD_BYTES];
+    size_t n = encodeRecord(rec, prev, (uint32_t)(now - prevUs), buf);
+    if (curLen + n > PAGE_BYTES) {
+        closePage(true);
+        if (!startPage(now)) {
+            lostCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        n = encodeRecord(rec, prev, 0, buf);
+    }
+    memcpy(pages[filledPages.load(std::memory_order_relaxed) % PAGE_COUNT] + curLen, buf, n);
+    curLen += n;
+    curRecordBytes += n;
+    curRecords++;
+    prev = rec;
+    prevUs = now;
+    recordCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool FlightLog::startPage(int64_t now) {
+    uint32_t filled = filledPages.load(std::memory_order_relaxed);
+    if (filled - writtenPages.load(std::memory_order_acquire) >= (uint32_t)PAGE_COUNT) return false;
+    uint8_t* page = pages[filled % PAGE_COUNT];
+    memcpy(page, PAGE_MAGIC, sizeof(PAGE_MAGIC));
+    for (int i = 0; i < 8; i++) page[4 + i] = (uint8_t)((uint64_t)now >> (8 * i));
+    curLen = PAGE_HEADER_BYTES;
+    curRecordBytes = 0;
+    curRecords = 0;
+    memset(&prev, 0, sizeof(prev));
+    prevUs = now;
+    return true;
+}
+
+void FlightLog::closePage(bool full) {
+    uint32_t filled = filledPages.load(std::memory_order_relaxed);
+    uint32_t index = filled % PAGE_COUNT;
+    if (full) {
+        memset(pages[index] + curLen, 0, PAGE_BYTES - curLen);
+        curLen = PAGE_BYTES;
+    }
+    pageLen[index] = (uint16_t)curLen;
+    pageRecordBytes[index] = (uint16_t)curRecordBytes;
+    pageRecords[index] = (uint16_t)curRecords;
+    filledPages.store(filled + 1, std::memory_order_release);
+    curLen = 0;
+    if (writerTaskHandle) xTaskNotifyGive(writerTaskHandle);
+}
+
+// --- Schreibtask ---
+
+void FlightLog::writerTaskWrapper(void* param) {
+    static_cast<FlightLog*>(param)->writerTask();
+}
+
+void FlightLog::writerTask() {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (clearPending.exchange(false, std::memory_order_relaxed)) {
+            storage.remove(OLD_FILE_PATH);
+            storage.remove(FILE_PATH);
+            fileSize.store(0, std::memory_order_relaxed);
+        }
+        uint32_t written = writtenPages.load(std::memory_order_relaxed);
+        while (written != filledPages.load(std::memory_order_acquire)) {
+            writePage(written % PAGE_COUNT);
+            writtenPages.store(++written, std::memory_order_release);
+        }
+    }
+}
+
+void FlightLog::writePage(uint32_t index) {
+    size_t len = pageLen[index];
+    uint32_t size = fileSize.load(std::memory_order_relaxed);
+    if (size + len > MAX_FILE_BYTES) {
+        storage.remove(OLD_FILE_PATH);
+        storage.rename(FILE_PATH, OLD_FILE_PATH);
+        size = 0;
+    }
+    fs::File file = storage.open(FILE_PATH, FILE_APPEND);
+    if (!file) {
+        errorCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    size_t n = file.write(pages[index], len);
+    file.close();
+    if (n != len) errorCount.fetch_add(1, std::memory_order_relaxed);
+    fileSize.store(size + n, std::memory_order_relaxed);
+    byteCount.fetch_add(n, std::memory_order_relaxed);
+    recordByteCount.fetch_add(pageRecordBytes[index], std::memory_order_relaxed);
+    writtenRecordCount.fetch_add(pageRecords[index], std::memory_order_relaxed);
+    pageCount.fetch_add(1, std::memory_order_relaxed);
+    if (len < PAGE_BYTES) partialCount.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include <esp_timer.h>
+#include <atomic>
+
+/** @brief Ein Takt des Flugschreibers, ganzzahlig wie auf dem Bus */
+struct FlightLogRecord {
+    int16_t stick;          // Joystick Q15 (-32767..32767)
+    int32_t rpm;            // kommandierte Drehzahl (eRPM)
+    int32_t erpm;           // Rückmeldung des Controllers
+    int16_t current;        // 0,1 A
+    int16_t duty;           // 0,001
+    int16_t vin;            // 0,1 V
+    uint8_t flags;          // FLIGHT_LOG_*
+};
+
+enum : uint8_t {
+    FLIGHT_LOG_CALIBRATED = 0x01,   // stick gültig
+    FLIGHT_LOG_SETPOINT = 0x02,     // rpm gültig
+    FLIGHT_LOG_STATUS = 0x04,       // erpm, current, duty, vin aus einem aktuellen STATUS
+    FLIGHT_LOG_HOST = 0x08,         // Sollwert kam vom PC, nicht vom Joystick
+};
+
+/**
+ * @brief Flugschreiber: Joystick, Sollwert und Rückmeldung mit 50..100 Hz nach LittleFS
+ *
+ * Ein Abtasttask holt je Takt einen Datensatz über die SampleFunction und kodiert ihn
+ * sofort in die aktuelle Seite im RAM; der Regelpfad und loop() berühren den Flash nie.
+ * Ist eine Seite voll, schreibt ein Task mit niedrigster Priorität sie in einem Stück
+ * ans Dateiende — je PAGE_BYTES ein einziger Schreibzugriff und damit ein einziger
+ * Metadaten-Commit von LittleFS statt einem je Datensatz. Sind alle PAGE_COUNT Seiten
+ * belegt, gehen Datensätze verloren und werden gezählt. Ab MAX_FILE_BYTES wird die
+ * Datei nach OLD_FILE_PATH verschoben; tools/flightlog2csv.py wandelt beide in CSV.
+ *
+ * Dateiformat: eine Folge von Seiten, jede für sich dekodierbar
+ *   Seite:     "FLG1" | Startzeit us u64 (little-endian) | Datensätze | 0x00-Füllung
+ *   Datensatz: Maske u8 (Bit 7 immer gesetzt) | Zeitdelta us varint |
+ *              je gesetztem Bit 0..6 die Änderung des Feldes
+ * Bit 0..5: stick, rpm, erpm, current, duty, vin als zigzag-varint der Differenz zum
+ * vorigen Datensatz, Bit 6: flags als Byte. Unveränderte Felder fehlen; der erste
+ * Datensatz einer Seite bezieht sich auf lauter Nullen und die Startzeit. Im Stand
+ * braucht ein Takt 3 Bytes, in Fahrt typisch 6..10 statt 21.
+ */
+class FlightLog {
+public:
+    /** Füllt einen Datensatz aus veröffentlichten Schnappschüssen; false = Takt auslassen */
+    typedef bool (*SampleFunction)(FlightLogRecord& rec);
+
+    static const size_t PAGE_BYTES = 4096;       // ein Flash-Sektor
+    static const int PAGE_COUNT = 3;
+    static const size_t MAX_RECORD_BYTES = 32;
+    static const size_t MAX_FILE_BYTES = 384 * 1024;
+    static const char* const FILE_PATH;
+    static const char* const OLD_FILE_PATH;
+
+    FlightLog(fs::FS& storage, SampleFunction sample);
+    ~FlightLog();
+
+    /** @brief Startet Abtast- und Schreibtask; LittleFS muss gemountet sein */
+    void begin(int rate_hz = 50);
+
+    /** @brief Abtastrate zur Laufzeit (1..200 Hz) */
+    void setRate(int rate_hz);
+    int rate() const { return rateHz.load(std::memory_order_relaxed); }
+
+    void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    /** @brief Schreibt die angefangene Seite beim nächsten Takt, auch wenn sie nicht voll ist */
+    void requestFlush();
+    /** @brief Beide Dateien löschen (im Schreibtask, vor der nächsten Seite) */
+    void clear();
+
+    struct Stats {
+        uint32_t records;           // in Seiten übernommen
+        uint32_t lost;              // keine freie Seite
+        uint32_t pages;             // geschrieben
+        uint32_t partialPages;      // davon vorzeitig durch requestFlush()
+        uint32_t recordBytes;       // kodierte Datensätze in geschriebenen Seiten
+        uint32_t bytes;             // an das Dateisystem übergeben
+        uint32_t fileBytes;         // aktuelle Größe von FILE_PATH
+        uint32_t writeErrors;
+        float recordsPerSec;        // seit begin()
+        float compression;          // Rohgröße (Zeit und Felder, 21 Bytes) / kodiert
+        float writeAmplification;   // übergeben / kodiert: Seitenkopf, Füllung, vorzeitige Seiten
+    };
+    Stats stats() const;
+
+    /**
+     * @brief Kodiert einen Datensatz wie in der Datei
+     * @param prev voriger Datensatz der Seite bzw. lauter Nullen
+     * @param out mindestens MAX_RECORD_BYTES
+     */
+    static size_t encodeRecord(const FlightLogRecord& rec, const FlightLogRecord& prev,
+                               uint32_t deltaUs, uint8_t* out);
+
+private:
+    fs::FS& storage;
+    SampleFunction sample;
+    std::atomic<bool> enabled{true};
+    std::atomic<int> rateHz{50};
+    uint32_t beginMs = 0;
+
+    // Seiten: der Abtasttask füllt filledPages % PAGE_COUNT, der Schreibtask leert
+    // writtenPages % PAGE_COUNT; beide Zähler wachsen nur
+    uint8_t pages[PAGE_COUNT][PAGE_BYTES];
+    uint16_t pageLen[PAGE_COUNT];
+    uint16_t pageRecordBytes[PAGE_COUNT];
+    uint16_t pageRecords[PAGE_COUNT];
+    std::atomic<uint32_t> filledPages{0};
+    std::atomic<uint32_t> writtenPages{0};
+
+    // nur im Abtasttask
+    size_t curLen = 0;               // 0 = keine Seite angefangen
+    size_t curRecordBytes = 0;
+    uint32_t curRecords = 0;
+    FlightLogRecord prev;
+    int64_t prevUs = 0;
+
+    std::atomic<bool> flushPending{false};
+    std::atomic<bool> clearPending{false};
+    std::atomic<uint32_t> recordCount{0}, lostCount{0}, pageCount{0}, partialCount{0};
+    std::atomic<uint32_t> recordByteCount{0}, writtenRecordCount{0};
+    std::atomic<uint32_t> byteCount{0}, fileSize{0}, errorCount{0};
+    TaskHandle_t sampleTaskHandle = nullptr;
+    TaskHandle_t writerTaskHandle = nullptr;
+
+    static void sampleTaskWrapper(void* param);
+    static void writerTaskWrapper(void* param);
+    void sampleTask();
+    void writerTask();
+    void append(const FlightLogRecord& rec, int64_t now);
+    bool startPage(int64_t now);
+    void closePage(bool full);
+    void writePage(uint32_t index);
+};
@@ -0,0 +1,234 @@
+#include "AdcSampler.h"
+
+#if JOYSTICK_CONTINUOUS_ADC == 5
+#include <esp_adc/adc_continuous.h>
+#elif JOYSTICK_CONTINUOUS_ADC == 4
+#include <driver/adc.h>
+#endif
+
+static uint8_t copyPins(int* dst, const int* pins, uint8_t count) {
+    if (count > ADC_MAX_CHANNELS) count = ADC_MAX_CHANNELS;
+    for (uint8_t i = 0; i < count; i++) dst[i] = pins[i];
+    return count;
+}
+
+// --- analogRead ---
+PollingAdc::PollingAdc(const int* pins, uint8_t count, uint32_t periodMs)
+    : count(copyPins(this->pins, pins, count)), periodMs(periodMs) {}
+
+bool PollingAdc::begin() {
+    analogReadResolution(12);
+    analogSetAttenuation(ADC_11db);
+    return true;
+}
+
+bool PollingAdc::read(uint16_t* raw) {
+    vTaskDelay(periodMs / portTICK_PERIOD_MS);
+    for (uint8_t i = 0; i < count; i++) raw[i] = (uint16_t)(analogRead(pins[i]) << ADC_FRACTION_BITS);
+    return true;
+}
+
+// --- kontinuierlich per DMA ---
+ContinuousAdc::ContinuousAdc(const int* pins, uint8_t count, uint32_t sampleRateHz, uint16_t oversample)
+    : count(copyPins(this->pins, pins, count)), sampleRateHz(sampleRateHz), oversample(oversample) {}
+
+#if JOYSTICK_CONTINUOUS_ADC
+
+// Mittelt die Wandlungen eines Frames je Pin; die Kanalnummer steht in jedem Ergebnis
+bool ContinuousAdc::average(uint32_t len, uint16_t* raw) const {
+    uint32_t sum[ADC_MAX_CHANNELS] = {}, n[ADC_MAX_CHANNELS] = {};
+    for (uint32_t i = 0; i < len; i += RESULT_BYTES) {
+        const adc_digi_output_data_t* p = reinterpret_cast<const adc_digi_output_data_t*>(frame + i);
+        for (uint8_t c = 0; c < count; c++) {
+            if (p->type2.channel != channels[c]) continue;
+            sum[c] += p->type2.data;
+            n[c]++;
+            break;
+        }
+    }
+    for (uint8_t c = 0; c < count; c++) {
+        if (n[c] == 0) return false;
+        raw[c] = (uint16_t)(((sum[c] << ADC_FRACTION_BITS) + n[c] / 2) / n[c]);   // höchstens 256 × 4095 × 16 < 2^32
+    }
+    return true;
+}
+
+#endif
+
+#if JOYSTICK_CONTINUOUS_ADC == 5
+
+namespace {
+
+bool IRAM_ATTR onConvDone(adc_continuous_handle_t, const adc_continuous_evt_data_t*, void* user) {
+    return static_cast<ContinuousAdc*>(user)->frameReadyFromIsr();
+}
+
+}  // namespace
+
+bool IRAM_ATTR ContinuousAdc::frameReadyFromIsr() {
+    TaskHandle_t task = reader;
+    if (task == nullptr) return false;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(task, &woken);
+    return woken == pdTRUE;
+}
+
+ContinuousAdc::~ContinuousAdc() {
+    if (handle) {
+        adc_continuous_stop(handle);
+        adc_continuous_deinit(handle);
+    }
+}
+
+bool ContinuousAdc::begin() {
+    if (count == 0 || oversample == 0 || oversample * count > MAX_OVERSAMPLE) return false;
+
+    adc_digi_pattern_config_t pattern[ADC_MAX_CHANNELS] = {};
+    for (uint8_t i = 0; i < count; i++) {
+        adc_unit_t unit;
+        adc_channel_t ch;
+        if (adc_continuous_io_to_channel(pins[i], &unit, &ch) != ESP_OK || unit != ADC_UNIT_1) return false;
+        channels[i] = ch;
+        pattern[i].atten = ADC_ATTEN_DB_11;
+        pattern[i].channel = ch;
+        pattern[i].unit = ADC_UNIT_1;
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+
+    uint32_t frameBytes = oversample * count * RESULT_BYTES;
+    adc_continuous_handle_cfg_t handleCfg = {};
+    handleCfg.max_store_buf_size = frameBytes * 4;
+    handleCfg.conv_frame_size = frameBytes;
+    if (adc_continuous_new_handle(&handleCfg, &handle) != ESP_OK) return false;
+
+    adc_continuous_config_t cfg = {};
+    cfg.pattern_num = count;
+    cfg.adc_pattern = pattern;
+    cfg.sample_freq_hz = sampleRateHz;
+    cfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+
+    adc_continuous_evt_cbs_t cbs = {};
+    cbs.on_conv_done = onConvDone;
+
+    if (adc_continuous_config(handle, &cfg) != ESP_OK ||
+        adc_continuous_register_event_callbacks(handle, &cbs, this) != ESP_OK ||
+        adc_continuous_start(handle) != ESP_OK) {
+        adc_continuous_deinit(handle);
+        handle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool ContinuousAdc::read(uint16_t* raw) {
+    if (handle == nullptr) return false;
+    reader = xTaskGetCurrentTaskHandle();
+
+    // höchstens vier Perioden warten, dann meldet sich der Aufrufer mit einem Fehler
+    TickType_t timeout = pdMS_TO_TICKS(periodUs() * 4 / 1000) + 1;
+    if (ulTaskNotifyTake(pdTRUE, timeout) == 0) return false;
+
+    // Alle fertigen Frames abholen; nur der jüngste zählt, ältere wären schon veraltet.
+    uint32_t frameBytes = oversample * count * RESULT_BYTES;
+    uint32_t len = 0;
+    bool got = false;
+    while (adc_continuous_read(handle, frame, frameBytes, &len, 0) == ESP_OK && len == frameBytes) {
+        if (got) dropped++;
+        got = true;
+    }
+    if (!got) return false;
+    return average(len, raw);
+}
+
+#elif JOYSTICK_CONTINUOUS_ADC == 4
+
+// Ohne Rückruf im Treiber: der Task schläft in adc_digi_read_bytes, bis der Interrupt
+// einen Frame in den Ringpuffer gelegt hat.
+bool ContinuousAdc::frameReadyFromIsr() { return false; }
+
+ContinuousAdc::~ContinuousAdc() {
+    if (running) {
+        adc_digi_stop();
+        adc_digi_deinitialize();
+    }
+}
+
+bool ContinuousAdc::begin() {
+    if (count == 0 || oversample == 0 || oversample * count > MAX_OVERSAMPLE) return false;
+
+    adc_digi_pattern_config_t pattern[ADC_MAX_CHANNELS] = {};
+    uint32_t mask = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        // Arduino zählt die Kanäle von ADC2 ab SOC_ADC_MAX_CHANNEL_NUM weiter
+        int8_t ch = digitalPinToAnalogChannel(pins[i]);
+        if (ch < 0 || ch >= SOC_ADC_MAX_CHANNEL_NUM) return false;
+        channels[i] = ch;
+        mask |= 1u << ch;
+        pattern[i].atten = ADC_ATTEN_DB_11;
+        pattern[i].channel = ch;
+        pattern[i].unit = 0;   // ADC1
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+
+    uint32_t frameBytes = oversample * count * RESULT_BYTES;
+    adc_digi_init_config_t initCfg = {};
+    initCfg.max_store_buf_size = frameBytes * 4;
+    initCfg.conv_num_each_intr = frameBytes;
+    initCfg.adc1_chan_mask = mask;
+    if (adc_digi_initialize(&initCfg) != ESP_OK) return false;
+
+    adc_digi_configuration_t cfg = {};
+    cfg.pattern_num = count;
+    cfg.adc_pattern = pattern;
+    cfg.sample_freq_hz = sampleRateHz;
+    cfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+
+    if (adc_digi_controller_configure(&cfg) != ESP_OK || adc_digi_start() != ESP_OK) {
+        adc_digi_deinitialize();
+        return false;
+    }
+    running = true;
+    return true;
+}
+
+bool ContinuousAdc::read(uint16_t* raw) {
+    if (!running) return false;
+
+    // Der Ringpuffer gibt am Umlauf auch Teilstücke heraus: lesen, bis der Frame voll ist.
+    // Der erste Frame wird abgewartet (höchstens vier Perioden), weitere nur abgeholt,
+    // wenn sie schon anstehen; nur der jüngste zählt.
+    uint32_t frameBytes = oversample * count * RESULT_BYTES;
+    uint32_t timeoutMs = periodUs() * 4 / 1000 + 1;
+    bool got = false;
+    while (true) {
+        uint32_t have = 0;
+        while (have < frameBytes) {
+            uint32_t len = 0;
+            uint32_t wait = got && have == 0 ? 0 : timeoutMs;
+            esp_err_t err = adc_digi_read_bytes(frame + have, frameBytes - have, &len, wait);
+            if (err == ESP_ERR_INVALID_STATE) dropped++;   // Ringpuffer übergelaufen, gelesene Daten gelten
+            else if (err != ESP_OK) len = 0;
+            if (len == 0) break;
+            have += len;
+        }
+        if (have == frameBytes) {
+            if (got) dropped++;
+            got = true;
+            continue;
+        }
+        if (have > 0 || !got) return false;   // halber Frame: der Rest kam nicht rechtzeitig
+        break;
+    }
+    return average(frameBytes, raw);
+}
+
+#else
+
+bool ContinuousAdc::frameReadyFromIsr() { return false; }
+ContinuousAdc::~ContinuousAdc() {}
+bool ContinuousAdc::begin() { return false; }
+bool ContinuousAdc::read(uint16_t*) { return false; }
+
+#endif
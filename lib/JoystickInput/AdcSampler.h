@@ -0,0 +1,129 @@
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include <Arduino.h>
+
+// Kontinuierlicher ADC-Treiber (DMA): ab ESP-IDF 5 (Arduino-Core 3.x) esp_adc/adc_continuous,
+// in ESP-IDF 4.4 (Arduino-Core 2.x, platform = espressif32) adc_digi_* aus driver/adc.h.
+// Der Wert ist die Hauptversion der verwendeten API, 0 = keiner (Host).
+#if defined(ESP_PLATFORM)
+#include <esp_idf_version.h>
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+#define JOYSTICK_CONTINUOUS_ADC 5
+#elif ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 4, 0)
+#define JOYSTICK_CONTINUOUS_ADC 4
+#endif
+#endif
+#ifndef JOYSTICK_CONTINUOUS_ADC
+#define JOYSTICK_CONTINUOUS_ADC 0
+#endif
+
+/**
+ * @brief Einheit der Rohwerte im ganzen Eingangspfad: 12-Bit-Zählwert mit 4 Nachkommabits
+ *
+ * analogRead liefert ganze Zählwerte (× 16), die Überabtastung im DMA-Betrieb behält
+ * ihre zusätzliche Auflösung. Volt gibt es erst für die Anzeige.
+ */
+static const int ADC_FRACTION_BITS = 4;
+static const uint16_t ADC_FULL_SCALE = 4095 << ADC_FRACTION_BITS;   // 65520
+/** @brief Höchstzahl Pins, die ein Sampler in einem Durchgang wandelt */
+static const uint8_t ADC_MAX_CHANNELS = 4;
+
+/**
+ * @brief Quelle der Rohwerte für den Joystick-Task
+ *
+ * Wandelt einen oder mehrere Pins (höchstens ADC_MAX_CHANNELS) in einem gemeinsamen
+ * Durchgang. read() blockiert den aufrufenden Task, bis die nächsten (ggf. dezimierten)
+ * Werte aller Pins bereitstehen.
+ */
+class AdcSampler {
+public:
+    virtual ~AdcSampler() {}
+
+    /** @brief Startet die Wandlung; false, wenn das Backend nicht verfügbar ist */
+    virtual bool begin() = 0;
+
+    /**
+     * @brief Wartet auf die nächsten Werte
+     * @param raw je Pin ein Rohwert 0..ADC_FULL_SCALE in der Reihenfolge der Pins,
+     *            bei Überabtastung der gerundete Mittelwert
+     * @return false bei Zeitüberschreitung oder Fehler
+     */
+    virtual bool read(uint16_t* raw) = 0;
+
+    /** @brief Abstand zweier gelieferter Durchgänge in Mikrosekunden */
+    virtual uint32_t periodUs() const = 0;
+
+    virtual const char* name() const = 0;
+};
+
+/** @brief Bisheriger Weg: je Periode ein blockierendes analogRead pro Pin */
+class PollingAdc : public AdcSampler {
+public:
+    PollingAdc(const int* pins, uint8_t count, uint32_t periodMs);
+
+    bool begin() override;
+    bool read(uint16_t* raw) override;
+    uint32_t periodUs() const override { return periodMs * 1000; }
+    const char* name() const override { return "analogRead"; }
+
+private:
+    int pins[ADC_MAX_CHANNELS];
+    uint8_t count;
+    uint32_t periodMs;
+};
+
+/**
+ * @brief Kontinuierliche Wandlung per DMA mit Überabtastung
+ *
+ * Das Muster des Treibers enthält jeden Pin einmal, der ADC wandelt sie reihum. Ein
+ * DMA-Frame enthält genau oversample Wandlungen je Pin. Der Treiber meldet jeden
+ * vollen Frame per Interrupt; erst dann wird der lesende Task geweckt und mittelt
+ * den Frame je Pin zu einem Wert. Unter ESP-IDF 4.4 weckt der Ringpuffer des
+ * adc_digi-Treibers den Task, der Treiber ist dort einmalig im System. Ohne
+ * kontinuierlichen Treiber liefert begin() false.
+ */
+class ContinuousAdc : public AdcSampler {
+public:
+    /**
+     * @param pins ADC1-Pins
+     * @param sampleRateHz Wandlungen pro Sekunde, alle Pins zusammen
+     * @param oversample Wandlungen je Pin und geliefertem Wert (zusammen max. MAX_OVERSAMPLE)
+     */
+    ContinuousAdc(const int* pins, uint8_t count, uint32_t sampleRateHz, uint16_t oversample);
+    ~ContinuousAdc() override;
+
+    static const uint16_t MAX_OVERSAMPLE = 256;
+
+    bool begin() override;
+    bool read(uint16_t* raw) override;
+    uint32_t periodUs() const override {
+        return (uint32_t)((uint64_t)oversample * count * 1000000 / sampleRateHz);
+    }
+    const char* name() const override { return "adc_continuous"; }
+
+    /** @brief Frames, die verworfen wurden, weil der Task zu spät kam */
+    uint32_t droppedFrames() const { return dropped; }
+
+    /** @brief Aus dem Treiber-Interrupt: ein Frame ist voll; true, wenn ein Task geweckt wurde */
+    bool frameReadyFromIsr();
+
+private:
+    int pins[ADC_MAX_CHANNELS];
+    uint8_t count;
+    uint32_t sampleRateHz;
+    uint16_t oversample;
+    uint8_t channels[ADC_MAX_CHANNELS] = {};
+
+    struct adc_continuous_ctx_t* handle = nullptr;   // ESP-IDF 5
+    bool running = false;                             // ESP-IDF 4.4
+    volatile TaskHandle_t reader = nullptr;
+    uint32_t dropped = 0;
+
+    static const size_t RESULT_BYTES = 4;   // Ausgabeformat TYPE2 des ESP32-S3
+    uint8_t frame[MAX_OVERSAMPLE * RESULT_BYTES];
+
+    bool average(uint32_t len, uint16_t* raw) const;
+};
+
+#endif
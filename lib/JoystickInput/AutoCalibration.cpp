@@ -0,0 +1,170 @@
+#include <math.h>
+#include <stdlib.h>
+
+#include "AutoCalibration.h"
+
+// Ruhelage höchstens über so viele Messungen mitteln (64 Blöcke, 20 s bei 200 Werten/s),
+// damit Mitte und Rauschen auch bei stundenlanger Ruhe der Drift folgen
+static const uint32_t MAX_REST_SAMPLES = 64 * AutoCalibration::BLOCK_SAMPLES;
+
+AutoCalibration::AutoCalibration(int32_t minSpan, int32_t quietMax, q15_t deadzone)
+    : minSpan(minSpan), quietVar((float)quietMax * quietMax), initialDeadzone(deadzone) {
+    reset();
+    savedCal = {-1, -1, -1};
+    savedDeadzone = deadzone;
+}
+
+void AutoCalibration::reset() {
+    dz = initialDeadzone;
+    st = {0, 0, 0.0f, 0.0f, 0.0f, -1, -1};
+    restN = 0;
+    restBlocks = 0;
+    restM2 = 0.0f;
+    noiseVar = 0.0f;
+    lowCandidate = highCandidate = -1;
+}
+
+bool AutoCalibration::addBlock(const AxisBlock& block, JoystickCalibration& cal) {
+    if (block.count == 0) return false;
+    st.blocks++;
+    if (st.lowest == -1 || block.minVal < st.lowest) st.lowest = block.minVal;
+    if (block.maxVal > st.highest) st.highest = block.maxVal;
+
+    // nur eine Kalibrierung von Hand wird verfeinert, nie eine angelegt oder ergänzt
+    bool changed = extendLimits(block, cal);
+
+    // Mittelwert und Abweichungsquadrate des Blocks; n·Σx² − (Σx)² ist ganzzahlig exakt
+    float n = (float)block.count;
+    float mean = block.sum / n;
+    uint64_t spread = (uint64_t)block.count * block.sumSquares - (uint64_t)block.sum * block.sum;
+    float m2 = (float)spread / n;
+
+    if (m2 > quietVar * n) {
+        restN = 0;
+        restBlocks = 0;
+        st.restSamples = 0;
+        return changed;
+    }
+
+    // ruhig; schließt der Block an die bisherige Ruhelage an?
+    if (restN > 0) {
+        float tolerance = fmaxf(sqrtf(quietVar), NOISE_SIGMAS * sqrtf(restM2 / restN));
+        if (fabsf(mean - st.restMean) > tolerance) restN = 0;
+    }
+    if (restN == 0) {
+        restBlocks = 0;
+        restM2 = 0.0f;
+        st.restMean = mean;
+    }
+    if (restN > MAX_REST_SAMPLES) {
+        restM2 *= (float)MAX_REST_SAMPLES / restN;
+        restN = MAX_REST_SAMPLES;
+    }
+
+    // Vereinigung zweier Teilmengen nach Chan: Mittelwert und M2 ohne Auslöschung
+    float total = restN + n;
+    float delta = mean - st.restMean;
+    st.restMean += delta * n / total;
+    restM2 += m2 + delta * delta * restN * n / total;
+    restN += block.count;
+    st.restSamples = restN;
+
+    bool started = restBlocks == REST_BLOCKS - 1;
+    if (restBlocks < REST_BLOCKS) restBlocks++;
+    if (restBlocks < REST_BLOCKS) return changed;
+    return followRest(cal, started) || changed;
+}
+
+// Zwei Blöcke in Folge jenseits der Endlage: der weniger extreme Wert wird die neue Endlage
+bool AutoCalibration::extendLimits(const AxisBlock& block, JoystickCalibration& cal) {
+    if (!isUsable(cal, minSpan)) {
+        lowCandidate = highCandidate = -1;
+        return false;
+    }
+    bool changed = false;
+
+    int32_t v = block.minVal;
+    if (v >= cal.minVal) {
+        lowCandidate = -1;
+    } else if (lowCandidate == -1) {
+        lowCandidate = v;
+    } else {
+        cal.minVal = v > lowCandidate ? v : lowCandidate;
+        lowCandidate = -1;
+        changed = true;
+    }
+
+    v = block.maxVal;
+    if (v <= cal.maxVal) {
+        highCandidate = -1;
+    } else if (highCandidate == -1) {
+        highCandidate = v;
+    } else {
+        cal.maxVal = v < highCandidate ? v : highCandidate;
+        highCandidate = -1;
+        changed = true;
+    }
+    return changed;
+}
+
+// Läuft für jeden Block einer erkannten Ruhelage; restStarted beim ersten
+bool AutoCalibration::followRest(JoystickCalibration& cal, bool restStarted) {
+    float var = restM2 / restN;
+    noiseVar = noiseVar > 0.0f ? noiseVar + (var - noiseVar) / 8 : var;
+    st.noise = sqrtf(noiseVar);
+    if (!isUsable(cal, minSpan)) return false;
+
+    bool changed = false;
+    float offset = st.restMean - cal.center;
+    float distance = fabsf(offset);
+
+    // Rückstellfehler einmal je Ruhelage; weiter als die größte Totzone hält jemand den Stick
+    if (restStarted && distance * Q15_ONE <= (float)MAX_DEADZONE * halfSpan(cal)) {
+        st.returnError = st.returnError > 0.0f ? st.returnError + (distance - st.returnError) / 4 : distance;
+    }
+
+    if (distance <= deadzoneCounts(cal)) {
+        int32_t step = (int32_t)(offset / (1 << CENTER_FOLLOW_SHIFT));
+        int32_t c = cal.center + step;
+        if (step != 0 && c - cal.minVal >= minSpan && cal.maxVal - c >= minSpan) {
+            cal.center = c;
+            changed = true;
+        }
+    }
+
+    float counts = NOISE_SIGMAS * st.noise + RETURN_MARGIN * st.returnError;
+    int32_t q = (int32_t)lrintf(counts * Q15_ONE / halfSpan(cal));
+    if (q < MIN_DEADZONE) q = MIN_DEADZONE;
+    if (q > MAX_DEADZONE) q = MAX_DEADZONE;
+    // Hysterese 1/8, damit die Generation der Kalibrierung nicht mit jedem Block wechselt
+    if (abs(q - dz) * 8 > dz) {
+        dz = (q15_t)q;
+        changed = true;
+    }
+    return changed;
+}
+
+int32_t AutoCalibration::halfSpan(const JoystickCalibration& cal) {
+    int32_t low = cal.center - cal.minVal;
+    int32_t high = cal.maxVal - cal.center;
+    return low < high ? low : high;
+}
+
+int32_t AutoCalibration::deadzoneCounts(const JoystickCalibration& cal) const {
+    return (int32_t)((int64_t)dz * halfSpan(cal) / Q15_ONE);
+}
+
+static bool moved(int32_t saved, int32_t now) {
+    if ((saved == -1) != (now == -1)) return true;
+    return abs(now - saved) > AutoCalibration::SAVE_THRESHOLD;
+}
+
+bool AutoCalibration::saveDue(const JoystickCalibration& cal) const {
+    return moved(savedCal.minVal, cal.minVal) || moved(savedCal.maxVal, cal.maxVal) ||
+           moved(savedCal.center, cal.center) || abs(dz - savedDeadzone) > MIN_DEADZONE / 2;
+}
+
+void AutoCalibration::saved(const JoystickCalibration& cal, q15_t deadzone) {
+    savedCal = cal;
+    savedDeadzone = deadzone;
+}
@@ -0,0 +1,143 @@
+#ifndef AUTO_CALIBRATION_H
+#define AUTO_CALIBRATION_H
+
+#include <stdint.h>
+
+#include "Q15.h"
+
+/**
+ * @brief Kalibrierwerte einer Achse als gefilterte ADC-Werte (Zählwert × 16)
+ *
+ * -1 = Schritt noch nicht erfolgt.
+ */
+struct JoystickCalibration {
+    int32_t minVal, maxVal, center;
+};
+
+/** @brief Summen über einen Block gefilterter Messungen, vom Reader-Task gesammelt */
+struct AxisBlock {
+    uint32_t count;
+    uint32_t sum;
+    uint64_t sumSquares;
+    uint16_t minVal, maxVal;
+};
+
+/**
+ * @brief Verfeinert Mitte, Endlagen und Totzone einer von Hand kalibrierten Achse
+ *
+ * Legt nie selbst eine Kalibrierung an: solange cal nicht isUsable() ist (alle drei
+ * Schritte von Hand, Endlagen mindestens minSpan von der Mitte), bleibt cal unverändert
+ * und es werden nur Ruhelage und Rauschen gemessen.
+ *
+ * Bekommt je Block (BLOCK_SAMPLES Messungen) Summe, Quadratsumme und Extremwerte der
+ * gefilterten Werte. Ruhige, aneinander anschließende Blöcke werden nach Welford
+ * (paarweise Vereinigung nach Chan) zu Mittelwert und Varianz der Ruhelage vereinigt.
+ * Nach REST_BLOCKS solchen Blöcken gilt die Ruhelage als erkannt:
+ * - liegt sie innerhalb der Totzone um die Mitte, folgt die Mitte ihr um
+ *   1/2^CENTER_FOLLOW_SHIFT je Block (Drift durch Temperatur), weiter außen hält jemand
+ *   den Stick fest;
+ * - Streuung und Abstand zur Mitte beim Zurückfedern bemessen die Totzone:
+ *   NOISE_SIGMAS · σ + RETURN_MARGIN · mittlerer Rückstellfehler, begrenzt auf
+ *   MIN_DEADZONE..MAX_DEADZONE, mit Hysterese.
+ * Endlagen werden nur erweitert, nie verkleinert: ein Wert jenseits der Endlage zählt
+ * erst, wenn ihn zwei Blöcke in Folge erreichen, übernommen wird der weniger extreme der
+ * beiden. Enger machen geht nur von Hand. Die Mitte folgt nur so weit, dass beide
+ * Endlagen mindestens minSpan entfernt bleiben.
+ *
+ * Gleitkomma nur hier, nicht im Reader-Task; ein Block kostet einige Mikrosekunden.
+ */
+class AutoCalibration {
+public:
+    static const uint32_t BLOCK_SAMPLES = 64;       ///< 0,32 s bei 200 Werten/s
+    static const uint8_t REST_BLOCKS = 8;           ///< 2,6 s ruhig = Ruhelage
+    static const uint8_t CENTER_FOLLOW_SHIFT = 4;
+    static const int NOISE_SIGMAS = 5;
+    static const int RETURN_MARGIN = 2;
+    static const q15_t MIN_DEADZONE = 328;          ///< 1 %
+    static const q15_t MAX_DEADZONE = 4915;         ///< 15 %
+    /** @brief Abweichung vom gesicherten Stand, ab der gesichert wird (1 % des Bereichs) */
+    static const int32_t SAVE_THRESHOLD = 655;
+
+    /** @brief Für Anzeige und Benchmarks */
+    struct Status {
+        uint32_t blocks;        ///< ausgewertete Blöcke
+        uint32_t restSamples;   ///< Messungen der aktuellen Ruhelage, 0 = Stick bewegt
+        float restMean;         ///< Mittelwert der Ruhelage, ADC-Einheiten
+        float noise;            ///< σ in Ruhe, ADC-Einheiten; 0 = noch nicht gemessen
+        float returnError;      ///< mittlerer Abstand der Ruhelagen zur Mitte, ADC-Einheiten
+        int32_t lowest;         ///< kleinster gesehener Wert, -1 = noch keiner
+        int32_t highest;        ///< größter gesehener Wert, -1 = noch keiner
+    };
+
+    /**
+     * @param minSpan Mindestabstand der Endlagen zur Mitte in ADC-Einheiten
+     * @param quietMax größte Standardabweichung eines Blocks, der noch als ruhig gilt
+     * @param deadzone Totzone, bis die erste Ruhelage gemessen ist
+     */
+    AutoCalibration(int32_t minSpan, int32_t quietMax, q15_t deadzone);
+    /** @brief Platzhalter für Felder je Achse; vor Gebrauch einen konfigurierten zuweisen */
+    AutoCalibration() : AutoCalibration(0, 0, 0) {}
+
+    /** @brief Vergisst alles Gelernte, die Totzone fällt auf den Startwert zurück */
+    void reset();
+
+    /**
+     * @brief Wertet einen Block aus und verfeinert cal, falls isUsable()
+     * @return true, wenn sich cal oder deadzone() geändert haben
+     */
+    bool addBlock(const AxisBlock& block, JoystickCalibration& cal);
+
+    q15_t deadzone() const { return dz; }
+    /** @brief Übernimmt eine früher gelernte Totzone, z. B. aus dem NVS */
+    void setDeadzone(q15_t deadzone) { dz = deadzone; }
+    const Status& status() const { return st; }
+
+    /**
+     * @brief true, wenn cal oder die Totzone so weit vom zuletzt gesicherten Stand
+     *        abweichen, dass sich Schreiben lohnt
+     */
+    bool saveDue(const JoystickCalibration& cal) const;
+    /** @brief Merkt sich den gesicherten Stand; auch nach Laden oder Kalibrierung von Hand */
+    void saved(const JoystickCalibration& cal, q15_t deadzone);
+
+    static bool isComplete(const JoystickCalibration& cal) {
+        return cal.minVal != -1 && cal.maxVal != -1 && cal.center != -1;
+    }
+
+    /**
+     * @brief Vollständig und beide Endlagen mindestens minSpan von der Mitte
+     *
+     * Nur dann gilt die Achse als kalibriert.
+     */
+    static bool isUsable(const JoystickCalibration& cal, int32_t minSpan) {
+        return isComplete(cal) && cal.center - cal.minVal >= minSpan &&
+               cal.maxVal - cal.center >= minSpan;
+    }
+
+private:
+    int32_t minSpan;
+    float quietVar;
+    q15_t initialDeadzone;
+    q15_t dz;
+    Status st;
+
+    // Ruhelage nach Welford: Anzahl, Mittelwert, Summe der Abweichungsquadrate
+    uint32_t restN;
+    uint8_t restBlocks;
+    float restM2;
+    float noiseVar;         // geglättet über Ruhelagen, 0 = noch keine
+
+    // Kandidaten jenseits der Endlagen aus dem Block davor, -1 = keiner
+    int32_t lowCandidate;
+    int32_t highCandidate;
+
+    JoystickCalibration savedCal;
+    q15_t savedDeadzone;
+
+    bool extendLimits(const AxisBlock& block, JoystickCalibration& cal);
+    bool followRest(JoystickCalibration& cal, bool restStarted);
+    int32_t deadzoneCounts(const JoystickCalibration& cal) const;
+    static int32_t halfSpan(const JoystickCalibration& cal);
+};
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef AXIS_FILTER_BANK_H
+#define AXIS_FILTER_BANK_H
+
+#include <stdint.h>
+
+#include "FilterChain.h"
+
+/**
+ * @brief Filterketten für N gemeinsam abgetastete Achsen, Zustand als Struktur aus Feldern
+ *
+ * Alle Achsen laufen im selben Takt, jede mit eigener FilterConfig (ein Gashebel darf
+ * träger sein als die Lenkung). Je Achse gibt es Fensterinhalte und -positionen,
+ * Gewichte und die Zustände von Mittelwert, IIR und Kalman; die Fenster liegen Achse
+ * neben Achse, ein Durchgang schreibt also zusammenhängend. Die Fensterinhalte sind
+ * ADC-Werte und passen in 16 Bit.
+ *
+ * Stufen in fester Reihenfolge (siehe FilterConfig), gerechnet mit den Festkomma-Schritten
+ * aus FilterChain. Jede Achse liefert bitgleich dasselbe wie eine AxisFilterBank<1> mit
+ * ihrer Einstellung; jede Stufe kostet pro Messung konstante Zeit, kein Heap.
+ */
+template <int N>
+class AxisFilterBank {
+public:
+    static const int AXES = N;
+
+    explicit AxisFilterBank(const FilterConfig& config = FilterConfig()) {
+        for (int a = 0; a < N; a++) configure(a, config);
+    }
+
+    /**
+     * @brief Übernimmt neue Einstellungen einer Achse und setzt nur diese zurück
+     * @return false, wenn Werte außerhalb der Grenzen lagen (sie werden begrenzt)
+     */
+    bool configure(int axis, const FilterConfig& config) {
+        FilterConfig& c = cfg[axis];
+        c = config;
+        bool ok = FilterChain::sanitize(c);
+        iirAlpha[axis] = FilterChain::iirGain(c);
+        kalmanQR[axis] = FilterChain::kalmanRatio(c);
+        primed &= ~(1u << axis);
+        return ok;
+    }
+    const FilterConfig& config(int axis) const { return cfg[axis]; }
+
+    /** @brief Verwirft alle Zustände; der nächste Durchgang füllt die Fenster neu */
+    void reset() { primed = 0; }
+
+    /**
+     * @brief Verarbeitet einen Durchgang
+     * @param in je Achse ein ADC-Wert 0..ADC_FULL_SCALE
+     * @param out je Achse der gefilterte Wert; darf in sein
+     */
+    void process(const uint16_t* in, uint16_t* out) {
+        int32_t x[N];
+        for (int a = 0; a < N; a++) {
+            x[a] = in[a];
+            if (!(primed & (1u << a))) prime(a, x[a]);
+        }
+
+        for (int a = 0; a < N; a++) {
+            if (cfg[a].median > 1) x[a] = median(a, x[a]);
+        }
+        for (int a = 0; a < N; a++) {
+            if (cfg[a].average > 1) x[a] = average(a, x[a]);
+        }
+
+        for (int a = 0; a < N; a++) {
+            if (!iirAlpha[a]) continue;
+            iirState[a] = FilterChain::blend(iirState[a], x[a], iirAlpha[a]);
+            x[a] = FilterChain::fromState(iirState[a]);
+        }
+
+        for (int a = 0; a < N; a++) {
+            if (cfg[a].kalmanR <= 0.0f) continue;
+            if (!kalmanSteady[a]) {
+                uint32_t k = FilterChain::kalmanStep(kalmanP[a], kalmanQR[a]);
+                kalmanSteady[a] = k == kalmanK[a];
+                kalmanK[a] = k;
+            }
+            kalmanX[a] = FilterChain::blend(kalmanX[a], x[a], kalmanK[a]);
+            x[a] = FilterChain::fromState(kalmanX[a]);
+        }
+
+        for (int a = 0; a < N; a++) out[a] = (uint16_t)x[a];
+    }
+
+private:
+    FilterConfig cfg[N];
+    uint32_t primed = 0;             // Bit a: Achse a hat gefüllte Fenster
+
+    // Fensterpositionen, Gewichte und Kalman-Verstärkung; letztere hängen nur von der
+    // Einstellung der Achse ab, nicht von den Messungen
+    uint8_t medIndex[N];
+    uint8_t avgIndex[N];
+    uint32_t iirAlpha[N];            // Q30, 0 = aus
+    uint64_t kalmanQR[N];            // Q/R als Q30
+    uint64_t kalmanP[N];             // P/R als Q30
+    uint32_t kalmanK[N];             // Q30
+    bool kalmanSteady[N];
+
+    // Fenster in Ankunftsreihenfolge Achse neben Achse, sortierte Median-Fenster je Achse
+    // am Stück, weil das Einsortieren an einer Achse entlangläuft
+    uint16_t medRing[FilterChain::MAX_MEDIAN][N];
+    uint16_t medSorted[N][FilterChain::MAX_MEDIAN];
+    uint16_t avgRing[FilterChain::MAX_AVERAGE][N];
+    int32_t avgSum[N];
+    int32_t iirState[N];
+    int32_t kalmanX[N];
+
+    // alle Fenster mit der ersten Messung füllen, damit der Ausgang nicht von 0 einschwingt
+    void prime(int a, int32_t x) {
+        for (uint8_t i = 0; i < cfg[a].median; i++) {
+            medRing[i][a] = (uint16_t)x;
+            medSorted[a][i] = (uint16_t)x;
+        }
+        medIndex[a] = 0;
+        for (uint8_t i = 0; i < cfg[a].average; i++) avgRing[i][a] = (uint16_t)x;
+        avgSum[a] = x * cfg[a].average;
+        avgIndex[a] = 0;
+        iirState[a] = x * FilterChain::STATE_ONE;
+        kalmanX[a] = x * FilterChain::STATE_ONE;
+        kalmanP[a] = FilterChain::Q30_ONE;      // P = R
+        kalmanK[a] = 0;
+        kalmanSteady[a] = false;
+        primed |= 1u << a;
+    }
+
+    // ältesten Wert aus dem sortierten Fenster entfernen, neuen einsortieren
+    int32_t median(int a, int32_t x) {
+        uint8_t n = cfg[a].median;
+        uint16_t old = medRing[medIndex[a]][a];
+        uint16_t v = (uint16_t)x;
+        medRing[medIndex[a]][a] = v;
+        if (++medIndex[a] == n) medIndex[a] = 0;
+
+        uint16_t* sorted = medSorted[a];
+        uint8_t pos = 0;
+        while (pos + 1 < n && sorted[pos] != old) pos++;
+        for (; pos + 1 < n; pos++) sorted[pos] = sorted[pos + 1];
+
+        pos = n - 1;
+        while (pos > 0 && sorted[pos - 1] > v) {
+            sorted[pos] = sorted[pos - 1];
+            pos--;
+        }
+        sorted[pos] = v;
+        return sorted[n / 2];
+    }
+
+    int32_t average(int a, int32_t x) {
+        uint16_t& slot = avgRing[avgIndex[a]][a];
+        avgSum[a] += x - slot;
+        slot = (uint16_t)x;
+        if (++avgIndex[a] == cfg[a].average) avgIndex[a] = 0;
+        return FilterChain::divRound(avgSum[a], cfg[a].average);
+    }
+};
+
+#endif
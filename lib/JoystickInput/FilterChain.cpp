@@ -0,0 +1,48 @@
+#include <math.h>
+
+#include "FilterChain.h"
+
+uint32_t FilterChain::iirGain(const FilterConfig& config) {
+    if (!(config.iirAlpha < 1.0f)) return 0;
+    uint32_t gain = (uint32_t)lrint(config.iirAlpha * (double)Q30_ONE);
+    return gain ? gain : 1;
+}
+
+uint64_t FilterChain::kalmanRatio(const FilterConfig& config) {
+    if (!(config.kalmanR > 0.0f)) return 0;
+    double ratio = (double)config.kalmanQ / config.kalmanR;
+    if (ratio > (double)(1ULL << 31)) ratio = (double)(1ULL << 31);  // Verstärkung dann praktisch 1
+    return (uint64_t)llround(ratio * (double)Q30_ONE);
+}
+
+bool FilterChain::sanitize(FilterConfig& cfg) {
+    bool ok = true;
+
+    if (cfg.median < 1) { cfg.median = 1; ok = false; }
+    if (cfg.median > MAX_MEDIAN) { cfg.median = MAX_MEDIAN; ok = false; }
+    if (cfg.median % 2 == 0) { cfg.median++; ok = false; }  // gerade Längen haben keine Mitte
+
+    if (cfg.average < 1) { cfg.average = 1; ok = false; }
+    if (cfg.average > MAX_AVERAGE) { cfg.average = MAX_AVERAGE; ok = false; }
+
+    if (!(cfg.iirAlpha > 0.0f)) { cfg.iirAlpha = 1.0f; ok = false; }
+    if (cfg.iirAlpha > 1.0f) { cfg.iirAlpha = 1.0f; ok = false; }
+
+    if (!(cfg.kalmanQ >= 0.0f)) { cfg.kalmanQ = 0.0f; ok = false; }
+    if (!(cfg.kalmanR >= 0.0f)) { cfg.kalmanR = 0.0f; ok = false; }
+
+    return ok;
+}
+
+float FilterChain::groupDelay(const FilterConfig& cfg) {
+    float delay = (cfg.median - 1) / 2.0f + (cfg.average - 1) / 2.0f;
+    if (cfg.iirAlpha < 1.0f) delay += (1.0f - cfg.iirAlpha) / cfg.iirAlpha;
+    if (cfg.kalmanR > 0.0f) {
+        // eingeschwungene Verstärkung; danach verhält sich das Filter wie ein IIR
+        float q = cfg.kalmanQ, r = cfg.kalmanR;
+        float p = (q + sqrtf(q * q + 4 * q * r)) / 2;
+        float k = p / (p + r);
+        delay += k > 0.0f ? (1.0f - k) / k : INFINITY;
+    }
+    return delay;
+}
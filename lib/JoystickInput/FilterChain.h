@@ -0,0 +1,87 @@
+#ifndef FILTER_CHAIN_H
+#define FILTER_CHAIN_H
+
+#include <stdint.h>
+
+/**
+ * @brief Einstellungen einer Filterkette
+ *
+ * Die Stufen laufen in fester Reihenfolge: Median -> gleitender Mittelwert ->
+ * IIR -> Kalman. Eine Stufe mit Länge 1, alpha 1 bzw. kalmanR 0 ist abgeschaltet.
+ */
+struct FilterConfig {
+    uint8_t median = 1;         ///< Fensterlänge der Median-Stufe (1, 3, 5, 7 oder 9)
+    uint8_t average = 32;       ///< Fensterlänge des gleitenden Mittelwerts (1..64)
+    float iirAlpha = 1.0f;      ///< Gewicht des neuen Werts im Tiefpass erster Ordnung (0..1]
+    float kalmanQ = 0.0f;       ///< Prozessrauschen des Kalman-Filters (pro Messung), nur Q/R zählt
+    float kalmanR = 0.0f;       ///< Messrauschen des Kalman-Filters, 0 = aus
+};
+
+/**
+ * @brief Festkomma-Schritte der Filterkette einer Joystick-Achse
+ *
+ * Die Kette selbst läuft in AxisFilterBank, für eine oder mehrere Achsen; hier liegen
+ * Grenzen, Umrechnung der Einstellungen und die Rechenschritte, die sie braucht.
+ *
+ * Gerechnet wird ganzzahlig in der Einheit der Eingabe (im Joystick ADC-Zählwerte × 16,
+ * 0..65520): gleiche Eingaben liefern auf jedem Kern bitgleiche Ausgaben. Die Summe
+ * des Mittelwerts ist exakt; IIR und Kalman halten ihren Zustand mit STATE_FRACTION_BITS
+ * zusätzlichen Nachkommabits und runden erst beim Ausgang. Gleitkomma nur beim Umrechnen
+ * der Einstellungen.
+ */
+class FilterChain {
+public:
+    static const uint8_t MAX_MEDIAN = 9;
+    static const uint8_t MAX_AVERAGE = 64;
+    /** @brief Zusätzliche Nachkommabits im Zustand von IIR und Kalman */
+    static const int STATE_FRACTION_BITS = 12;
+
+    /** @brief Begrenzt Einstellungen auf gültige Werte; false, wenn etwas geändert wurde */
+    static bool sanitize(FilterConfig& config);
+
+    /** @brief Gruppenlaufzeit der Kette bei niedrigen Frequenzen, in Messungen */
+    static float groupDelay(const FilterConfig& config);
+
+    static const int Q30_BITS = 30;
+    static const uint64_t Q30_ONE = 1ULL << Q30_BITS;
+    static const int32_t STATE_ONE = 1 << STATE_FRACTION_BITS;
+
+    /**
+     * @brief Zustand einen Schritt in Richtung Messung: s += g * (x - s), g als Q30, gerundet
+     * @param x Messwert, |x| < 2^18 (sonst läuft der Zustand über)
+     */
+    static int32_t blend(int32_t state, int32_t x, uint32_t gain) {
+        int64_t diff = ((int64_t)x << STATE_FRACTION_BITS) - state;
+        return state + (int32_t)(((int64_t)gain * diff + (1 << (Q30_BITS - 1))) >> Q30_BITS);
+    }
+
+    /** @brief Zustand auf die Einheit der Eingabe gerundet */
+    static int32_t fromState(int32_t state) {
+        return (state + STATE_ONE / 2) >> STATE_FRACTION_BITS;
+    }
+
+    /** @brief Ganzzahlige Division mit Rundung zur nächsten Zahl, auch für negative Summen */
+    static int32_t divRound(int32_t sum, int32_t n) {
+        return sum >= 0 ? (sum + n / 2) / n : -((-sum + n / 2) / n);
+    }
+
+    /** @brief IIR-Gewicht als Q30, 0 = aus; Q/R des Kalman-Filters als Q30, 0 = aus */
+    static uint32_t iirGain(const FilterConfig& config);
+    static uint64_t kalmanRatio(const FilterConfig& config);
+
+    /**
+     * @brief Nächste Kalman-Verstärkung (Q30) aus P/R; setzt p auf den neuen Wert
+     *
+     * Zufallsbewegung als Modell, in Einheiten von R: p += Q/R, k = p / (p + 1), danach
+     * p * (1 - k) = k. Nach dem Einschwingen bleibt k stehen und der Aufrufer kann die
+     * Division auslassen.
+     */
+    static uint32_t kalmanStep(uint64_t& p, uint64_t qr) {
+        p += qr;
+        uint32_t k = (uint32_t)(Q30_ONE - (Q30_ONE << Q30_BITS) / (p + Q30_ONE));
+        p = k;
+        return k;
+    }
+};
+
+#endif
@@ -4,40 +4,76 @@
 #include <Arduino.h>
 #include <math.h>  // für NAN
 
-class Joystick {
-private:
-    int pin;
-    float vRef, deadzone;
-
-    static const int BUFFER_SIZE = 32;   
-    float buffer[BUFFER_SIZE];
-    int index = 0;
-
-    float avgValue = 0;
-
-    int minVal=-1, maxVal=-1, center=-1;
-
-    TaskHandle_t taskHandle = nullptr;
-
-    float readVoltage(int pin);
-    float mapToRange(float voltage);
-    void readerTask();
-    static void taskWrapper(void* param);
+#include "JoystickAxes.h"
+#include "Q15.h"
+
+/**
+ * @brief Zustand einer Achse nach einer Messung
+ *
+ * Wird vom Reader-Task als Ganzes veröffentlicht; Leser auf beiden Kernen erhalten
+ * immer zusammengehörige Werte. Ganzzahlig vom ADC bis zum Q15-Wert; Volt liefert
+ * Joystick::toVolts() für die Anzeige.
+ */
+struct JoystickSnapshot {
+    q15_t value;            ///< normiert -32767..32767, 0 solange nicht kalibriert
+    bool calibrated;        ///< false: value ist ungültig (siehe Joystick::isCalibrated)
+    uint16_t raw;           ///< gefilterter ADC-Wert, Zählwert × 16 (0..ADC_FULL_SCALE)
+    uint32_t timeUs;        ///< esp_timer-Zeit der Messung (untere 32 Bit)
+    uint32_t samples;       ///< Anzahl verarbeiteter Messungen, 0 = noch keine
+    uint32_t calibration;   ///< Generation der Kalibrierung, mit der value berechnet wurde
+};
 
-    void saveCalibration();
-    void loadCalibration();
+/**
+ * @brief Eine Achse des Joysticks: JoystickAxes mit einer Achse im Namensraum "joystick"
+ *
+ * Abtastung, Filter, Kalibrierung, Selbstkalibrierung und Tasks liegen in JoystickAxes;
+ * hier bleibt die Schnittstelle für eine Achse.
+ */
+class Joystick : public JoystickBase {
+private:
+    JoystickAxes<1> axes;
 
 public:
     /**
      * @brief Konstruktor für eine Achse des Joysticks
      * @param pin ADC-Pin des Joysticks
      * @param vRef Referenzspannung des ADC (default 3.3V)
-     * @param deadzone Bereich um 0, der als Nullwert behandelt wird (default 0.05)
+     * @param deadzone Bereich um 0, der als Nullwert behandelt wird (default 0.05);
+     *                 mit Selbstkalibrierung nur, bis das Rauschen in Ruhe gemessen ist
      */
     Joystick(int pin, float vRef = 3.3, float deadzone = 0.05);
 
-    /** @brief Startet den Hintergrundtask für kontinuierliche Messungen */
-    void begin();
+    /**
+     * @brief Startet den Hintergrundtask für kontinuierliche Messungen
+     * @param mode ADC_CONTINUOUS nutzt den DMA-Treiber und fällt auf analogRead zurück,
+     *             wenn er nicht verfügbar ist
+     */
+    void begin(AdcMode mode = ADC_CONTINUOUS);
+
+    /** @brief Name des aktiven ADC-Backends */
+    const char* getAdcName() const { return axes.getAdcName(); }
+
+    /** @brief Abstand zweier Messungen des aktiven Backends in Mikrosekunden */
+    uint32_t getSamplePeriodUs() const { return axes.getSamplePeriodUs(); }
+
+    /**
+     * @brief Verarbeitet eine neue Messung (Glättung und Normierung)
+     * @param raw ADC-Wert, Zählwert × 16 (0..ADC_FULL_SCALE)
+     * @note Wird vom Hintergrundtask aufgerufen; öffentlich für Host-Benchmarks
+     */
+    void update(uint16_t raw) { axes.update(&raw); }
+
+    /** @brief Rechnet einen ADC-Wert (Zählwert × 16) in Volt um, nur für die Anzeige */
+    float toVolts(int32_t raw) const { return axes.toVolts(raw); }
+
+    /** @brief Liefert die aktive Kalibrierung in ADC-Einheiten */
+    JoystickCalibration getCalibration() const { return axes.getCalibration().axis[0]; }
+
+    /**
+     * @brief Liefert den Zustand der letzten Messung in einem Zug
+     * @note Sperrt nie den Reader-Task; wiederholt nur, falls er gerade schreibt
+     */
+    JoystickSnapshot getSnapshot() const;
 
     /**
      * @brief Liefert den geglätteten, normierten Joystick-Wert (-1.0 bis +1.0)
@@ -51,20 +87,58 @@ public:
      */
     float getVoltage();
 
+    /**
+     * @brief Zeitpunkt der letzten verarbeiteten Messung
+     * @return esp_timer-Zeit in Mikrosekunden (untere 32 Bit)
+     */
+    uint32_t getSampleTimeUs() const { return axes.getSnapshot().timeUs; }
+
+    /**
+     * @brief Weckt nach jeder neuen Messung den Task per xTaskNotifyGive
+     * @param task zu benachrichtigender Task, nullptr schaltet ab
+     */
+    void setNotifyTask(TaskHandle_t task) { axes.setNotifyTask(task); }
+
+    /**
+     * @brief Stellt die Filterkette um; wirksam ab der nächsten Messung
+     * @param config gewünschte Stufen, ungültige Werte werden begrenzt
+     * @return false, wenn Werte begrenzt werden mussten
+     */
+    bool setFilter(const FilterConfig& config) { return axes.setFilter(0, config); }
+
+    /** @brief Liefert die eingestellte Filterkette */
+    FilterConfig getFilter() const { return axes.getFilter(0); }
+
+    /** @brief Gruppenlaufzeit der eingestellten Filterkette in Millisekunden */
+    float getFilterDelayMs() const { return axes.getFilterDelayMs(0); }
+
     /** @brief Kalibriert die Mittelstellung */
-    void calibrateCenter();
+    void calibrateCenter() { axes.calibrateCenter(0); }
 
     /** @brief Kalibriert die minimale Endlage (-1.0) */
-    bool calibrateMin();
+    bool calibrateMin() { return axes.calibrateMin(0); }
 
     /** @brief Kalibriert die maximale Endlage (+1.0) */
-    bool calibrateMax();
+    bool calibrateMax() { return axes.calibrateMax(0); }
 
     /** @brief Setzt die Kalibrierung zurück */
-    bool resetCalibration();
+    bool resetCalibration() { return axes.resetCalibration(0); }
+
+    /** @brief Prüft, ob alle Kalibrierungsschritte abgeschlossen sind und beide Endlagen mindestens 0,5 V von der Mitte liegen */
+    bool isCalibrated() { return axes.isCalibrated(0); }
+
+    /** @brief Schaltet die Selbstkalibrierung ein oder aus, siehe JoystickAxes::setAutoCalibration */
+    void setAutoCalibration(bool enabled) { axes.setAutoCalibration(enabled); }
+    bool getAutoCalibration() const { return axes.getAutoCalibration(); }
+
+    /** @brief Stand der Selbstkalibrierung nach dem letzten Block */
+    AutoCalibration::Status getAutoStatus() const { return axes.getAutoStatus(0); }
+
+    /** @brief Aktive Totzone, Q15 */
+    q15_t getDeadzone() const { return axes.getDeadzone(0); }
 
-    /** @brief Prüft, ob alle Kalibrierungsschritte abgeschlossen sind */
-    bool isCalibrated();
+    /** @brief Anzahl Sicherungen durch die Selbstkalibrierung */
+    uint32_t getAutoSaves() const { return axes.getAutoSaves(); }
 };
 
 #endif
@@ -0,0 +1,59 @@
+#include <math.h>
+
+#include "JoystickAxes.h"
+
+const char* const JoystickBase::PREF_KEY = "axes";
+
+// Schlüssel eines Joysticks vor JoystickAxes, nur noch für die einmalige Übernahme nach
+// PREF_KEY: Kalibrierung in ADC-Einheiten und gelernte Totzone (Q15). Die noch älteren
+// "min", "max" und "center" enthielten auf ganze Volt abgeschnittene Spannungen und
+// werden nur entfernt.
+static const char* const LEGACY_MIN = "min_raw";
+static const char* const LEGACY_MAX = "max_raw";
+static const char* const LEGACY_CENTER = "center_raw";
+static const char* const LEGACY_DEADZONE = "deadzone_q15";
+
+static const float MIN_SPAN_VOLTS = 0.5f;
+// Standardabweichung eines Blocks, bis zu der der Stick als ruhig gilt
+static const float QUIET_VOLTS = 0.015f;
+
+// Abstand zur Mitte relativ zur jeweiligen Endlage, gerundet auf Q15. Zähler bis
+// 2^16 × 2^15, daher in 64 Bit; die Endlagen liegen mindestens minSpan von der Mitte.
+q15_t JoystickBase::mapToRange(int32_t raw, const JoystickCalibration& cal, q15_t deadzone) {
+    int32_t d = raw - cal.center;
+    int32_t span = d >= 0 ? cal.maxVal - cal.center : cal.center - cal.minVal;
+    int64_t scaled = (int64_t)(d >= 0 ? d : -d) * Q15_ONE;
+    int32_t value = (int32_t)((scaled + span / 2) / span);
+
+    if (value > Q15_ONE) value = Q15_ONE;
+    if (value < deadzone) value = 0;
+
+    return (q15_t)(d >= 0 ? value : -value);
+}
+
+int32_t JoystickBase::minSpanFor(float vRef) {
+    return (int32_t)lrintf(MIN_SPAN_VOLTS / vRef * ADC_FULL_SCALE);
+}
+
+AutoCalibration JoystickBase::makeAutoCalibration(float vRef, q15_t deadzone) {
+    return AutoCalibration(minSpanFor(vRef), (int32_t)lrintf(QUIET_VOLTS / vRef * ADC_FULL_SCALE), deadzone);
+}
+
+bool JoystickBase::loadLegacy(Preferences& prefs, JoystickCalibration& cal, int32_t& deadzone) {
+    if (!prefs.isKey(LEGACY_CENTER) && !prefs.isKey(LEGACY_MIN) && !prefs.isKey(LEGACY_MAX)) return false;
+    cal.minVal = prefs.getInt(LEGACY_MIN, -1);
+    cal.maxVal = prefs.getInt(LEGACY_MAX, -1);
+    cal.center = prefs.getInt(LEGACY_CENTER, -1);
+    deadzone = prefs.getInt(LEGACY_DEADZONE, -1);
+    return true;
+}
+
+void JoystickBase::removeLegacy(Preferences& prefs) {
+    prefs.remove(LEGACY_MIN);
+    prefs.remove(LEGACY_MAX);
+    prefs.remove(LEGACY_CENTER);
+    prefs.remove(LEGACY_DEADZONE);
+    prefs.remove("min");
+    prefs.remove("max");
+    prefs.remove("center");
+}
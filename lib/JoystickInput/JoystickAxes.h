@@ -0,0 +1,604 @@
+#ifndef JOYSTICK_AXES_H
+#define JOYSTICK_AXES_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_timer.h>
+#include <string.h>
+#include <atomic>
+
+#include "AdcSampler.h"
+#include "AutoCalibration.h"
+#include "AxisFilterBank.h"
+#include "Q15.h"
+#include "SeqLock.h"
+#include "TaskPlacement.h"
+
+/**
+ * @brief Gemeinsames von JoystickAxes und Joystick: Abtastung, Normierung, NVS-Schlüssel
+ */
+class JoystickBase {
+public:
+    /** @brief Abtastperiode mit analogRead */
+    static const uint32_t POLL_PERIOD_MS = 10;
+    /** @brief Wandlungsrate und Überabtastung im DMA-Betrieb: 20 kHz / 100 = 200 Durchgänge/s */
+    static const uint32_t CONTINUOUS_RATE_HZ = 20000;
+    static const uint16_t CONTINUOUS_OVERSAMPLE = 100;
+    /** @brief Selbstkalibrierung sichert höchstens so oft */
+    static const uint32_t AUTO_SAVE_INTERVAL_MS = 60000;
+
+    enum AdcMode { ADC_POLLING, ADC_CONTINUOUS };
+
+    /**
+     * @brief Normiert einen gefilterten ADC-Wert mit einer vollständigen Kalibrierung
+     * @return Q15, Werte unter deadzone werden 0
+     */
+    static q15_t mapToRange(int32_t raw, const JoystickCalibration& cal, q15_t deadzone);
+
+protected:
+    /** @brief Mindestabstand der Endlagen zur Mitte (0,5 V) in ADC-Einheiten */
+    static int32_t minSpanFor(float vRef);
+    /** @brief Selbstkalibrierung einer Achse mit den Schwellen des Projekts */
+    static AutoCalibration makeAutoCalibration(float vRef, q15_t deadzone);
+    static bool sameFilter(const FilterConfig& a, const FilterConfig& b) {
+        return a.median == b.median && a.average == b.average && a.iirAlpha == b.iirAlpha &&
+               a.kalmanQ == b.kalmanQ && a.kalmanR == b.kalmanR;
+    }
+
+    /** @brief NVS-Schlüssel des Blobs mit Kalibrierung, Totzonen und Filtern aller Achsen */
+    static const char* const PREF_KEY;
+    /**
+     * @brief Kalibrierung und gelernte Totzone (-1 = keine) eines Joysticks von vor dem Blob
+     * @return false, wenn keiner der alten Schlüssel vorhanden ist
+     */
+    static bool loadLegacy(Preferences& prefs, JoystickCalibration& cal, int32_t& deadzone);
+    static void removeLegacy(Preferences& prefs);
+};
+
+/**
+ * @brief Eine oder mehrere Achsen (z. B. Lenkung X/Y und Gashebel) mit einem gemeinsamen Abtasttask
+ *
+ * Ein Task wandelt alle Pins in einem ADC-Durchgang (analogRead nacheinander bzw. ein
+ * DMA-Muster über alle Kanäle), filtert sie in einer AxisFilterBank und veröffentlicht
+ * alle Achsen als einen Schnappschuss. Je Achse Kalibrierung von Hand (Mitte, Endlagen,
+ * Mindestabstand 0,5 V), Totzone und Selbstkalibrierung; ein Kalibriertask auf dem
+ * Systemkern wertet die Blöcke aller Achsen aus. Filter je Achse.
+ *
+ * Kalibrierung, gelernte Totzone und Filter aller Achsen liegen als ein versionierter
+ * Blob unter PREF_KEY im angegebenen Namensraum und werden mit einem putBytes
+ * geschrieben: ein Reset mitten im Sichern hinterlässt den alten oder den neuen Stand,
+ * nie eine Mischung. Gesichert wird, sobald eine Achse von Hand fertig kalibriert ist,
+ * nach setFilter() und durch die Selbstkalibrierung; halb kalibrierte Achsen behalten im
+ * Blob ihren letzten nutzbaren Stand. Beim Laden werden Achsen verworfen, die nicht
+ * isCalibrated() wären. Gibt es noch keinen Blob, werden die Schlüssel eines früheren
+ * Joysticks einmalig als Achse 0 übernommen und danach gelöscht. Joystick ist diese
+ * Klasse mit einer Achse.
+ *
+ * @tparam N Anzahl Achsen, 1..ADC_MAX_CHANNELS
+ */
+template <int N>
+class JoystickAxes : public JoystickBase {
+public:
+    static_assert(N >= 1 && N <= ADC_MAX_CHANNELS, "1 bis ADC_MAX_CHANNELS Achsen");
+    static const int AXES = N;
+    /** @brief Überabtastung je Achse im DMA-Betrieb: alle Achsen zusammen so viel wie eine allein */
+    static const uint16_t OVERSAMPLE_PER_AXIS = CONTINUOUS_OVERSAMPLE / N;
+
+    /** @brief Zustand aller Achsen nach einem Durchgang */
+    struct Snapshot {
+        q15_t value[N];         ///< normiert -32767..32767, 0 solange die Achse nicht kalibriert ist
+        uint16_t raw[N];        ///< gefilterte ADC-Werte, Zählwert × 16
+        uint8_t calibrated;     ///< Bit a gesetzt: value[a] ist gültig
+        uint32_t timeUs;        ///< esp_timer-Zeit des Durchgangs (untere 32 Bit)
+        uint32_t samples;       ///< Anzahl Durchgänge, 0 = noch keiner
+        uint32_t calibration;   ///< Generation der Kalibrierung, mit der value berechnet wurde
+    };
+
+    /** @brief Kalibrierung aller Achsen in ADC-Einheiten */
+    struct Calibration {
+        JoystickCalibration axis[N];
+    };
+
+    /** @brief Filtereinstellungen aller Achsen */
+    struct Filters {
+        FilterConfig axis[N];
+    };
+
+    /** @brief Blocksummen aller Achsen für die Selbstkalibrierung */
+    struct Blocks {
+        AxisBlock axis[N];
+    };
+
+    /**
+     * @param pins ADC1-Pins, je Achse einer
+     * @param prefsNamespace NVS-Namensraum der Kalibrierung (höchstens 15 Zeichen)
+     * @param vRef Referenzspannung des ADC
+     * @param deadzone Bereich um 0, der als Nullwert behandelt wird, für alle Achsen;
+     *                 mit Selbstkalibrierung nur, bis das Rauschen in Ruhe gemessen ist
+     */
+    JoystickAxes(const int* pins, const char* prefsNamespace = "axes", float vRef = 3.3f, float deadzone = 0.05f)
+        : prefsNamespace(prefsNamespace), vRef(vRef), configuredDeadzone(q15FromFloat(deadzone)),
+          minSpan(minSpanFor(vRef)),
+          pollingAdc(pins, N, POLL_PERIOD_MS),
+          continuousAdc(pins, N, CONTINUOUS_RATE_HZ, OVERSAMPLE_PER_AXIS) {
+        Filters filters;
+        for (int a = 0; a < N; a++) filters.axis[a] = bank.config(a);
+        filterRequest.store(filters);
+        filterVersion = filterRequest.version();
+
+        Snapshot empty;
+        memset(&empty, 0, sizeof(empty));
+        snapshot.store(empty);
+        for (int a = 0; a < N; a++) {
+            activeCal.axis[a] = {-1, -1, -1};
+            deadzones[a].store(configuredDeadzone, std::memory_order_relaxed);
+            learned[a].store(-1, std::memory_order_relaxed);
+            autoCal[a] = makeAutoCalibration(vRef, configuredDeadzone);
+            autoStatus[a].store(autoCal[a].status());
+        }
+        calibration.store(activeCal);
+        activeCalVersion = calibration.version();
+        autoCalVersion = activeCalVersion;
+        autoCalSeen = activeCal;
+    }
+
+    ~JoystickAxes() {
+        if (taskHandle) {
+            vTaskDelete(taskHandle);
+            taskHandle = nullptr;
+        }
+        if (calTaskHandle) {
+            vTaskDelete(calTaskHandle);
+            calTaskHandle = nullptr;
+        }
+    }
+
+    /**
+     * @brief Lädt die Kalibrierung und startet Abtast- und Kalibriertask
+     * @param mode ADC_CONTINUOUS nutzt den DMA-Treiber und fällt auf analogRead zurück,
+     *             wenn er nicht verfügbar ist
+     */
+    void begin(AdcMode mode = ADC_CONTINUOUS) {
+        adc = &pollingAdc;
+        if (mode == ADC_CONTINUOUS) {
+            if (continuousAdc.begin()) {
+                adc = &continuousAdc;
+            } else {
+                Serial.println("Kontinuierlicher ADC nicht verfügbar, nutze analogRead");
+            }
+        }
+        if (adc == &pollingAdc) pollingAdc.begin();
+
+        load();
+        startTask(taskWrapper, TASK_JOYSTICK, this, &taskHandle);
+        startTask(calTaskWrapper, TASK_JOYSTICK_CAL, this, &calTaskHandle);
+    }
+
+    /** @brief Name des aktiven ADC-Backends */
+    const char* getAdcName() const { return adc->name(); }
+    /** @brief Abstand zweier Durchgänge des aktiven Backends in Mikrosekunden */
+    uint32_t getSamplePeriodUs() const { return adc->periodUs(); }
+
+    /**
+     * @brief Verarbeitet einen Durchgang (Glättung und Normierung aller Achsen)
+     * @param raw je Achse ein ADC-Wert, Zählwert × 16
+     * @note Wird vom Abtasttask aufgerufen; öffentlich für Host-Benchmarks
+     */
+    void update(const uint16_t* raw) {
+        uint32_t version = filterRequest.version();
+        if (version != filterVersion) {
+            filterVersion = version;
+            // nur geänderte Achsen, die übrigen filtern ohne Sprung weiter
+            Filters filters = filterRequest.load();
+            for (int a = 0; a < N; a++) {
+                if (!sameFilter(filters.axis[a], bank.config(a))) bank.configure(a, filters.axis[a]);
+            }
+        }
+        version = calibration.version();
+        if (version != activeCalVersion) {
+            activeCalVersion = version;
+            activeCal = calibration.load();
+            activeMask = 0;
+            for (int a = 0; a < N; a++) {
+                if (usable(activeCal.axis[a])) activeMask |= (uint8_t)(1u << a);
+            }
+        }
+
+        Snapshot s;
+        bank.process(raw, s.raw);
+        s.calibrated = activeMask;
+        for (int a = 0; a < N; a++) {
+            s.value[a] = activeMask & (1u << a)
+                ? mapToRange(s.raw[a], activeCal.axis[a], deadzones[a].load(std::memory_order_relaxed)) : 0;
+        }
+        s.timeUs = (uint32_t)esp_timer_get_time();
+        s.samples = ++sampleCount;
+        s.calibration = activeCalVersion;
+        snapshot.store(s);
+
+        // Summen für die Selbstkalibrierung; ausgewertet wird im Kalibriertask
+        bool first = block.axis[0].count == 0;
+        for (int a = 0; a < N; a++) {
+            AxisBlock& b = block.axis[a];
+            uint16_t v = s.raw[a];
+            if (first) {
+                b.sum = 0;
+                b.sumSquares = 0;
+                b.minVal = b.maxVal = v;
+            }
+            b.count++;
+            b.sum += v;
+            b.sumSquares += (uint64_t)v * v;
+            if (v < b.minVal) b.minVal = v;
+            if (v > b.maxVal) b.maxVal = v;
+        }
+        if (block.axis[0].count == AutoCalibration::BLOCK_SAMPLES) {
+            blocks.store(block);
+            for (int a = 0; a < N; a++) block.axis[a].count = 0;
+            TaskHandle_t cal = calTaskHandle;
+            if (cal) xTaskNotifyGive(cal);
+        }
+    }
+
+    /** @brief Zustand aller Achsen aus einem Durchgang; sperrt nie den Abtasttask */
+    Snapshot getSnapshot() const { return snapshot.load(); }
+
+    /** @brief Liefert die aktive Kalibrierung in ADC-Einheiten */
+    Calibration getCalibration() const { return calibration.load(); }
+
+    /** @brief Rechnet einen ADC-Wert (Zählwert × 16) in Volt um, nur für die Anzeige */
+    float toVolts(int32_t raw) const { return raw * vRef / ADC_FULL_SCALE; }
+
+    /** @brief Weckt nach jedem Durchgang den Task per xTaskNotifyGive, nullptr schaltet ab */
+    void setNotifyTask(TaskHandle_t task) { notifyTask = task; }
+
+    /**
+     * @brief Stellt die Filterkette einer Achse um, -1 = alle; wirksam ab dem nächsten
+     *        Durchgang, gesichert im Blob
+     * @return false bei ungültiger Achse oder wenn Werte begrenzt werden mussten
+     */
+    bool setFilter(int axis, const FilterConfig& config) {
+        if (axis < -1 || axis >= N) return false;
+        FilterConfig checked = config;
+        bool ok = FilterChain::sanitize(checked);
+        Filters filters = filterRequest.load();
+        for (int a = 0; a < N; a++) {
+            if (axis == -1 || a == axis) filters.axis[a] = checked;
+        }
+        filterRequest.store(filters);
+        save(calibration.load());
+        return ok;
+    }
+    /** @brief Eingestellte Filterkette einer Achse */
+    FilterConfig getFilter(int axis) const { return filterRequest.load().axis[axis]; }
+
+    /** @brief Gruppenlaufzeit der eingestellten Filterkette einer Achse in Millisekunden */
+    float getFilterDelayMs(int axis) const {
+        return FilterChain::groupDelay(getFilter(axis)) * adc->periodUs() / 1000.0f;
+    }
+
+    // --- Kalibrierung je Achse ---
+    // Die Handler laufen im Web- oder loop()-Task: Kalibrierung als Ganzes lesen, ändern
+    // und veröffentlichen; der Abtasttask übernimmt sie beim nächsten Durchgang.
+    // false bei ungültiger Achse.
+
+    /** @brief Kalibriert die Mittelstellung */
+    bool calibrateCenter(int axis) {
+        if (axis < 0 || axis >= N) return false;
+        Calibration cal = calibration.load();
+        cal.axis[axis].center = snapshot.load().raw[axis];
+        publish(cal, axis);
+        return true;
+    }
+
+    /** @brief Minimale Endlage (-1.0); false, wenn nicht mindestens 0,5 V unter der Mitte */
+    bool calibrateMin(int axis) {
+        if (axis < 0 || axis >= N) return false;
+        Calibration cal = calibration.load();
+        JoystickCalibration& c = cal.axis[axis];
+        c.minVal = snapshot.load().raw[axis];
+        bool ok = c.center != -1 && c.minVal <= c.center - minSpan;
+        if (!ok) c.minVal = -1;
+        publish(cal, axis);
+        return ok;
+    }
+
+    /** @brief Maximale Endlage (+1.0); false, wenn nicht mindestens 0,5 V über der Mitte */
+    bool calibrateMax(int axis) {
+        if (axis < 0 || axis >= N) return false;
+        Calibration cal = calibration.load();
+        JoystickCalibration& c = cal.axis[axis];
+        c.maxVal = snapshot.load().raw[axis];
+        bool ok = c.center != -1 && c.maxVal >= c.center + minSpan;
+        if (!ok) c.maxVal = -1;
+        publish(cal, axis);
+        return ok;
+    }
+
+    /** @brief Setzt die Kalibrierung einer Achse zurück, -1 = alle; die Selbstkalibrierung legt keine neue an */
+    bool resetCalibration(int axis = -1) {
+        if (axis < -1 || axis >= N) return false;
+        Calibration cal = calibration.load();
+        uint8_t cleared = 0;
+        for (int a = 0; a < N; a++) {
+            if (axis != -1 && a != axis) continue;
+            cal.axis[a] = {-1, -1, -1};
+            // der Kalibriertask vergisst das Gelernte beim nächsten Block
+            deadzones[a].store(configuredDeadzone, std::memory_order_relaxed);
+            learned[a].store(-1, std::memory_order_relaxed);
+            cleared |= (uint8_t)(1u << a);
+        }
+        calibration.store(cal);
+        save(cal, cleared);
+        return true;
+    }
+
+    /** @brief Alle Schritte abgeschlossen und beide Endlagen mindestens 0,5 V von der Mitte */
+    bool isCalibrated(int axis) const {
+        return axis >= 0 && axis < N && usable(calibration.load().axis[axis]);
+    }
+
+    /**
+     * @brief Schaltet die Selbstkalibrierung (siehe AutoCalibration) aller Achsen ein oder aus
+     *
+     * Standardmäßig aus. Eingeschaltet verfeinert der Kalibriertask eine vollständige
+     * Kalibrierung von Hand im laufenden Betrieb (Mitte, Endlagen nur nach außen, Totzone)
+     * und sichert sie, sobald sie um mehr als AutoCalibration::SAVE_THRESHOLD vom
+     * gespeicherten Stand abweicht, höchstens alle AUTO_SAVE_INTERVAL_MS. Ohne Kalibrierung
+     * von Hand, auch nach resetCalibration(), ändert sie nichts. Ausgeschaltet gilt wieder
+     * die Totzone aus dem Konstruktor.
+     */
+    void setAutoCalibration(bool enabled) {
+        autoEnabled = enabled;
+        if (enabled) return;
+        for (int a = 0; a < N; a++) deadzones[a].store(configuredDeadzone, std::memory_order_relaxed);
+    }
+    bool getAutoCalibration() const { return autoEnabled.load(); }
+
+    /** @brief Stand der Selbstkalibrierung einer Achse nach dem letzten Block */
+    AutoCalibration::Status getAutoStatus(int axis) const { return autoStatus[axis].load(); }
+
+    /** @brief Aktive Totzone einer Achse, Q15 */
+    q15_t getDeadzone(int axis) const { return deadzones[axis].load(std::memory_order_relaxed); }
+
+    /** @brief Anzahl Sicherungen durch die Selbstkalibrierung */
+    uint32_t getAutoSaves() const { return autoSaves.load(); }
+
+    /**
+     * @brief Wertet einen Block der Selbstkalibrierung für alle Achsen aus
+     * @note Läuft im Kalibriertask; öffentlich für Host-Benchmarks
+     *
+     * Handler von Hand schreiben ohne Absprache, daher veröffentlicht die
+     * Selbstkalibrierung nur, wenn seit dem Lesen niemand geschrieben hat (storeIf).
+     */
+    void autoCalibrate(const Blocks& b) {
+        uint32_t version;
+        Calibration cal;
+        do {
+            version = calibration.version();
+            cal = calibration.load();
+        } while (calibration.version() != version);
+
+        if (version != autoCalVersion) {
+            // von Hand geänderte Achsen sind der neue Ausgangspunkt, gesichert haben die Handler
+            autoCalVersion = version;
+            for (int a = 0; a < N; a++) {
+                if (memcmp(&cal.axis[a], &autoCalSeen.axis[a], sizeof(JoystickCalibration)) == 0) continue;
+                if (!usable(cal.axis[a])) autoCal[a].reset();
+                autoCal[a].saved(cal.axis[a], autoCal[a].deadzone());
+            }
+            autoCalSeen = cal;
+        }
+        // auch nach setAutoCalibration(), falls es sich mit einem Block überschnitten hat
+        if (!autoEnabled) {
+            for (int a = 0; a < N; a++) deadzones[a].store(configuredDeadzone, std::memory_order_relaxed);
+            return;
+        }
+
+        bool changed = false;
+        for (int a = 0; a < N; a++) {
+            if (autoCal[a].addBlock(b.axis[a], cal.axis[a])) changed = true;
+            autoStatus[a].store(autoCal[a].status());
+        }
+        // verloren: der nächste Block rechnet mit dem neuen Stand weiter
+        if (changed && !calibration.storeIf(version, cal)) return;
+        if (changed) {
+            autoCalVersion = version + 1;
+            autoCalSeen = cal;
+        }
+        // ohne Kalibrierung von Hand ohne Wirkung, dort ist value ohnehin 0
+        for (int a = 0; a < N; a++) deadzones[a].store(autoCal[a].deadzone(), std::memory_order_relaxed);
+
+        // sichern, wenn es sich lohnt, höchstens einmal je Intervall
+        uint32_t now = millis();
+        if (now - lastSaveMs < AUTO_SAVE_INTERVAL_MS) return;
+        bool due = false;
+        for (int a = 0; a < N; a++) due |= autoCal[a].saveDue(cal.axis[a]);
+        if (!due) return;
+        saveAuto(cal);
+        lastSaveMs = now;
+    }
+
+private:
+    const char* prefsNamespace;
+    float vRef;
+    q15_t configuredDeadzone;
+    int32_t minSpan;        // 0,5 V in ADC-Einheiten: Mindestabstand der Endlagen zur Mitte
+
+    PollingAdc pollingAdc;
+    ContinuousAdc continuousAdc;
+    AdcSampler* adc = &pollingAdc;
+
+    AxisFilterBank<N> bank;
+    SeqLock<Filters> filterRequest;        // von setFilter() gesetzt, im Abtasttask übernommen
+    uint32_t filterVersion = 0;
+
+    // Ergebnis des letzten Durchgangs; Leser rechnen nichts nach
+    SeqLock<Snapshot> snapshot;
+    uint32_t sampleCount = 0;
+    TaskHandle_t notifyTask = nullptr;
+
+    // von den Kalibrier-Handlern und der Selbstkalibrierung geschrieben, im Abtasttask zwischengespeichert
+    SeqLock<Calibration> calibration;
+    Calibration activeCal;                 // nur Abtasttask
+    uint8_t activeMask = 0;                // Bit a: activeCal.axis[a] ist nutzbar
+    uint32_t activeCalVersion = 0;
+    std::atomic<q15_t> deadzones[N];       // gelernt oder configuredDeadzone, im Abtasttask gelesen
+    std::atomic<q15_t> learned[N];         // gesicherte gelernte Totzone, -1 = keine
+
+    // Selbstkalibrierung: Blocksummen aus dem Abtasttask, ausgewertet im Kalibriertask
+    Blocks block = {};                     // nur Abtasttask
+    SeqLock<Blocks> blocks;
+    AutoCalibration autoCal[N];            // nur Kalibriertask
+    SeqLock<AutoCalibration::Status> autoStatus[N];
+    std::atomic<bool> autoEnabled{false};
+    std::atomic<uint32_t> autoSaves{0};
+    uint32_t autoCalVersion = 0;           // zuletzt gesehene Generation der Kalibrierung
+    Calibration autoCalSeen;               // und ihr Inhalt
+    uint32_t lastSaveMs = 0;
+
+    TaskHandle_t taskHandle = nullptr;
+    TaskHandle_t calTaskHandle = nullptr;
+
+    bool usable(const JoystickCalibration& cal) const { return AutoCalibration::isUsable(cal, minSpan); }
+
+    // Inhalt des Blobs unter PREF_KEY; Version 1 hatte keine Totzonen und einen Filter für alle
+    struct Stored {
+        uint8_t version;
+        uint8_t axes;
+        int16_t deadzone[N];               // gelernte Totzone, Q15, -1 = keine
+        Calibration cal;
+        Filters filter;
+    };
+    static const uint8_t STORED_VERSION = 2;
+
+    static Stored emptyStored() {
+        Stored st = Stored();    // Füllbytes null, der Blob ist bei gleichem Inhalt gleich
+        st.version = STORED_VERSION;
+        st.axes = N;
+        for (int a = 0; a < N; a++) {
+            st.deadzone[a] = -1;
+            st.cal.axis[a] = {-1, -1, -1};
+            st.filter.axis[a] = FilterConfig();
+        }
+        return st;
+    }
+
+    static bool readStored(Preferences& prefs, Stored& st) {
+        return prefs.getBytesLength(PREF_KEY) == sizeof(st) &&
+               prefs.getBytes(PREF_KEY, &st, sizeof(st)) == sizeof(st) &&
+               st.version == STORED_VERSION && st.axes == N;
+    }
+
+    /**
+     * Schreibt den Blob in einem putBytes: nutzbare Achsen aus cal, Achsen in cleared
+     * zurückgesetzt, alle übrigen wie zuletzt gesichert; dazu Filter und gelernte Totzonen.
+     */
+    void save(const Calibration& cal, uint8_t cleared = 0) {
+        Preferences prefs;
+        prefs.begin(prefsNamespace, false);
+        Stored st;
+        if (!readStored(prefs, st)) st = emptyStored();
+        st.filter = filterRequest.load();
+        for (int a = 0; a < N; a++) {
+            if (cleared & (1u << a)) st.cal.axis[a] = {-1, -1, -1};
+            else if (usable(cal.axis[a])) st.cal.axis[a] = cal.axis[a];
+            st.deadzone[a] = learned[a].load(std::memory_order_relaxed);
+        }
+        prefs.putBytes(PREF_KEY, &st, sizeof(st));
+        prefs.end();
+    }
+
+    // veröffentlichen; gesichert wird, sobald die Achse nutzbar ist
+    void publish(const Calibration& cal, int axis) {
+        calibration.store(cal);
+        if (usable(cal.axis[axis])) save(cal);
+    }
+
+    void saveAuto(const Calibration& cal) {
+        for (int a = 0; a < N; a++) {
+            if (!autoCal[a].saveDue(cal.axis[a])) continue;
+            learned[a].store(autoCal[a].deadzone(), std::memory_order_relaxed);
+            autoCal[a].saved(cal.axis[a], autoCal[a].deadzone());
+        }
+        save(cal);
+        autoSaves++;
+    }
+
+    void load() {
+        Stored st;
+        Preferences prefs;
+        prefs.begin(prefsNamespace, true);
+        bool ok = readStored(prefs, st);
+        prefs.end();
+        if (!ok) {
+            st = emptyStored();
+            migrate(st);
+        }
+
+        Calibration& cal = st.cal;
+        for (int a = 0; a < N; a++) {
+            // unstimmige oder zu knappe Werte gar nicht erst übernehmen
+            if (!usable(cal.axis[a])) cal.axis[a] = {-1, -1, -1};
+            // gilt erst, wenn die Selbstkalibrierung eingeschaltet ist (siehe autoCalibrate)
+            int16_t dz = st.deadzone[a];
+            if (usable(cal.axis[a]) && dz >= AutoCalibration::MIN_DEADZONE && dz <= AutoCalibration::MAX_DEADZONE) {
+                autoCal[a].setDeadzone(dz);
+                learned[a].store(dz, std::memory_order_relaxed);
+            }
+            autoCal[a].saved(cal.axis[a], autoCal[a].deadzone());
+            FilterChain::sanitize(st.filter.axis[a]);
+        }
+        filterRequest.store(st.filter);
+        calibration.store(cal);
+        autoCalVersion = calibration.version();
+        autoCalSeen = cal;
+    }
+
+    // Einmalig: Schlüssel eines Joysticks von vor dem Blob als Achse 0 übernehmen. Gelöscht
+    // werden sie erst, wenn der Blob geschrieben ist.
+    void migrate(Stored& st) {
+        Preferences prefs;
+        prefs.begin(prefsNamespace, false);
+        int32_t dz;
+        if (loadLegacy(prefs, st.cal.axis[0], dz)) {
+            st.deadzone[0] = dz >= AutoCalibration::MIN_DEADZONE && dz <= AutoCalibration::MAX_DEADZONE ? (int16_t)dz : -1;
+            if (prefs.putBytes(PREF_KEY, &st, sizeof(st)) == sizeof(st)) removeLegacy(prefs);
+        }
+        prefs.end();
+    }
+
+    void readerTask() {
+        while (true) {
+            // blockiert bis zum nächsten Durchgang: Periode (analogRead) oder voller DMA-Frame
+            uint16_t raw[N];
+            if (!adc->read(raw)) continue;
+
+            update(raw);
+
+            TaskHandle_t consumer = notifyTask;
+            if (consumer) xTaskNotifyGive(consumer);
+        }
+    }
+
+    static void taskWrapper(void* param) {
+        static_cast<JoystickAxes*>(param)->readerTask();
+    }
+
+    void calibrationTask() {
+        uint32_t seen = blocks.version();
+        while (true) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            uint32_t version = blocks.version();
+            if (version == seen) continue;
+            seen = version;
+            autoCalibrate(blocks.load());
+        }
+    }
+
+    static void calTaskWrapper(void* param) {
+        static_cast<JoystickAxes*>(param)->calibrationTask();
+    }
+};
+
+#endif
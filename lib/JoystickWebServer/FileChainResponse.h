@@ -0,0 +1,59 @@
+#pragma once
+#include <ESPAsyncWebServer.h>
+#include <FS.h>
+
+/**
+ * @brief Mehrere Dateien hintereinander als ein Download, stückweise aus dem Dateisystem
+ *
+ * Für rotierte Mitschnitte, ältere Datei zuerst. Die Länge steht beim Öffnen fest; was
+ * danach angehängt wird, kommt mit dem nächsten Download. Im RAM liegt nie mehr als das
+ * Stück, das AsyncTCP gerade anfordert. Wird eine Datei währenddessen gekürzt (Rotation),
+ * füllt die Antwort mit Nullbytes auf, damit Content-Length stimmt.
+ */
+class FileChainResponse : public AsyncAbstractResponse {
+public:
+    static const int MAX_FILES = 4;
+
+    FileChainResponse(fs::FS& fs, const char* const* paths, int count) {
+        _code = 200;
+        _contentType = "application/octet-stream";
+        _sendContentLength = true;
+        _chunked = false;
+        for (int i = 0; i < count && fileCount < MAX_FILES; i++) {
+            if (!fs.exists(paths[i])) continue;
+            fs::File f = fs.open(paths[i], FILE_READ);
+            if (!f) continue;
+            remaining[fileCount] = f.size();
+            _contentLength += remaining[fileCount];
+            files[fileCount++] = f;
+        }
+    }
+
+    /** @brief true, wenn keine der Dateien existiert */
+    bool empty() const { return fileCount == 0; }
+
+    bool _sourceValid() const override { return true; }
+
+    size_t _fillBuffer(uint8_t* data, size_t maxLen) override {
+        size_t total = 0;
+        while (total < maxLen && current < fileCount) {
+            size_t want = maxLen - total;
+            if (want > remaining[current]) want = remaining[current];
+            size_t got = want ? files[current].read(data + total, want) : 0;
+            if (want && got == 0) {
+                memset(data + total, 0, want);
+                got = want;
+            }
+            total += got;
+            remaining[current] -= got;
+            if (remaining[current] == 0) files[current++].close();
+        }
+        return total;
+    }
+
+private:
+    fs::File files[MAX_FILES];
+    size_t remaining[MAX_FILES] = {};
+    int fileCount = 0;
+    int current = 0;
+};
@@ -0,0 +1,108 @@
+#pragma once
+#include <ESPAsyncWebServer.h>
+#include <cstddef>
+#include <new>
+
+#include "JsonWriter.h"
+
+/**
+ * @brief HTTP-Antwort mit JSON-Rumpf im eigenen, festen Puffer
+ *
+ *   JsonResponse* res = new JsonResponse();
+ *   res->json().beginObject().key("norm").value(0.5f, 2).endObject();
+ *   req->send(res->finish());
+ *
+ * Die Objekte kommen aus einem statischen Pool (operator new/delete), der Rumpf
+ * liegt im Objekt: der Handler selbst legt nichts auf dem Heap an. Nur wenn alle
+ * POOL_SIZE Antworten gleichzeitig unterwegs sind, wird auf den Heap ausgewichen.
+ */
+class JsonResponse : public AsyncAbstractResponse {
+public:
+    static const size_t CAPACITY = 512;
+    static const int POOL_SIZE = 4;
+
+    JsonResponse() : writer(body, sizeof(body)) {
+        _code = 200;
+        _contentType = "application/json";
+        _sendContentLength = true;
+        _chunked = false;
+    }
+
+    JsonWriter& json() { return writer; }
+
+    /** @brief Schließt den Rumpf ab; bei Pufferüberlauf wird daraus ein 500 */
+    JsonResponse* finish() {
+        if (!writer.ok()) {
+            _code = 500;
+            writer.reset();
+            writer.beginObject().key("error").value("response too large").endObject();
+        }
+        _contentLength = writer.length();
+        return this;
+    }
+
+    bool _sourceValid() const override { return true; }
+
+    size_t _fillBuffer(uint8_t* data, size_t maxLen) override {
+        size_t n = writer.length() - offset;
+        if (n > maxLen) n = maxLen;
+        memcpy(data, body + offset, n);
+        offset += n;
+        return n;
+    }
+
+    static void* operator new(size_t size) {
+        if (size == sizeof(JsonResponse)) {
+            portENTER_CRITICAL(&poolMux());
+            for (int i = 0; i < POOL_SIZE; i++) {
+                if (!poolUsed()[i]) {
+                    poolUsed()[i] = true;
+                    portEXIT_CRITICAL(&poolMux());
+                    return slot(i);
+                }
+            }
+            portEXIT_CRITICAL(&poolMux());
+        }
+        misses() = misses() + 1;
+        return ::operator new(size);
+    }
+
+    static void operator delete(void* ptr) {
+        for (int i = 0; i < POOL_SIZE; i++) {
+            if (ptr == slot(i)) {
+                portENTER_CRITICAL(&poolMux());
+                poolUsed()[i] = false;
+                portEXIT_CRITICAL(&poolMux());
+                return;
+            }
+        }
+        ::operator delete(ptr);
+    }
+
+    /** @brief Antworten, die mangels freiem Platz im Pool doch auf dem Heap landeten */
+    static uint32_t poolMisses() { return misses(); }
+
+private:
+    char body[CAPACITY];
+    JsonWriter writer;
+    size_t offset = 0;
+
+    // Pool als funktionslokale Statics: hier ist sizeof(JsonResponse) bereits bekannt
+    static void* slot(int i) {
+        struct alignas(std::max_align_t) Slot { uint8_t bytes[sizeof(JsonResponse)]; };
+        static Slot slots[POOL_SIZE];
+        return &slots[i];
+    }
+    static bool* poolUsed() {
+        static bool used[POOL_SIZE] = {};
+        return used;
+    }
+    static portMUX_TYPE& poolMux() {
+        static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+        return mux;
+    }
+    static volatile uint32_t& misses() {
+        static volatile uint32_t count = 0;
+        return count;
+    }
+};
@@ -0,0 +1,159 @@
+#pragma once
+#include <ESPAsyncWebServer.h>
+#include <freertos/semphr.h>
+#include <atomic>
+
+#include "TaskPlacement.h"
+#include "Telemetry.h"
+
+/**
+ * @brief Schiebt Live-Telemetrie per WebSocket an alle offenen Seiten
+ *
+ * Ein eigener Task sammelt pro Takt einmal den Zustand, kodiert ihn einmal in einen
+ * AsyncWebSocketMessageBuffer und reicht diesen einen Puffer an alle Clients weiter;
+ * die Bibliothek zählt die Verweise und kopiert die Nutzdaten nicht je Client. Hat ein
+ * Client noch einen Frame in der Warteschlange, bekommt er diesen Takt nicht: veraltete
+ * Werte werden verworfen statt aufgestaut (WS_MAX_QUEUED_MESSAGES in platformio.ini
+ * begrenzt die Warteschlange).
+ *
+ * Die Clientliste der Bibliothek ist ohne Sperre und gehört dem AsyncTCP-Task; der
+ * Sende-Task liest sie nie. Stattdessen trägt der AsyncTCP-Task die Clients bei
+ * WS_EVT_CONNECT hier ein und bei WS_EVT_DISCONNECT wieder aus. Letzteres meldet die
+ * Bibliothek aus dem Destruktor des Clients, also bevor sie ihn freigibt: solange der
+ * Sende-Task clientLock hält, bleibt jeder eingetragene Zeiger gültig.
+ */
+class TelemetryPush {
+public:
+    static const int MAX_CLIENTS = 4;
+    static const int MIN_RATE_HZ = 1;
+    static const int MAX_RATE_HZ = 50;
+
+    TelemetryPush(Joystick& js, VescCan& vesc, uint8_t controller_id, const char* path = "/ws")
+        : js(js), vesc(vesc), controllerId(controller_id), ws(path) {}
+
+    /** @brief WebSocket-Route, vor dem Start des Webservers einzuhängen */
+    AsyncWebHandler& handler() { return ws; }
+
+    /** @brief Startet den Sende-Task mit rate_hz Takten pro Sekunde */
+    void begin(int rate_hz = 20) {
+        setRate(rate_hz);
+        if (clientLock == nullptr) clientLock = xSemaphoreCreateMutex();
+        ws.onEvent([this](AsyncWebSocket*, AsyncWebSocketClient* client, AwsEventType type,
+                          void*, uint8_t*, size_t) {
+            // ohne freien Platz wird der neue Client abgewiesen, die verbundenen bleiben
+            if (type == WS_EVT_CONNECT) {
+                if (!addClient(client)) client->close();
+            } else if (type == WS_EVT_DISCONNECT) removeClient(client);
+        });
+        if (taskHandle == nullptr) {
+            startTask(taskWrapper, TASK_TELEMETRY, this, &taskHandle);
+        }
+    }
+
+    void setRate(int rate_hz) {
+        if (rate_hz < MIN_RATE_HZ) rate_hz = MIN_RATE_HZ;
+        if (rate_hz > MAX_RATE_HZ) rate_hz = MAX_RATE_HZ;
+        rateHz.store(rate_hz, std::memory_order_relaxed);
+    }
+    int rate() const { return rateHz.load(std::memory_order_relaxed); }
+
+    struct Stats {
+        uint32_t clients;
+        uint32_t frames;      // kodierte Takte
+        uint32_t sent;        // an einzelne Clients übergebene Frames
+        uint32_t dropped;     // ausgelassen, weil der Client noch nicht fertig war
+    };
+    Stats stats() const {
+        Stats st;
+        st.clients = clientCount.load(std::memory_order_relaxed);
+        st.frames = frames.load(std::memory_order_relaxed);
+        st.sent = sent.load(std::memory_order_relaxed);
+        st.dropped = dropped.load(std::memory_order_relaxed);
+        return st;
+    }
+
+private:
+    Joystick& js;
+    VescCan& vesc;
+    uint8_t controllerId;
+    AsyncWebSocket ws;
+
+    std::atomic<int> rateHz{20};
+    std::atomic<uint32_t> frames{0}, sent{0}, dropped{0};
+
+    // Verbundene Clients; geschrieben im AsyncTCP-Task, gelesen im Sende-Task, beides
+    // unter clientLock (ein Mutex, weil der Sende-Task damit text() aufruft)
+    AsyncWebSocketClient* clients[MAX_CLIENTS] = {};
+    SemaphoreHandle_t clientLock = nullptr;
+    std::atomic<uint32_t> clientCount{0};
+
+    char buffer[512];
+    TaskHandle_t taskHandle = nullptr;
+
+    bool addClient(AsyncWebSocketClient* client) {
+        bool added = false;
+        xSemaphoreTake(clientLock, portMAX_DELAY);
+        for (AsyncWebSocketClient*& slot : clients) {
+            if (slot == nullptr) { slot = client; added = true; break; }
+        }
+        xSemaphoreGive(clientLock);
+        if (added) clientCount.fetch_add(1, std::memory_order_relaxed);
+        return added;
+    }
+
+    void removeClient(AsyncWebSocketClient* client) {
+        xSemaphoreTake(clientLock, portMAX_DELAY);
+        for (AsyncWebSocketClient*& slot : clients) {
+            if (slot == client) {
+                slot = nullptr;
+                clientCount.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+        xSemaphoreGive(clientLock);
+    }
+
+    static void taskWrapper(void* param) {
+        static_cast<TelemetryPush*>(param)->pushTask();
+    }
+
+    void pushTask() {
+        TickType_t lastWake = xTaskGetTickCount();
+        while (true) {
+            TickType_t period = pdMS_TO_TICKS(1000 / rateHz.load(std::memory_order_relaxed));
+            vTaskDelayUntil(&lastWake, period > 0 ? period : 1);
+            tick();
+        }
+    }
+
+    void tick() {
+        // niemand schaut zu: nichts sammeln, nichts kodieren
+        if (clientCount.load(std::memory_order_relaxed) == 0) return;
+
+        TelemetrySample sample;
+        collectTelemetry(js, vesc, controllerId, sample);
+        size_t len = encodeTelemetryJson(sample, buffer, sizeof(buffer));
+        if (len == 0) return;
+        AsyncWebSocketMessageBuffer* shared = ws.makeBuffer(len);
+        if (shared == nullptr) return;
+        memcpy(shared->get(), buffer, len);
+        frames.fetch_add(1, std::memory_order_relaxed);
+
+        // wie textAll(): eigener Verweis, damit der Puffer die Verteilung überlebt
+        shared->lock();
+        xSemaphoreTake(clientLock, portMAX_DELAY);
+        for (AsyncWebSocketClient* client : clients) {
+            if (client == nullptr) continue;
+            // queueIsFull() ist auch wahr, solange der Client nicht verbunden ist
+            if (client->queueIsFull()) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            client->text(shared);
+            sent.fetch_add(1, std::memory_order_relaxed);
+        }
+        xSemaphoreGive(clientLock);
+        shared->unlock();
+        // gibt Puffer frei, die kein Client mehr braucht, ggf. erst im nächsten Takt diesen
+        ws._cleanBuffers();
+    }
+};
@@ -0,0 +1,21 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @brief Eine eingebettete Datei der Weboberfläche
+ *
+ * Die Tabelle erzeugt tools/build_web_assets.py aus web/ (WebAssets.generated.cpp).
+ * Die Daten liegen im Flash und werden ohne Kopie ausgeliefert.
+ */
+struct WebAsset {
+    const char* path;           // ausgelieferter Pfad, bei gehashten Dateien mit Inhalts-Hash
+    const char* contentType;
+    const char* etag;           // in Anführungszeichen, wie im Header
+    const uint8_t* data;
+    size_t len;
+    bool gzip;                  // data ist gzip-komprimiert
+    bool immutable;             // Pfad ändert sich mit dem Inhalt: unbegrenzt cachebar
+};
+
+extern const WebAsset WEB_ASSETS[];
+extern const size_t WEB_ASSET_COUNT;
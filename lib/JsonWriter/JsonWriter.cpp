@@ -0,0 +1,167 @@
+#include <math.h>
+#include <string.h>
+
+#include "JsonWriter.h"
+
+JsonWriter::JsonWriter(char* buffer, size_t capacity) : buf_(buffer), cap_(capacity) {
+    reset();
+}
+
+void JsonWriter::reset() {
+    len_ = 0;
+    depth_ = 0;
+    needComma_ = 0;
+    afterKey_ = false;
+    ok_ = cap_ > 0;
+    if (ok_) buf_[0] = '\0';
+}
+
+// Ein Byte bleibt immer für das Nullzeichen frei.
+void JsonWriter::put(char c) {
+    if (!ok_ || len_ + 1 >= cap_) {
+        ok_ = false;
+        return;
+    }
+    buf_[len_++] = c;
+    buf_[len_] = '\0';
+}
+
+void JsonWriter::put(const char* s, size_t n) {
+    if (!ok_ || len_ + n >= cap_) {
+        ok_ = false;
+        return;
+    }
+    memcpy(buf_ + len_, s, n);
+    len_ += n;
+    buf_[len_] = '\0';
+}
+
+void JsonWriter::separator() {
+    if (afterKey_) {
+        afterKey_ = false;
+        return;
+    }
+    uint8_t bit = 1u << depth_;
+    if (needComma_ & bit) put(',');
+    needComma_ |= bit;
+}
+
+void JsonWriter::open(char c) {
+    separator();
+    if (depth_ + 1 >= MAX_DEPTH) {
+        ok_ = false;
+        return;
+    }
+    put(c);
+    depth_++;
+    needComma_ &= ~(1u << depth_);
+}
+
+void JsonWriter::close(char c) {
+    if (depth_ == 0) {
+        ok_ = false;
+        return;
+    }
+    depth_--;
+    put(c);
+}
+
+JsonWriter& JsonWriter::beginObject() { open('{'); return *this; }
+JsonWriter& JsonWriter::endObject() { close('}'); return *this; }
+JsonWriter& JsonWriter::beginArray() { open('['); return *this; }
+JsonWriter& JsonWriter::endArray() { close(']'); return *this; }
+
+JsonWriter& JsonWriter::key(const char* name) {
+    value(name);
+    put(':');
+    afterKey_ = true;
+    return *this;
+}
+
+void JsonWriter::putUnsigned(uint64_t v) {
+    char tmp[20];
+    int n = 0;
+    do {
+        tmp[n++] = '0' + (char)(v % 10);
+        v /= 10;
+    } while (v);
+    while (n) put(tmp[--n]);
+}
+
+JsonWriter& JsonWriter::value(long long v) {
+    separator();
+    if (v < 0) {
+        put('-');
+        putUnsigned(0 - (uint64_t)v);
+    } else {
+        putUnsigned((uint64_t)v);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(unsigned long long v) {
+    separator();
+    putUnsigned(v);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(float v, int decimals) {
+    if (isnan(v) || isinf(v)) return null();
+    separator();
+    if (decimals < 0) decimals = 0;
+    if (decimals > 6) decimals = 6;
+
+    static const uint32_t POW10[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+    uint32_t scale = POW10[decimals];
+    double scaled = fabs((double)v) * scale + 0.5;
+    if (scaled >= 9.0e18) {      // passt nicht in Festkomma
+        ok_ = false;
+        return *this;
+    }
+    uint64_t fixed = (uint64_t)scaled;
+    if (v < 0 && fixed != 0) put('-');
+    putUnsigned(fixed / scale);
+    if (decimals > 0) {
+        put('.');
+        uint64_t frac = fixed % scale;
+        for (uint32_t p = scale / 10; p > 0; p /= 10) {
+            put('0' + (char)(frac / p));
+            frac %= p;
+        }
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool v) {
+    separator();
+    if (v) put("true", 4);
+    else put("false", 5);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* s) {
+    separator();
+    put('"');
+    for (; *s; s++) {
+        char c = *s;
+        if (c == '"' || c == '\\') {
+            put('\\');
+            put(c);
+        } else if ((uint8_t)c < 0x20) {
+            static const char HEX[] = "0123456789abcdef";
+            put("\\u00", 4);
+            put(HEX[(c >> 4) & 0xF]);
+            put(HEX[c & 0xF]);
+        } else {
+            put(c);
+        }
+    }
+    put('"');
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separator();
+    put("null", 4);
+    return *this;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Schreibt JSON in einen festen Puffer, ohne Heap
+ *
+ *   char buf[128];
+ *   JsonWriter w(buf, sizeof(buf));
+ *   w.beginObject().key("norm").value(0.42f, 2).key("n").value(17u).endObject();
+ *   if (w.ok()) send(w.c_str(), w.length());
+ *
+ * Kommas setzt der Writer selbst. Läuft der Puffer über, bleibt ok() false und
+ * der Inhalt ist unbrauchbar; es wird nie über das Pufferende geschrieben.
+ */
+class JsonWriter {
+public:
+    static const int MAX_DEPTH = 8;
+
+    JsonWriter(char* buffer, size_t capacity);
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+
+    /** @brief Schlüssel im aktuellen Objekt; der nächste Wert gehört dazu */
+    JsonWriter& key(const char* name);
+
+    // int32_t ist je nach Toolchain int oder long: beide Varianten abdecken
+    JsonWriter& value(long long v);
+    JsonWriter& value(unsigned long long v);
+    JsonWriter& value(int v) { return value((long long)v); }
+    JsonWriter& value(unsigned v) { return value((unsigned long long)v); }
+    JsonWriter& value(long v) { return value((long long)v); }
+    JsonWriter& value(unsigned long v) { return value((unsigned long long)v); }
+    /** @brief Festkommazahl mit decimals Nachkommastellen (0..6); NaN/Inf werden null */
+    JsonWriter& value(float v, int decimals);
+    JsonWriter& value(bool v);
+    JsonWriter& value(const char* s);
+    JsonWriter& null();
+
+    bool ok() const { return ok_; }
+    size_t length() const { return len_; }
+    const char* c_str() const { return buf_; }
+
+    /** @brief Beginnt von vorn im selben Puffer */
+    void reset();
+
+private:
+    char* buf_;
+    size_t cap_;
+    size_t len_ = 0;
+    bool ok_ = true;
+    int depth_ = 0;
+    uint8_t needComma_ = 0;     // Bit n: Ebene n hat schon ein Element
+    bool afterKey_ = false;
+
+    void put(char c);
+    void put(const char* s, size_t n);
+    void separator();
+    void putUnsigned(uint64_t v);
+    void open(char c);
+    void close(char c);
+};
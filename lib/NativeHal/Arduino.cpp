@@ -0,0 +1,201 @@
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+#include "Arduino.h"
+#include "NativeHal.h"
+#include "NativeHalInternal.h"
+
+HardwareSerial Serial;
+
+namespace {
+
+const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+// wächst, wenn virtuelle Zeit der Host-Uhr vorausgelaufen ist
+std::atomic<int64_t> realOffsetUs{0};
+
+const int PIN_COUNT = GPIO_NUM_MAX;
+std::mutex analogMutex;
+int analogValues[PIN_COUNT] = {};
+std::function<int()> analogSources[PIN_COUNT];
+
+std::mutex serialMutex;
+std::deque<uint8_t> serialInput;
+bool serialMuted = false;
+std::function<void()> serialOnReceive;
+std::function<void(const uint8_t*, size_t)> serialOutputTap;
+
+}  // namespace
+
+namespace nativehal {
+
+int64_t nowUs() {
+    int64_t virtualUs = internal::virtualNowUs();
+    return virtualUs >= 0 ? virtualUs : internal::realNowUs();
+}
+
+namespace internal {
+
+int64_t realNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count() + realOffsetUs.load();
+}
+
+void advanceRealClock(int64_t toUs) {
+    int64_t behind = toUs - realNowUs();
+    if (behind > 0) realOffsetUs.fetch_add(behind);
+}
+
+}  // namespace internal
+
+void setAnalogValue(int pin, int raw) {
+    std::lock_guard<std::mutex> lock(analogMutex);
+    analogValues[pin] = raw;
+    analogSources[pin] = nullptr;
+}
+
+void setAnalogSource(int pin, std::function<int()> source) {
+    std::lock_guard<std::mutex> lock(analogMutex);
+    analogSources[pin] = std::move(source);
+}
+
+void serialFeed(const char* data, size_t len) {
+    std::function<void()> cb;
+    {
+        std::lock_guard<std::mutex> lock(serialMutex);
+        serialInput.insert(serialInput.end(), data, data + len);
+        cb = serialOnReceive;
+    }
+    if (cb) cb();
+}
+
+void serialMute(bool mute) {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    serialMuted = mute;
+}
+
+void serialTap(std::function<void(const uint8_t*, size_t)> tap) {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    serialOutputTap = tap;
+}
+
+}  // namespace nativehal
+
+int64_t esp_timer_get_time() {
+    return nativehal::nowUs();
+}
+
+unsigned long millis() {
+    return (unsigned long)(nativehal::nowUs() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)nativehal::nowUs();
+}
+
+void delay(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+uint16_t analogRead(uint8_t pin) {
+    if (pin >= PIN_COUNT) return 0;
+    std::lock_guard<std::mutex> lock(analogMutex);
+    int raw = analogSources[pin] ? analogSources[pin]() : analogValues[pin];
+    if (raw < 0) raw = 0;
+    if (raw > 4095) raw = 4095;
+    return (uint16_t)raw;
+}
+
+void analogReadResolution(uint8_t) {}
+
+void analogSetAttenuation(adc_attenuation_t) {}
+
+// --- Print ---
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+}
+
+size_t Print::print(const char* s) {
+    return write((const uint8_t*)s, strlen(s));
+}
+
+size_t Print::print(char c) {
+    return write((uint8_t)c);
+}
+
+size_t Print::print(int n) {
+    return printf("%d", n);
+}
+
+size_t Print::print(unsigned int n) {
+    return printf("%u", n);
+}
+
+size_t Print::print(long n) {
+    return printf("%ld", n);
+}
+
+size_t Print::print(unsigned long n) {
+    return printf("%lu", n);
+}
+
+size_t Print::print(double n, int digits) {
+    return printf("%.*f", digits, n);
+}
+
+size_t Print::println() {
+    return print("\r\n");
+}
+
+size_t Print::printf(const char* format, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t)len >= sizeof(buf)) len = sizeof(buf) - 1;
+    return write((const uint8_t*)buf, len);
+}
+
+// --- HardwareSerial ---
+void HardwareSerial::begin(unsigned long) {}
+
+void HardwareSerial::onReceive(std::function<void()> function, bool) {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    serialOnReceive = function;
+}
+
+int HardwareSerial::available() {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    return (int)serialInput.size();
+}
+
+int HardwareSerial::read() {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    if (serialInput.empty()) return -1;
+    int c = serialInput.front();
+    serialInput.pop_front();
+    return c;
+}
+
+int HardwareSerial::peek() {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    return serialInput.empty() ? -1 : serialInput.front();
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    {
+        std::lock_guard<std::mutex> lock(serialMutex);
+        if (serialOutputTap) serialOutputTap(buffer, size);
+        if (serialMuted) return size;
+    }
+    return fwrite(buffer, 1, size, stdout);
+}
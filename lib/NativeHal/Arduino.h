@@ -0,0 +1,79 @@
+#pragma once
+// Host-Attrappe für die Arduino-ESP32-Teilmenge, die das Projekt benutzt.
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <functional>
+
+#include "driver/gpio.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+
+typedef enum {
+    ADC_0db,
+    ADC_2_5db,
+    ADC_6db,
+    ADC_11db,
+} adc_attenuation_t;
+
+uint16_t analogRead(uint8_t pin);
+void analogReadResolution(uint8_t bits);
+void analogSetAttenuation(adc_attenuation_t attenuation);
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+
+    size_t print(const char* s);
+    size_t print(char c);
+    size_t print(int n);
+    size_t print(unsigned int n);
+    size_t print(long n);
+    size_t print(unsigned long n);
+    size_t print(double n, int digits = 2);
+    size_t println();
+    template <typename T> size_t println(const T& v) { size_t n = print(v); return n + println(); }
+    size_t println(double n, int digits) { size_t w = print(n, digits); return w + println(); }
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+/** Serial schreibt auf stdout und liest aus nativehal::serialFeed(). */
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud);
+    /** stdout puffert selbst; nur für die Schnittstelle vorhanden */
+    size_t setTxBufferSize(size_t size) { return size; }
+    /** Jeder serialFeed()-Aufruf gilt als ein Empfangsereignis (wie eine Zeile am Stück). */
+    void onReceive(std::function<void()> function, bool onlyOnTimeout = false);
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+};
+
+extern HardwareSerial Serial;
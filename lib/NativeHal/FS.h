@@ -0,0 +1,60 @@
+#pragma once
+// Host-Attrappe für die Datei-API von Arduino-ESP32 (fs::FS, fs::File).
+// Dateien liegen als echte Dateien unter einem Verzeichnis des Hosts, siehe
+// nativehal::littleFsRoot().
+
+#include <stdio.h>
+#include <memory>
+#include <string>
+
+#include "Arduino.h"
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+class File : public Stream {
+public:
+    File() {}
+    File(FILE* f, const std::string& path);
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t read(uint8_t* buffer, size_t size);
+    void flush();
+    bool seek(uint32_t pos);
+    size_t position() const;
+    size_t size() const;
+    void close();
+    const char* path() const { return filePath.c_str(); }
+    explicit operator bool() const { return (bool)handle; }
+
+private:
+    std::shared_ptr<FILE> handle;
+    std::string filePath;
+};
+
+class FS {
+public:
+    explicit FS(const char* mountpoint) : mount(mountpoint) {}
+    virtual ~FS() {}
+
+    File open(const char* path, const char* mode = FILE_READ, bool create = false);
+    bool exists(const char* path);
+    bool remove(const char* path);
+    bool rename(const char* pathFrom, const char* pathTo);
+
+protected:
+    const char* mount;
+    std::string hostPath(const char* path) const;
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
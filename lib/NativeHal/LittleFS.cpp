@@ -0,0 +1,161 @@
+#include <dirent.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include <mutex>
+#include <string>
+
+#include "LittleFS.h"
+#include "NativeHal.h"
+
+fs::LittleFSFS LittleFS;
+
+namespace {
+
+std::mutex rootMutex;
+std::string root;
+
+std::string currentRoot() {
+    std::lock_guard<std::mutex> lock(rootMutex);
+    if (root.empty()) {
+        const char* tmp = getenv("TMPDIR");
+        root = std::string(tmp && *tmp ? tmp : "/tmp") + "/nativehal_littlefs";
+    }
+    return root;
+}
+
+}  // namespace
+
+namespace nativehal {
+
+void littleFsRoot(const char* dir) {
+    std::lock_guard<std::mutex> lock(rootMutex);
+    root = dir ? dir : "";
+}
+
+std::string littleFsRoot() {
+    return currentRoot();
+}
+
+}  // namespace nativehal
+
+namespace fs {
+
+// --- File ---
+
+File::File(FILE* f, const std::string& path) : handle(f, fclose), filePath(path) {}
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+    return handle ? fwrite(buffer, 1, size, handle.get()) : 0;
+}
+
+int File::available() {
+    return handle ? (int)(size() - position()) : 0;
+}
+
+int File::read() {
+    return handle ? fgetc(handle.get()) : -1;
+}
+
+int File::peek() {
+    if (!handle) return -1;
+    int c = fgetc(handle.get());
+    if (c >= 0) ungetc(c, handle.get());
+    return c;
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+    return handle ? fread(buffer, 1, size, handle.get()) : 0;
+}
+
+void File::flush() {
+    if (handle) fflush(handle.get());
+}
+
+bool File::seek(uint32_t pos) {
+    return handle && fseek(handle.get(), pos, SEEK_SET) == 0;
+}
+
+size_t File::position() const {
+    return handle ? (size_t)ftell(handle.get()) : 0;
+}
+
+size_t File::size() const {
+    if (!handle) return 0;
+    fflush(handle.get());
+    struct stat st;
+    return fstat(fileno(handle.get()), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::close() {
+    handle.reset();
+}
+
+// --- FS ---
+
+std::string FS::hostPath(const char* path) const {
+    return currentRoot() + (path[0] == '/' ? "" : "/") + path;
+}
+
+File FS::open(const char* path, const char* mode, bool /*create*/) {
+    std::string p = hostPath(path);
+    // wie auf dem Gerät: "r" als Binärdatei, "w" und "a" legen an
+    std::string m = std::string(mode) + "b";
+    FILE* f = fopen(p.c_str(), m.c_str());
+    return f ? File(f, path) : File();
+}
+
+bool FS::exists(const char* path) {
+    struct stat st;
+    return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) {
+    return ::remove(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo) {
+    return ::rename(hostPath(pathFrom).c_str(), hostPath(pathTo).c_str()) == 0;
+}
+
+bool LittleFSFS::begin(bool, const char*, uint8_t, const char*) {
+    mkdir(currentRoot().c_str(), 0755);
+    return true;
+}
+
+void LittleFSFS::end() {}
+
+bool LittleFSFS::format() {
+    DIR* dir = opendir(currentRoot().c_str());
+    if (!dir) return true;
+    while (struct dirent* e = readdir(dir)) {
+        if (e->d_name[0] == '.') continue;
+        ::remove((currentRoot() + "/" + e->d_name).c_str());
+    }
+    closedir(dir);
+    return true;
+}
+
+size_t LittleFSFS::totalBytes() {
+    return 1536 * 1024;     // Partition "spiffs" in default_8MB.csv
+}
+
+size_t LittleFSFS::usedBytes() {
+    size_t used = 0;
+    DIR* dir = opendir(currentRoot().c_str());
+    if (!dir) return 0;
+    while (struct dirent* e = readdir(dir)) {
+        struct stat st;
+        if (e->d_name[0] != '.' && stat((currentRoot() + "/" + e->d_name).c_str(), &st) == 0) {
+            used += ((size_t)st.st_size + 4095) / 4096 * 4096;
+        }
+    }
+    closedir(dir);
+    return used;
+}
+
+}  // namespace fs
@@ -0,0 +1,24 @@
+#pragma once
+// Host-Attrappe für LittleFS. Das Dateisystem ist immer "gemountet"; Dateien liegen
+// unter nativehal::littleFsRoot().
+
+#include <stdint.h>
+
+#include "FS.h"
+
+namespace fs {
+
+class LittleFSFS : public FS {
+public:
+    LittleFSFS() : FS("/littlefs") {}
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs",
+               uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs");
+    void end();
+    bool format();
+    size_t totalBytes();
+    size_t usedBytes();
+};
+
+}  // namespace fs
+
+extern fs::LittleFSFS LittleFS;
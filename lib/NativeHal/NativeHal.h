@@ -0,0 +1,70 @@
+#pragma once
+// Steuer-Schnittstelle der Host-Attrappen für Benchmarks und Simulation.
+// Auf dem Zielsystem existiert diese Datei nicht.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <string>
+
+#include "driver/twai.h"
+
+namespace nativehal {
+
+// --- Zeit ---
+/** Mikrosekunden seit Programmstart; Grundlage für millis(), micros() und Ticks. */
+int64_t nowUs();
+/** Zeitpunkt, an dem eine Wartezeit von ticks endet: wie in FreeRTOS an der Tick-Grenze. */
+int64_t tickDeadlineUs(uint32_t ticks);
+/** Blockiert den aufrufenden Task bis zum Zeitpunkt; beendet ihn, falls vTaskDelete anliegt. */
+void sleepUntilUs(int64_t deadlineUs);
+/** Beendet den aufrufenden Task, falls vTaskDelete für ihn anliegt. */
+void checkCancelled();
+
+/**
+ * Schaltet auf virtuelle Zeit um (true) oder zurück: die Uhr steht, solange der
+ * aufrufende Thread oder ein danach angelegter Task rechnet, und springt direkt zum
+ * nächsten Weckzeitpunkt, sobald alle in vTaskDelay, ulTaskNotifyTake, twai_receive
+ * usw. blockieren. Abläufe von Minuten dauern so nur so lange, wie sie zu rechnen haben.
+ * Aktives Warten (Schleife ohne blockierenden Aufruf) hält die Uhr an. Ältere Tasks
+ * laufen in Echtzeit weiter, sehen aber die virtuelle Uhr.
+ * Einschalten nur aus einem Thread ohne Task; Ausschalten nur aus demselben Thread,
+ * nachdem alle Tasks aus der virtuellen Zeit beendet sind (sonst false). Danach läuft
+ * die Host-Uhr ab dem erreichten Stand weiter.
+ */
+bool virtualTime(bool on);
+bool isVirtualTime();
+
+// --- ADC ---
+/** Setzt den Rohwert (0..4095), den analogRead(pin) liefert. */
+void setAnalogValue(int pin, int raw);
+/** Ersetzt den Rohwert von analogRead(pin) durch eine Funktion (z. B. Rauschquelle). */
+void setAnalogSource(int pin, std::function<int()> source);
+
+// --- TWAI ---
+/** Wird bei jedem twai_transmit aufgerufen; der Rückgabewert wird an den Aufrufer gereicht. */
+void setTwaiTxHook(std::function<esp_err_t(const twai_message_t&)> hook);
+/** Anzahl bisher erfolgreich gesendeter Frames. */
+uint32_t twaiTxCount();
+/** Zuletzt gesendeter Frame. */
+twai_message_t twaiLastTx();
+/** Stellt einen Frame in die Empfangswarteschlange von twai_receive, sofern er den
+ *  Akzeptanzfilter des installierten Treibers passiert. */
+void twaiInjectRx(const twai_message_t& msg);
+/** Versetzt den laufenden Controller in Bus-Off, als hätte er 256 Sendefehler gezählt. */
+void twaiBusOff();
+
+// --- Serial ---
+/** Hängt Bytes an die Eingabe von Serial an. */
+void serialFeed(const char* data, size_t len);
+/** Unterdrückt (true) oder erlaubt die Ausgabe von Serial auf stdout. */
+void serialMute(bool mute);
+/** Bekommt alles, was auf Serial geschrieben wird, auch bei serialMute(true); nullptr = aus. */
+void serialTap(std::function<void(const uint8_t*, size_t)> tap);
+
+// --- LittleFS ---
+/** Host-Verzeichnis hinter LittleFS; Standard $TMPDIR/nativehal_littlefs */
+void littleFsRoot(const char* dir);
+std::string littleFsRoot();
+
+}  // namespace nativehal
@@ -0,0 +1,32 @@
+#pragma once
+// Nur für die Host-Attrappen selbst: Verbindung zwischen Uhr, Tasks und Treibern.
+
+#include <stdint.h>
+#include <functional>
+
+#include "freertos/task.h"
+
+namespace nativehal {
+namespace internal {
+
+/** Host-Uhr ohne virtuelle Zeit (monoton, auch über Umschaltungen hinweg). */
+int64_t realNowUs();
+/** Verschiebt die Host-Uhr, damit sie nach virtueller Zeit nicht zurückspringt. */
+void advanceRealClock(int64_t toUs);
+
+/** Stand der virtuellen Uhr, -1 wenn sie aus ist. */
+int64_t virtualNowUs();
+/** true, wenn der aufrufende Thread in virtueller Zeit läuft. */
+bool callerVirtual();
+/**
+ * Blockiert den aufrufenden Task in virtueller Zeit, bis ready() true liefert oder
+ * deadlineUs erreicht ist (INT64_MAX = ohne Limit). ready() läuft unter der Sperre der
+ * Uhr und darf dort auch verbrauchen (z. B. den Benachrichtigungszähler).
+ * @return false bei Zeitablauf
+ */
+bool virtualWait(int64_t deadlineUs, const std::function<bool()>& ready);
+/** Lässt task sein ready() erneut prüfen; ohne Wirkung für Tasks in Echtzeit. */
+void virtualWake(TaskHandle_t task);
+
+}  // namespace internal
+}  // namespace nativehal
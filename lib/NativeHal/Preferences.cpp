@@ -0,0 +1,102 @@
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <math.h>
+#include <string.h>
+
+#include "Preferences.h"
+
+namespace {
+
+std::mutex nvsMutex;
+std::map<std::string, std::map<std::string, std::vector<uint8_t>>> nvs;
+
+}  // namespace
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    if (name == nullptr || strlen(name) > 15) return false;
+    ns_ = name;
+    readOnly_ = readOnly;
+    return true;
+}
+
+void Preferences::end() {
+    ns_ = nullptr;
+}
+
+bool Preferences::clear() {
+    if (!ns_ || readOnly_) return false;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    nvs[ns_].clear();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!ns_ || readOnly_) return false;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    return nvs[ns_].erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    if (!ns_) return false;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    return nvs[ns_].count(key) > 0;
+}
+
+size_t Preferences::put(const char* key, const void* value, size_t len) {
+    if (!ns_ || readOnly_ || strlen(key) > 15) return 0;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    const uint8_t* p = static_cast<const uint8_t*>(value);
+    nvs[ns_][key].assign(p, p + len);
+    return len;
+}
+
+bool Preferences::get(const char* key, void* value, size_t len) {
+    if (!ns_) return false;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    auto& space = nvs[ns_];
+    auto it = space.find(key);
+    if (it == space.end() || it->second.size() != len) return false;
+    memcpy(value, it->second.data(), len);
+    return true;
+}
+
+size_t Preferences::putInt(const char* key, int32_t value) { return put(key, &value, sizeof(value)); }
+size_t Preferences::putUInt(const char* key, uint32_t value) { return put(key, &value, sizeof(value)); }
+size_t Preferences::putFloat(const char* key, float value) { return put(key, &value, sizeof(value)); }
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) { return put(key, value, len); }
+
+int32_t Preferences::getInt(const char* key, int32_t defaultValue) {
+    int32_t v;
+    return get(key, &v, sizeof(v)) ? v : defaultValue;
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+    uint32_t v;
+    return get(key, &v, sizeof(v)) ? v : defaultValue;
+}
+
+float Preferences::getFloat(const char* key, float defaultValue) {
+    float v;
+    return get(key, &v, sizeof(v)) ? v : defaultValue;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!ns_) return 0;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    auto& space = nvs[ns_];
+    auto it = space.find(key);
+    return it == space.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    if (!ns_) return 0;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    auto& space = nvs[ns_];
+    auto it = space.find(key);
+    if (it == space.end() || it->second.size() > maxLen) return 0;
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+}
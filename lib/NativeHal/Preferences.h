@@ -0,0 +1,34 @@
+#pragma once
+// Host-Attrappe des NVS-Wrappers: Namensräume leben im RAM des Prozesses.
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false);
+    void end();
+
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putInt(const char* key, int32_t value);
+    size_t putUInt(const char* key, uint32_t value);
+    size_t putFloat(const char* key, float value);
+    size_t putBytes(const char* key, const void* value, size_t len);
+
+    int32_t getInt(const char* key, int32_t defaultValue = 0);
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+    float getFloat(const char* key, float defaultValue = NAN);
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+
+private:
+    const char* ns_ = nullptr;
+    bool readOnly_ = false;
+
+    size_t put(const char* key, const void* value, size_t len);
+    bool get(const char* key, void* value, size_t len);
+};
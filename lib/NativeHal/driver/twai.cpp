@@ -0,0 +1,187 @@
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "driver/twai.h"
+#include "NativeHal.h"
+#include "NativeHalInternal.h"
+
+namespace {
+
+std::mutex busMutex;
+std::condition_variable rxCv;
+std::deque<twai_message_t> rxQueue;
+std::function<esp_err_t(const twai_message_t&)> txHook;
+twai_message_t lastTx{};
+uint32_t txCount = 0;
+twai_status_info_t status{};
+twai_filter_config_t filter = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+bool installed = false;
+TaskHandle_t rxWaiter = nullptr;     // Task in twai_receive, für virtuelle Zeit
+int64_t recoveredUs = 0;             // Ende des Wiederanlaufs
+
+const int64_t RECOVERY_US = 128 * 11 * 2;   // 128 x 11 Bit bei 500 kbit/s
+
+const size_t RX_QUEUE_LEN = 64;
+
+// Einzelfilter wie in der Hardware: erweiterte ID in Bit 31..3, RTR in Bit 2.
+bool acceptedByFilter(const twai_message_t& msg) {
+    if (!filter.single_filter) return true;
+    uint32_t bits = msg.extd ? (msg.identifier << 3) | (msg.rtr ? 0x4u : 0u)
+                             : (msg.identifier << 21) | (msg.rtr ? 0x100000u : 0u);
+    return ((bits ^ filter.acceptance_code) & ~filter.acceptance_mask) == 0;
+}
+
+// Wiederanlauf abgeschlossen? Aufruf mit gehaltener Sperre
+void advanceRecovery() {
+    if (status.state == TWAI_STATE_RECOVERING && nativehal::nowUs() >= recoveredUs) {
+        status.state = TWAI_STATE_STOPPED;
+        status.tx_error_counter = 0;
+        status.rx_error_counter = 0;
+    }
+}
+
+}  // namespace
+
+namespace nativehal {
+
+void setTwaiTxHook(std::function<esp_err_t(const twai_message_t&)> hook) {
+    std::lock_guard<std::mutex> lock(busMutex);
+    txHook = std::move(hook);
+}
+
+uint32_t twaiTxCount() {
+    std::lock_guard<std::mutex> lock(busMutex);
+    return txCount;
+}
+
+twai_message_t twaiLastTx() {
+    std::lock_guard<std::mutex> lock(busMutex);
+    return lastTx;
+}
+
+void twaiInjectRx(const twai_message_t& msg) {
+    TaskHandle_t waiter;
+    {
+        std::lock_guard<std::mutex> lock(busMutex);
+        if (!installed || !acceptedByFilter(msg)) return;
+        if (rxQueue.size() >= RX_QUEUE_LEN) {
+            status.rx_missed_count++;
+            return;
+        }
+        rxQueue.push_back(msg);
+        waiter = rxWaiter;
+    }
+    rxCv.notify_one();
+    internal::virtualWake(waiter);
+}
+
+void twaiBusOff() {
+    std::lock_guard<std::mutex> lock(busMutex);
+    if (!installed || status.state != TWAI_STATE_RUNNING) return;
+    status.state = TWAI_STATE_BUS_OFF;
+    status.tx_error_counter = 256;
+    status.bus_error_count++;
+}
+
+}  // namespace nativehal
+
+esp_err_t twai_driver_install(const twai_general_config_t*, const twai_timing_config_t*,
+                              const twai_filter_config_t* f_config) {
+    std::lock_guard<std::mutex> lock(busMutex);
+    if (installed) return ESP_ERR_INVALID_STATE;
+    installed = true;
+    filter = *f_config;
+    status = twai_status_info_t{};
+    status.state = TWAI_STATE_STOPPED;
+    return ESP_OK;
+}
+
+esp_err_t twai_driver_uninstall() {
+    std::lock_guard<std::mutex> lock(busMutex);
+    installed = false;
+    rxQueue.clear();
+    return ESP_OK;
+}
+
+esp_err_t twai_start() {
+    std::lock_guard<std::mutex> lock(busMutex);
+    advanceRecovery();
+    if (!installed || status.state != TWAI_STATE_STOPPED) return ESP_ERR_INVALID_STATE;
+    status.state = TWAI_STATE_RUNNING;
+    return ESP_OK;
+}
+
+esp_err_t twai_stop() {
+    std::lock_guard<std::mutex> lock(busMutex);
+    status.state = TWAI_STATE_STOPPED;
+    return ESP_OK;
+}
+
+esp_err_t twai_transmit(const twai_message_t* message, TickType_t) {
+    std::function<esp_err_t(const twai_message_t&)> hook;
+    {
+        std::lock_guard<std::mutex> lock(busMutex);
+        if (status.state != TWAI_STATE_RUNNING) return ESP_ERR_INVALID_STATE;
+        hook = txHook;
+    }
+    esp_err_t err = hook ? hook(*message) : ESP_OK;
+    std::lock_guard<std::mutex> lock(busMutex);
+    if (err == ESP_OK) {
+        lastTx = *message;
+        txCount++;
+    } else {
+        status.tx_failed_count++;
+    }
+    return err;
+}
+
+esp_err_t twai_receive(twai_message_t* message, TickType_t ticks_to_wait) {
+    int64_t deadline = ticks_to_wait == portMAX_DELAY
+        ? INT64_MAX
+        : nativehal::tickDeadlineUs(ticks_to_wait);
+    if (nativehal::internal::callerVirtual()) {
+        {
+            std::lock_guard<std::mutex> lock(busMutex);
+            rxWaiter = xTaskGetCurrentTaskHandle();
+        }
+        bool ready = nativehal::internal::virtualWait(deadline, [message] {
+            std::lock_guard<std::mutex> lock(busMutex);
+            if (rxQueue.empty()) return false;
+            *message = rxQueue.front();
+            rxQueue.pop_front();
+            return true;
+        });
+        return ready ? ESP_OK : ESP_ERR_TIMEOUT;
+    }
+    std::unique_lock<std::mutex> lock(busMutex);
+    while (rxQueue.empty()) {
+        // In Scheiben warten, damit vTaskDelete den wartenden Task erreicht.
+        lock.unlock();
+        nativehal::checkCancelled();
+        lock.lock();
+        int64_t remaining = deadline - nativehal::nowUs();
+        if (remaining <= 0) return ESP_ERR_TIMEOUT;
+        rxCv.wait_for(lock, std::chrono::microseconds(remaining < 1000 ? remaining : 1000));
+    }
+    *message = rxQueue.front();
+    rxQueue.pop_front();
+    return ESP_OK;
+}
+
+esp_err_t twai_get_status_info(twai_status_info_t* status_info) {
+    std::lock_guard<std::mutex> lock(busMutex);
+    if (!installed) return ESP_ERR_INVALID_STATE;
+    advanceRecovery();
+    *status_info = status;
+    status_info->msgs_to_rx = rxQueue.size();
+    return ESP_OK;
+}
+
+esp_err_t twai_initiate_recovery() {
+    std::lock_guard<std::mutex> lock(busMutex);
+    if (!installed || status.state != TWAI_STATE_BUS_OFF) return ESP_ERR_INVALID_STATE;
+    status.state = TWAI_STATE_RECOVERING;
+    recoveredUs = nativehal::nowUs() + RECOVERY_US;
+    return ESP_OK;
+}
@@ -0,0 +1,5 @@
+#include "esp_heap_caps.h"
+
+size_t heap_caps_get_free_size(uint32_t) { return 280 * 1024; }
+size_t heap_caps_get_largest_free_block(uint32_t) { return 110 * 1024; }
+size_t heap_caps_get_minimum_free_size(uint32_t) { return 240 * 1024; }
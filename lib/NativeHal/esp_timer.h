@@ -0,0 +1,5 @@
+#pragma once
+#include <stdint.h>
+
+/** Mikrosekunden seit Programmstart (monotone Host-Uhr). */
+int64_t esp_timer_get_time();
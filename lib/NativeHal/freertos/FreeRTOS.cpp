@@ -0,0 +1,364 @@
+#include <pthread.h>
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "freertos/task.h"
+#include "NativeHal.h"
+#include "NativeHalInternal.h"
+
+struct tskTaskControlBlock {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool cancelled = false;
+    uint32_t notifyValue = 0;
+    TaskFunction_t fn = nullptr;
+    void* param = nullptr;
+    const char* name = "";
+    uint32_t stackDepth = 0;
+    UBaseType_t priority = 0;
+    BaseType_t coreId = tskNO_AFFINITY;
+    UBaseType_t number = 0;
+    pthread_t nativeThread;      // gültig, solange der Task in liveTasks steht
+    // nur virtuelle Zeit, geschützt durch die Sperre der Uhr
+    bool virtualTime = false;    // in virtueller Zeit angelegt
+    bool blocked = false;        // wartet in virtualWait
+    int64_t deadline = 0;
+};
+
+namespace {
+
+// Wird geworfen, um einen Task an seinem nächsten blockierenden Aufruf zu beenden.
+struct TaskExit {};
+
+thread_local tskTaskControlBlock* currentTask = nullptr;
+
+// laufende Tasks für uxTaskGetSystemState
+std::mutex liveMutex;
+std::vector<tskTaskControlBlock*> liveTasks;
+UBaseType_t taskNumbers = 0;
+
+void unregisterTask(tskTaskControlBlock* tcb) {
+    std::lock_guard<std::mutex> lock(liveMutex);
+    auto it = std::find(liveTasks.begin(), liveTasks.end(), tcb);
+    if (it != liveTasks.end()) liveTasks.erase(it);
+}
+
+// Virtuelle Zeit: die Uhr steht, solange ein beteiligter Thread läuft, und springt
+// zum nächsten Weckzeitpunkt, sobald alle blockieren. Beteiligt sind der Thread, der
+// sie eingeschaltet hat, und alle danach angelegten Tasks.
+struct VirtualClock {
+    std::mutex mutex;
+    std::atomic<bool> on{false};
+    std::atomic<int64_t> now{0};
+    int running = 0;                                // beteiligte Threads, die nicht blockieren
+    std::vector<tskTaskControlBlock*> blocked;
+};
+VirtualClock vclock;
+tskTaskControlBlock driverTask;                     // steht für den einschaltenden Thread
+
+void unblockLocked(tskTaskControlBlock* tcb) {
+    if (!tcb->blocked) return;
+    tcb->blocked = false;
+    vclock.blocked.erase(std::find(vclock.blocked.begin(), vclock.blocked.end(), tcb));
+    vclock.running++;
+    tcb->cv.notify_all();
+}
+
+// Alle blockieren: zum frühesten Weckzeitpunkt springen. Warten alle ohne Zeitlimit,
+// bleibt die Uhr stehen (wie ein echtes System ohne Ereignis).
+void advanceLocked() {
+    int64_t next = INT64_MAX;
+    for (tskTaskControlBlock* t : vclock.blocked) next = std::min(next, t->deadline);
+    if (next == INT64_MAX) return;
+    if (next > vclock.now.load()) vclock.now.store(next);
+    std::vector<tskTaskControlBlock*> due;
+    for (tskTaskControlBlock* t : vclock.blocked) {
+        if (t->deadline <= next) due.push_back(t);
+    }
+    for (tskTaskControlBlock* t : due) unblockLocked(t);
+}
+
+void leaveVirtualTime() {
+    std::lock_guard<std::mutex> lock(vclock.mutex);
+    if (--vclock.running == 0) advanceLocked();
+}
+
+void trampoline(tskTaskControlBlock* tcb) {
+    currentTask = tcb;
+    {
+        std::lock_guard<std::mutex> lock(liveMutex);
+        tcb->nativeThread = pthread_self();
+        tcb->number = ++taskNumbers;
+        liveTasks.push_back(tcb);
+    }
+    try {
+        tcb->fn(tcb->param);
+    } catch (const TaskExit&) {
+    }
+    unregisterTask(tcb);
+    if (tcb->virtualTime) leaveVirtualTime();
+    // Selbst beendet (oder Funktion zurückgekehrt): niemand wartet auf den Thread.
+    bool cancelledFromOutside;
+    {
+        std::lock_guard<std::mutex> lock(tcb->mutex);
+        cancelledFromOutside = tcb->cancelled;
+    }
+    if (!cancelledFromOutside) {
+        tcb->thread.detach();
+        delete tcb;
+    }
+}
+
+}  // namespace
+
+namespace nativehal {
+
+int64_t tickDeadlineUs(uint32_t ticks) {
+    const int64_t tickUs = portTICK_PERIOD_MS * 1000;
+    return (nowUs() / tickUs + ticks) * tickUs;
+}
+
+void sleepUntilUs(int64_t deadlineUs) {
+    if (internal::callerVirtual()) {
+        internal::virtualWait(deadlineUs, [] { return false; });
+        return;
+    }
+    tskTaskControlBlock* tcb = currentTask;
+    if (tcb == nullptr) {
+        int64_t remaining = deadlineUs - nowUs();
+        if (remaining > 0) std::this_thread::sleep_for(std::chrono::microseconds(remaining));
+        return;
+    }
+    std::unique_lock<std::mutex> lock(tcb->mutex);
+    while (!tcb->cancelled) {
+        int64_t remaining = deadlineUs - nowUs();
+        if (remaining <= 0) return;
+        tcb->cv.wait_for(lock, std::chrono::microseconds(remaining));
+    }
+    throw TaskExit();
+}
+
+void checkCancelled() {
+    tskTaskControlBlock* tcb = currentTask;
+    if (tcb == nullptr) return;
+    std::lock_guard<std::mutex> lock(tcb->mutex);
+    if (tcb->cancelled) throw TaskExit();
+}
+
+bool virtualTime(bool on) {
+    std::lock_guard<std::mutex> lock(vclock.mutex);
+    if (on == vclock.on.load()) return true;
+    if (on) {
+        if (currentTask != nullptr) return false;     // nur aus einem Thread ohne Task
+        vclock.now.store(internal::realNowUs());
+        vclock.running = 1;
+        driverTask.virtualTime = true;
+        currentTask = &driverTask;
+        vclock.on.store(true);
+        return true;
+    }
+    // nur der einschaltende Thread, alle Tasks aus der virtuellen Zeit beendet
+    if (currentTask != &driverTask || vclock.running != 1 || !vclock.blocked.empty()) return false;
+    internal::advanceRealClock(vclock.now.load());
+    vclock.on.store(false);
+    currentTask = nullptr;
+    return true;
+}
+
+bool isVirtualTime() {
+    return vclock.on.load();
+}
+
+namespace internal {
+
+int64_t virtualNowUs() {
+    return vclock.on.load(std::memory_order_acquire) ? vclock.now.load() : -1;
+}
+
+bool callerVirtual() {
+    return currentTask != nullptr && currentTask->virtualTime;
+}
+
+bool virtualWait(int64_t deadlineUs, const std::function<bool()>& ready) {
+    tskTaskControlBlock* tcb = currentTask;
+    std::unique_lock<std::mutex> lock(vclock.mutex);
+    while (true) {
+        {
+            std::lock_guard<std::mutex> taskLock(tcb->mutex);
+            if (tcb->cancelled) throw TaskExit();
+        }
+        if (ready()) return true;
+        if (deadlineUs <= vclock.now.load()) return false;
+        tcb->deadline = deadlineUs;
+        tcb->blocked = true;
+        vclock.blocked.push_back(tcb);
+        if (--vclock.running == 0) advanceLocked();
+        tcb->cv.wait(lock, [tcb] { return !tcb->blocked; });
+    }
+}
+
+void virtualWake(TaskHandle_t task) {
+    if (task == nullptr || !task->virtualTime) return;
+    std::lock_guard<std::mutex> lock(vclock.mutex);
+    unblockLocked(task);
+}
+
+}  // namespace internal
+
+}  // namespace nativehal
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t coreId) {
+    auto* tcb = new tskTaskControlBlock();
+    tcb->fn = fn;
+    tcb->param = param;
+    tcb->name = name;
+    tcb->stackDepth = stackDepth;
+    tcb->priority = priority;
+    tcb->coreId = coreId;
+    if (handle) *handle = tcb;
+    if (nativehal::internal::callerVirtual()) {
+        // läuft ab sofort mit, damit die Uhr nicht vor seinem ersten Schritt springt
+        std::lock_guard<std::mutex> lock(vclock.mutex);
+        tcb->virtualTime = true;
+        vclock.running++;
+    }
+    tcb->thread = std::thread(trampoline, tcb);
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(fn, name, stackDepth, param, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr || task == currentTask) {
+        throw TaskExit();
+    }
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->cancelled = true;
+    }
+    task->cv.notify_all();
+    nativehal::internal::virtualWake(task);
+    task->thread.join();
+    // Der TCB wird bewusst nicht freigegeben: eine Benachrichtigung, die ein anderer
+    // Task noch mit dem alten Handle schickt, darf ins Leere gehen.
+}
+
+void vTaskDelay(TickType_t ticks) {
+    nativehal::sleepUntilUs(nativehal::tickDeadlineUs(ticks));
+}
+
+void vTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment) {
+    *previousWakeTime += increment;
+    nativehal::sleepUntilUs((int64_t)*previousWakeTime * portTICK_PERIOD_MS * 1000);
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(nativehal::nowUs() / (1000 * portTICK_PERIOD_MS));
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return currentTask;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    if (task->virtualTime) {
+        std::lock_guard<std::mutex> lock(vclock.mutex);
+        task->notifyValue++;
+        unblockLocked(task);
+        return pdPASS;
+    }
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->notifyValue++;
+    }
+    task->cv.notify_all();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait) {
+    tskTaskControlBlock* tcb = currentTask;
+    if (tcb == nullptr) return 0;
+    int64_t deadline = ticksToWait == portMAX_DELAY
+        ? INT64_MAX
+        : nativehal::tickDeadlineUs(ticksToWait);
+    if (tcb->virtualTime) {
+        uint32_t value = 0;
+        nativehal::internal::virtualWait(deadline, [tcb, clearCountOnExit, &value] {
+            if (tcb->notifyValue == 0) return false;
+            value = tcb->notifyValue;
+            tcb->notifyValue = clearCountOnExit ? 0 : value - 1;
+            return true;
+        });
+        return value;
+    }
+    std::unique_lock<std::mutex> lock(tcb->mutex);
+    while (tcb->notifyValue == 0) {
+        if (tcb->cancelled) throw TaskExit();
+        if (deadline == INT64_MAX) {
+            // wait_for mit riesiger Dauer läuft in der Zeitumrechnung über
+            tcb->cv.wait(lock);
+            continue;
+        }
+        int64_t remaining = deadline - nativehal::nowUs();
+        if (remaining <= 0) return 0;
+        tcb->cv.wait_for(lock, std::chrono::microseconds(remaining));
+    }
+    uint32_t value = tcb->notifyValue;
+    tcb->notifyValue = clearCountOnExit ? 0 : value - 1;
+    return value;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks() {
+    std::lock_guard<std::mutex> lock(liveMutex);
+    return (UBaseType_t)liveTasks.size();
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t* taskStatusArray, UBaseType_t arraySize, uint32_t* totalRunTime) {
+    std::lock_guard<std::mutex> lock(liveMutex);
+    // wie FreeRTOS: zu kleines Feld liefert nichts
+    if (liveTasks.size() > arraySize) return 0;
+    UBaseType_t n = 0;
+    for (tskTaskControlBlock* tcb : liveTasks) {
+        TaskStatus_t& st = taskStatusArray[n++];
+        st.xHandle = tcb;
+        st.pcTaskName = tcb->name;
+        st.xTaskNumber = tcb->number;
+        st.eCurrentState = tcb == currentTask ? eRunning : eBlocked;
+        st.uxCurrentPriority = st.uxBasePriority = tcb->priority;
+        st.ulRunTimeCounter = 0;
+        clockid_t clock;
+        timespec ts;
+        if (pthread_getcpuclockid(tcb->nativeThread, &clock) == 0 && clock_gettime(clock, &ts) == 0) {
+            st.ulRunTimeCounter = (uint32_t)((int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+        }
+        st.pxStackBase = nullptr;
+        st.usStackHighWaterMark = tcb->stackDepth;
+        st.xCoreID = tcb->coreId;
+    }
+    if (totalRunTime) *totalRunTime = (uint32_t)nativehal::nowUs();
+    return n;
+}
+
+uint32_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    if (task == nullptr) task = currentTask;
+    return task ? task->stackDepth : 0;
+}
+
+BaseType_t xPortGetCoreID() {
+    return currentTask && currentTask->coreId != tskNO_AFFINITY ? currentTask->coreId : 0;
+}
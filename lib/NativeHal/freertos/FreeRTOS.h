@@ -0,0 +1,53 @@
+#pragma once
+// Host-Attrappe für die FreeRTOS-Teilmenge, die das Projekt benutzt.
+// Tasks laufen als std::thread, ein Tick entspricht einer Millisekunde.
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef int32_t  BaseType_t;
+typedef uint32_t UBaseType_t;
+
+#define configTICK_RATE_HZ      1000
+#define portTICK_PERIOD_MS      ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY           ((TickType_t)0xFFFFFFFFUL)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((TickType_t)(ms) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+#define pdTRUE                  ((BaseType_t)1)
+#define pdFALSE                 ((BaseType_t)0)
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+#define tskNO_AFFINITY          0x7FFFFFFF
+
+// Laufzeitstatistik wie im Arduino-Kern des ESP32: uxTaskGetSystemState mit Kern-ID,
+// Laufzeit je Task in Mikrosekunden (auf dem Host: CPU-Zeit des Threads)
+#define configUSE_TRACE_FACILITY        1
+#define configGENERATE_RUN_TIME_STATS   1
+#define configTASKLIST_INCLUDE_COREID   1
+#define portNUM_PROCESSORS              2
+
+// Kritische Abschnitte: auf dem ESP32 ein Spinlock mit gesperrten Interrupts,
+// auf dem Host ein einfacher Spinlock.
+typedef struct {
+    volatile uint32_t owner;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+
+static inline void vPortEnterCritical(portMUX_TYPE* mux) {
+    while (__atomic_exchange_n(&mux->owner, 1u, __ATOMIC_ACQUIRE)) {
+    }
+}
+
+static inline void vPortExitCritical(portMUX_TYPE* mux) {
+    __atomic_store_n(&mux->owner, 0u, __ATOMIC_RELEASE);
+}
+
+#define portENTER_CRITICAL(mux)     vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)      vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux)  vPortExitCritical(mux)
+#define spinlock_initialize(mux)    ((mux)->owner = 0)
+
+/** Kern des aufrufenden Tasks: sein Eintrag aus xTaskCreatePinnedToCore, sonst 0 */
+BaseType_t xPortGetCoreID();
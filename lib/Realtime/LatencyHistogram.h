@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * @brief Log-lineares Histogramm für Zeiten in Mikrosekunden, feste Größe
+ *
+ * Werte unter 16 µs werden exakt gezählt, darüber teilt sich jede Zweierpotenz in
+ * 8 Fächer (höchstens 12,5 % Fehler). Alles ab 2^24 µs landet im letzten Fach.
+ * record() ist für genau einen schreibenden Task gedacht und kostet ein paar
+ * Befehle ohne atomare Lese-Schreib-Operation; Leser dürfen jederzeit auswerten.
+ */
+class LatencyHistogram {
+public:
+    static const uint32_t SUB_BITS = 3;
+    static const uint32_t SUB = 1u << SUB_BITS;
+    static const uint32_t LINEAR = 2 * SUB;          // exakte Fächer 0..15
+    static const uint32_t MAX_MSB = 23;
+    static const uint32_t BUCKETS = LINEAR + (MAX_MSB - SUB_BITS) * SUB;
+
+    struct Summary {
+        uint32_t count;
+        uint32_t p50;
+        uint32_t p99;
+        uint32_t max;
+    };
+
+    LatencyHistogram() { reset(); }
+
+    void record(uint32_t us) {
+        std::atomic<uint32_t>& b = buckets_[bucketOf(us)];
+        b.store(b.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (us > max_.load(std::memory_order_relaxed)) max_.store(us, std::memory_order_relaxed);
+    }
+
+    /** @brief Median, 99. Perzentil (jeweils Obergrenze des Fachs) und Maximum */
+    Summary summary() const {
+        uint32_t counts[BUCKETS];
+        Summary s = {0, 0, 0, max_.load(std::memory_order_relaxed)};
+        for (uint32_t i = 0; i < BUCKETS; i++) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            s.count += counts[i];
+        }
+        if (s.count == 0) return s;
+
+        uint32_t rank50 = (s.count + 1) / 2;
+        uint32_t rank99 = s.count - s.count / 100;
+        uint32_t seen = 0;
+        bool found50 = false;   // p50 == 0 ist ein gültiges Ergebnis (Fach 0)
+        for (uint32_t i = 0; i < BUCKETS; i++) {
+            if (counts[i] == 0) continue;
+            seen += counts[i];
+            if (!found50 && seen >= rank50) {
+                s.p50 = upperBound(i);
+                found50 = true;
+            }
+            if (seen >= rank99) {
+                s.p99 = upperBound(i);
+                break;
+            }
+        }
+        // die Fachgrenze kann über dem tatsächlich gemessenen Maximum liegen
+        if (s.p50 > s.max) s.p50 = s.max;
+        if (s.p99 > s.max) s.p99 = s.max;
+        return s;
+    }
+
+    /** @brief Leert das Histogramm; ein gleichzeitiges record() kann verloren gehen */
+    void reset() {
+        for (uint32_t i = 0; i < BUCKETS; i++) buckets_[i].store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    static uint32_t bucketOf(uint32_t us) {
+        if (us < LINEAR) return us;
+        uint32_t msb = 31 - __builtin_clz(us);
+        if (msb > MAX_MSB) return BUCKETS - 1;
+        return LINEAR + (msb - SUB_BITS - 1) * SUB + ((us >> (msb - SUB_BITS)) & (SUB - 1));
+    }
+
+    /** @brief Größter Wert, der in Fach i fällt */
+    static uint32_t upperBound(uint32_t i) {
+        if (i < LINEAR) return i;
+        uint32_t msb = (i - LINEAR) / SUB + SUB_BITS + 1;
+        uint32_t sub = (i - LINEAR) % SUB;
+        return ((SUB + sub + 1) << (msb - SUB_BITS)) - 1;
+    }
+
+private:
+    std::atomic<uint32_t> buckets_[BUCKETS];
+    std::atomic<uint32_t> max_;
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#include <freertos/FreeRTOS.h>
+
+/**
+ * @brief Sequenzsperre für kleine, trivial kopierbare Zustände
+ *
+ * Leser blockieren nie den Schreiber und wiederholen nur, wenn sie eine
+ * Aktualisierung überlappt haben. Der Schreibvorgang läuft in einem kritischen
+ * Abschnitt: mehrere Schreiber werden dadurch serialisiert, und ein höher
+ * priorisierter Leser auf demselben Kern wartet nie auf einen halb geschriebenen Wert.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "T muss trivial kopierbar sein");
+
+public:
+    SeqLock() {
+        for (size_t i = 0; i < WORDS; i++) words_[i].store(0, std::memory_order_relaxed);
+    }
+
+    /** @brief Veröffentlicht einen neuen Wert */
+    void store(const T& value) {
+        uint32_t words[WORDS] = {};
+        memcpy(words, &value, sizeof(T));
+
+        portENTER_CRITICAL(&mux_);
+        uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) words_[i].store(words[i], std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+        portEXIT_CRITICAL(&mux_);
+    }
+
+    /**
+     * @brief Veröffentlicht value nur, wenn seit version() == expected niemand geschrieben hat
+     * @return false, wenn ein anderer Schreiber zuvorgekommen ist; dann bleibt dessen Wert
+     */
+    bool storeIf(uint32_t expected, const T& value) {
+        uint32_t words[WORDS] = {};
+        memcpy(words, &value, sizeof(T));
+
+        portENTER_CRITICAL(&mux_);
+        uint32_t seq = seq_.load(std::memory_order_relaxed);
+        bool current = seq / 2 == expected;
+        if (current) {
+            seq_.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < WORDS; i++) words_[i].store(words[i], std::memory_order_relaxed);
+            seq_.store(seq + 2, std::memory_order_release);
+        }
+        portEXIT_CRITICAL(&mux_);
+        return current;
+    }
+
+    /** @brief Liefert einen konsistenten Wert */
+    T load() const {
+        uint32_t words[WORDS];
+        uint32_t before, after;
+        do {
+            before = seq_.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; i++) words[i] = words_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = seq_.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        T value;
+        memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    /** @brief Anzahl bisheriger store()-Aufrufe */
+    uint32_t version() const { return seq_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static const size_t WORDS = (sizeof(T) + 3) / 4;
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint32_t> words_[WORDS];
+    portMUX_TYPE mux_ = portMUX_INITIALIZER_UNLOCKED;
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Lock-freier Ringpuffer für genau einen Produzenten und einen Konsumenten
+ * @tparam T Elementtyp (wird kopiert)
+ * @tparam N Kapazität, muss eine Zweierpotenz sein
+ */
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N muss eine Zweierpotenz sein");
+
+public:
+    /** @brief Hängt ein Element an; false, wenn der Puffer voll ist (nur Produzent) */
+    bool push(const T& item) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= N) return false;
+        buf_[head & (N - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Entnimmt das älteste Element; false, wenn der Puffer leer ist (nur Konsument) */
+    bool pop(T& item) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return false;
+        item = buf_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Aktuelle Füllmenge (Momentaufnahme, von beiden Seiten lesbar) */
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    static constexpr size_t capacity() { return N; }
+
+private:
+    T buf_[N];
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+};
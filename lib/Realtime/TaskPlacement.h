@@ -0,0 +1,63 @@
+#pragma once
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/**
+ * @brief Kern, Priorität und Stack eines Tasks
+ *
+ * Alle Tasks des Projekts stehen unten in einer Tabelle, damit sich Kernaufteilung und
+ * Prioritäten an einer Stelle prüfen lassen.
+ */
+struct TaskPlacement {
+    const char* name;
+    uint32_t stackBytes;
+    UBaseType_t priority;
+    BaseType_t core;
+};
+
+/** @brief Legt einen Task nach seinem Tabelleneintrag an */
+inline BaseType_t startTask(TaskFunction_t fn, const TaskPlacement& placement, void* param, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(fn, placement.name, placement.stackBytes, param,
+                                   placement.priority, handle, placement.core);
+}
+
+// Kern 1 gehört allein dem Regelpfad: Messung -> Drehzahl -> CAN und die Sollwerte vom PC.
+// Kern 0 nimmt alles andere: WiFi, AsyncTCP, loop(), Dateisystem, Protokolle und Diagnose
+// (dafür die Build-Flags in platformio.ini). Prioritäten auf Kern 1 rate-monoton, die
+// Glieder einer Kette über ihrem Erzeuger, damit ein Ereignis ohne Umweg durchläuft.
+// Was dort darunter läuft, bekommt nur die Lücken.
+static const BaseType_t CONTROL_CORE = 1;
+static const BaseType_t SYSTEM_CORE = 0;
+
+// --- Kern 1 ---
+// geweckt vom Joystick nach jeder Messung (200 Hz), verdrängt ihn sofort
+static const TaskPlacement TASK_CONTROL = {"control", 2048, 7, CONTROL_CORE};
+// fertiger Frame an den Bus, verdrängt danach den Regeltask
+static const TaskPlacement TASK_VESC_TX = {"vesc_tx", 2048, 6, CONTROL_CORE};
+// 200 Durchgänge/s, alle Achsen eines Joystick bzw. JoystickAxes in einem
+static const TaskPlacement TASK_JOYSTICK = {"JoystickReader", 4096, 5, CONTROL_CORE};
+// STATUS-Frames, je Controller 50..100 Hz
+static const TaskPlacement TASK_VESC_RX = {"vesc_rx", 2048, 4, CONTROL_CORE};
+// Auffrischung alle 10..500 ms
+static const TaskPlacement TASK_VESC_HEARTBEAT = {"vesc_heartbeat", 3072, 3, CONTROL_CORE};
+// Zeilen und Binärrahmen vom PC: dekodiert die Sollwerte, Textbefehle in den Lücken
+static const TaskPlacement TASK_SERIAL_COMMANDS = {"serialcmd", 4096, 1, CONTROL_CORE};
+
+// --- Kern 0 ---
+// Zustand des CAN-Controllers alle 100 ms, Wiederanlauf nach Bus-Off: kurz, aber vor dem Rest
+static const TaskPlacement TASK_VESC_BUS = {"vesc_bus", 2560, 2, SYSTEM_CORE};
+// Telemetrie und PONG an den PC, Zeitüberwachung der PC-Sollwerte
+static const TaskPlacement TASK_BINARY_LINK = {"binlink", 3072, 1, SYSTEM_CORE};
+static const TaskPlacement TASK_TELEMETRY = {"telemetry", 4096, 1, SYSTEM_CORE};
+static const TaskPlacement TASK_CAN_TRACE = {"cantrace", 3072, 1, SYSTEM_CORE};
+static const TaskPlacement TASK_FLIGHT_LOG = {"flightlog", 2048, 1, SYSTEM_CORE};
+static const TaskPlacement TASK_FLIGHT_LOG_WRITER = {"flightlog_wr", 3072, 0, SYSTEM_CORE};
+static const TaskPlacement TASK_PROFILER = {"profiler", 3072, 1, SYSTEM_CORE};
+// Selbstkalibrierung: ein Block alle 0,32 s, schreibt selten ins NVS
+static const TaskPlacement TASK_JOYSTICK_CAL = {"joystick_cal", 3072, 1, SYSTEM_CORE};
+
+// Messfühler des Profilers: je Kern ein Task auf der Priorität des Joystick-Tasks
+static const TaskPlacement TASK_PROBE[2] = {
+    {"probe0", 2048, TASK_JOYSTICK.priority, 0},
+    {"probe1", 2048, TASK_JOYSTICK.priority, 1},
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <Arduino.h>
+
+#include "SerialCommands.h"
+#include "TaskPlacement.h"
+
+/**
+ * @brief Verarbeitet Befehle in einem eigenen Task statt durch Abfragen in loop()
+ *
+ * Der Task schläft, bis der UART-Ereignis-Task des Arduino-Kerns meldet, dass die
+ * Leitung nach empfangenen Zeichen still geworden ist (HardwareSerial::onReceive mit
+ * onlyOnTimeout), also in der Regel einmal pro Zeile. Dann liest ReadSerial() alles
+ * Angekommene und ruft die Handler auf, die damit in diesem Task laufen.
+ */
+class SerialCommandTask {
+public:
+    SerialCommandTask(HardwareSerial& serial, SerialCommands& commands)
+        : serial(serial), commands(commands) {}
+
+    /** @brief Startet den Task; die Befehle müssen vorher registriert sein */
+    void begin(const TaskPlacement& placement = TASK_SERIAL_COMMANDS) {
+        if (taskHandle != nullptr) return;
+        startTask(taskWrapper, placement, this, &taskHandle);
+        serial.onReceive([this]() { xTaskNotifyGive(taskHandle); }, true);
+        // was vor dem Einhängen schon im Puffer lag
+        xTaskNotifyGive(taskHandle);
+    }
+
+    /** @brief Anzahl der Weckungen, zur Kontrolle gegen die Zahl der Zeilen */
+    uint32_t wakeups() const { return wakes; }
+
+private:
+    HardwareSerial& serial;
+    SerialCommands& commands;
+    TaskHandle_t taskHandle = nullptr;
+    volatile uint32_t wakes = 0;
+
+    static void taskWrapper(void* param) {
+        static_cast<SerialCommandTask*>(param)->commandTask();
+    }
+
+    void commandTask() {
+        while (true) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            wakes = wakes + 1;
+            commands.ReadSerial();
+        }
+    }
+};
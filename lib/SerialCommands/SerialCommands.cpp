@@ -6,7 +6,7 @@ Repository	: https://github.com/ppedro74/Arduino-SerialCommands
 
 #include "SerialCommands.h"
 
-void SerialCommands::AddCommand(SerialCommand* command)
+bool SerialCommands::AddCommand(SerialCommand* command)
 {
 #ifdef SERIAL_COMMANDS_DEBUG
 	Serial.print("Adding #");
@@ -20,29 +20,122 @@ void SerialCommands::AddCommand(SerialCommand* command)
 	}
 	Serial.println();
 #endif
-	// Default linked list is commands_????
-	SerialCommand** cmd_head=&commands_head_;
-	SerialCommand** cmd_tail=&commands_tail_;
-	uint8_t *cmd_count = &commands_count_;
+	command->hash = Hash(command->command);
+	command->next = NULL;
 
 	if(command->one_key)
 	{
-		// For a one_key command, we switch to the onek_cmds_???? list
-		cmd_head = &onek_cmds_head_;
-		cmd_tail = &onek_cmds_tail_;
-		cmd_count = &onek_cmds_count_;
+		// one_key commands are matched by their first character only: keep a list
+		if (onek_cmds_head_ == NULL)
+		{
+			onek_cmds_head_ = onek_cmds_tail_ = command;
+		}
+		else
+		{
+			onek_cmds_tail_->next = command;
+			onek_cmds_tail_ = command;
+		}
+		onek_cmds_count_++;
+		return true;
 	}
-	command->next = NULL;
-	if (*cmd_head == NULL)
+
+	// Keep one slot free so that a lookup of an unknown command always terminates
+	if (commands_count_ >= SERIAL_COMMANDS_TABLE_SIZE - 1 || Find(command->command, command->hash) != NULL)
+	{
+#ifdef SERIAL_COMMANDS_DEBUG
+		Serial.println("Command table full or duplicate command");
+#endif
+		return false;
+	}
+
+	uint32_t slot = command->hash & (SERIAL_COMMANDS_TABLE_SIZE - 1);
+	while (commands_[slot] != NULL)
+	{
+		slot = (slot + 1) & (SERIAL_COMMANDS_TABLE_SIZE - 1);
+	}
+	commands_[slot] = command;
+	commands_count_++;
+	return true;
+}
+
+uint32_t SerialCommands::Hash(const char* str)
+{
+	uint32_t hash = 2166136261u;
+	while (*str)
+	{
+		hash = (hash ^ (uint8_t)*str++) * 16777619u;
+	}
+	return hash;
+}
+
+SerialCommand* SerialCommands::Find(const char* command, uint32_t hash) const
+{
+	uint32_t slot = hash & (SERIAL_COMMANDS_TABLE_SIZE - 1);
+	while (commands_[slot] != NULL)
 	{
-		*cmd_head = *cmd_tail = command;
+		SerialCommand* cmd = commands_[slot];
+		if (cmd->hash == hash && strcmp(cmd->command, command) == 0)
+		{
+			return cmd;
+		}
+		slot = (slot + 1) & (SERIAL_COMMANDS_TABLE_SIZE - 1);
 	}
-	else
+	return NULL;
+}
+
+char* SerialCommands::Tokenize(uint32_t& hash)
+{
+	char* p = buffer_;
+	char* command = NULL;
+	arg_count_ = 0;
+	arg_pos_ = 0;
+
+	while (*p != '\0')
 	{
-		(*cmd_tail)->next = command;
-		*cmd_tail = command;
+		// skip delimiters, then cut out one token
+		while (*p != '\0' && strchr(delim_, *p) != NULL)
+		{
+			p++;
+		}
+		if (*p == '\0')
+		{
+			break;
+		}
+		char* token = p;
+		while (*p != '\0' && strchr(delim_, *p) == NULL)
+		{
+			p++;
+		}
+		if (*p != '\0')
+		{
+			*p++ = '\0';
+		}
+
+		if (command == NULL)
+		{
+			command = token;
+			hash = Hash(token);
+			continue;
+		}
+		if (arg_count_ >= SERIAL_COMMANDS_MAX_ARGS)
+		{
+			break;
+		}
+
+		SerialArgument& arg = args_[arg_count_++];
+		char* end;
+		arg.str = token;
+		arg.int_value = strtol(token, &end, 10);
+		arg.is_int = *end == '\0';
+		arg.float_value = strtof(token, &end);
+		arg.is_float = *end == '\0';
+		if (arg.is_int)
+		{
+			arg.float_value = (float)arg.int_value;
+			arg.is_float = true;
+		}
 	}
-	(*cmd_count)++;
+	return command;
 }
 
 SERIAL_COMMANDS_ERRORS SerialCommands::ReadSerial()
@@ -75,7 +168,17 @@ SERIAL_COMMANDS_ERRORS SerialCommands::ReadSerial()
 		}
 		Serial.println();
 #endif
-		if (ch <= 0)
+		if (ch < 0)
+		{
+			continue;
+		}
+
+		if (byte_filter_ != NULL && byte_filter_(byte_filter_context_, (uint8_t)ch))
+		{
+			continue;
+		}
+
+		if (ch == 0)
 		{
 			continue;
 		}
@@ -113,34 +216,21 @@ SERIAL_COMMANDS_ERRORS SerialCommands::ReadSerial()
 			Serial.print(buffer_);
 			Serial.println("]");
 #endif
-			char* command = strtok_r(buffer_, delim_, &last_token_);
+			uint32_t hash = 0;
+			char* command = Tokenize(hash);
 			if (command != NULL)
 			{
-				boolean matched = false;
-				int cx;
-				SerialCommand* cmd;
-				for (cmd = commands_head_, cx = 0; cmd != NULL; cmd = cmd->next, cx++)
-				{
-#ifdef SERIAL_COMMANDS_DEBUG
-					Serial.print("Comparing [");
-					Serial.print(command);
-					Serial.print("] to [");
-					Serial.print(cmd->command);
-					Serial.println("]");
-#endif
-
-					if (strncmp(command, cmd->command, strlen(cmd->command) + 1) == 0)
-					{
+				SerialCommand* cmd = Find(command, hash);
 #ifdef SERIAL_COMMANDS_DEBUG
-						Serial.print("Matched #");
-						Serial.println(cx);
+				Serial.print(cmd != NULL ? "Matched [" : "No match for [");
+				Serial.print(command);
+				Serial.println("]");
 #endif
-						cmd->function(this);
-						matched = true;
-						break;
-					}
+				if (cmd != NULL)
+				{
+					cmd->function(this);
 				}
-				if (!matched && default_handler_ != NULL)
+				else if (default_handler_ != NULL)
 				{
 					(*default_handler_)(this, command);
 				}
@@ -206,14 +296,66 @@ void SerialCommands::SetDefaultHandler(void(*function)(SerialCommands*, const ch
 	default_handler_ = function;
 }
 
+void SerialCommands::SetByteFilter(bool(*function)(void*, uint8_t), void* context)
+{
+	byte_filter_context_ = context;
+	byte_filter_ = function;
+}
+
 void SerialCommands::ClearBuffer()
 {
 	buffer_[0] = '\0';
 	buffer_pos_ = 0;
 	term_pos_ = 0;
+	arg_count_ = 0;
+	arg_pos_ = 0;
 }
 
 char* SerialCommands::Next()
 {
-	return strtok_r(NULL, delim_, &last_token_);
+	if (arg_pos_ >= arg_count_)
+	{
+		return NULL;
+	}
+	return (char*)args_[arg_pos_++].str;
+}
+
+bool SerialCommands::NextInt(long& value)
+{
+	if (arg_pos_ >= arg_count_)
+	{
+		return false;
+	}
+	const SerialArgument& arg = args_[arg_pos_++];
+	if (!arg.is_int)
+	{
+		return false;
+	}
+	value = arg.int_value;
+	return true;
+}
+
+bool SerialCommands::NextFloat(float& value)
+{
+	if (arg_pos_ >= arg_count_)
+	{
+		return false;
+	}
+	const SerialArgument& arg = args_[arg_pos_++];
+	if (!arg.is_float)
+	{
+		return false;
+	}
+	value = arg.float_value;
+	return true;
+}
+
+uint8_t SerialCommands::ArgCount() const
+{
+	return arg_count_;
+}
+
+const SerialArgument* SerialCommands::Arg(uint8_t index) const
+{
+	return index < arg_count_ ? &args_[index] : NULL;
 }
@@ -11,6 +11,16 @@ Repository	: https://github.com/ppedro74/Arduino-SerialCommands
 
 #include <Arduino.h>
 
+// Size of the command hash table (power of two); at most this many commands can be added
+#ifndef SERIAL_COMMANDS_TABLE_SIZE
+#define SERIAL_COMMANDS_TABLE_SIZE 64
+#endif
+
+// Arguments after the command that are tokenized and parsed; further ones are ignored
+#ifndef SERIAL_COMMANDS_MAX_ARGS
+#define SERIAL_COMMANDS_MAX_ARGS 8
+#endif
+
 typedef enum ternary 
 {
 	SERIAL_COMMANDS_SUCCESS = 0,
@@ -28,7 +38,8 @@ public:
 		: command(cmd),
 		function(func),
 		next(NULL),
-		one_key(one_k)
+		one_key(one_k),
+		hash(0)
 	{
 	}
 
@@ -36,6 +47,20 @@ public:
 	void(*function)(SerialCommands*);
 	SerialCommand* next;
 	bool one_key;
+	uint32_t hash;	// set by AddCommand
+};
+
+/**
+ * \brief One argument of the current line, parsed once when the line is tokenized
+ */
+class SerialArgument
+{
+public:
+	const char* str;
+	long int_value;		// valid if is_int
+	float float_value;	// valid if is_float (also set for integers)
+	bool is_int;
+	bool is_float;
 };
 
 class SerialCommands
@@ -48,24 +73,28 @@ public:
 		term_(term),
 		delim_(delim),
 		default_handler_(NULL),
+		byte_filter_(NULL),
+		byte_filter_context_(NULL),
 		buffer_pos_(0),
-		last_token_(NULL), 
 		term_pos_(0),
-		commands_head_(NULL),
-		commands_tail_(NULL),
 		onek_cmds_head_(NULL),
 		onek_cmds_tail_(NULL),
 		commands_count_(0),
-		onek_cmds_count_(0)
+		onek_cmds_count_(0),
+		arg_count_(0),
+		arg_pos_(0)
 	{
+		memset(commands_, 0, sizeof(commands_));
 	}
 
 
 	/**
-	 * \brief Adds a command handler (Uses a linked list)
+	 * \brief Adds a command handler. Regular commands go into a hash table, so dispatch
+	 *		  costs the same no matter how many commands are registered.
 	 * \param command 
+	 * \return false if the table is full or the command name is already taken
 	 */
-	void AddCommand(SerialCommand* command);
+	bool AddCommand(SerialCommand* command);
 
 	/**
 	 * \brief Checks the Serial port, reads the input buffer and calls a matching command handler.
@@ -95,6 +124,14 @@ public:
 	 * \param function 
 	 */
 	void SetDefaultHandler(void(*function)(SerialCommands*, const char*));
+
+	/**
+	 * \brief Sets a filter that sees every received byte first, e.g. for binary frames
+	 *		  sharing the port. Bytes for which it returns true are not used for commands.
+	 * \param function NULL removes the filter
+	 * \param context passed back to the filter
+	 */
+	void SetByteFilter(bool(*function)(void*, uint8_t), void* context);
 	
 	/**
 	 * \brief Clears the buffer, and resets the indexes.
@@ -107,6 +144,34 @@ public:
 	 */
 	char* Next();
 
+	/**
+	 * \brief Gets the next argument as integer
+	 * \return false if no argument is available or it is not an integer
+	 */
+	bool NextInt(long& value);
+
+	/**
+	 * \brief Gets the next argument as number (integer or decimal)
+	 * \return false if no argument is available or it is not a number
+	 */
+	bool NextFloat(float& value);
+
+	/**
+	 * \brief Number of arguments of the current line (without the command)
+	 */
+	uint8_t ArgCount() const;
+
+	/**
+	 * \brief Gets an argument of the current line by position, independent of Next()
+	 * \return NULL if index is out of range
+	 */
+	const SerialArgument* Arg(uint8_t index) const;
+
+	/**
+	 * \brief FNV-1a hash of a command name as used by the command table
+	 */
+	static uint32_t Hash(const char* str);
+
 private:
 	Stream* serial_;
 	char* buffer_;
@@ -114,15 +179,30 @@ private:
 	const char* term_;
 	const char* delim_;
 	void(*default_handler_)(SerialCommands*, const char*);
+	bool(*byte_filter_)(void*, uint8_t);
+	void* byte_filter_context_;
 	int16_t buffer_pos_;
-	char* last_token_;
 	int8_t term_pos_;
-	SerialCommand* commands_head_;
-	SerialCommand* commands_tail_;
+	SerialCommand* commands_[SERIAL_COMMANDS_TABLE_SIZE];	// open addressing, linear probing
 	SerialCommand* onek_cmds_head_;
 	SerialCommand* onek_cmds_tail_;
 	uint8_t commands_count_;
 	uint8_t onek_cmds_count_;
+	SerialArgument args_[SERIAL_COMMANDS_MAX_ARGS];
+	uint8_t arg_count_;
+	uint8_t arg_pos_;
+
+	/**
+	 * \brief Splits the line into command and arguments and parses the arguments
+	 * \return the command or NULL for an empty line; hash receives its hash
+	 */
+	char* Tokenize(uint32_t& hash);
+
+	/**
+	 * \brief Looks up a regular command
+	 * \return NULL if not found
+	 */
+	SerialCommand* Find(const char* command, uint32_t hash) const;
 
 	/**
 	 * \brief Tests for any one_key command and execute it if found
@@ -0,0 +1,146 @@
+#include "TaskProfiler.h"
+#include "TaskPlacement.h"
+
+// Reihenfolge der Liste: Kern 0, Kern 1, ungebunden; darin höhere Priorität zuerst
+static bool listedBefore(const TaskLoad& a, const TaskLoad& b) {
+    int ca = a.core < 0 ? TaskProfiler::CORES : a.core;
+    int cb = b.core < 0 ? TaskProfiler::CORES : b.core;
+    if (ca != cb) return ca < cb;
+    return a.priority > b.priority;
+}
+
+TaskProfiler::TaskProfiler() {
+    for (int c = 0; c < CORES; c++) {
+        coreLoads[c].store(CPU_UNKNOWN, std::memory_order_relaxed);
+        probes[c].core = c;
+        probes[c].handle = nullptr;
+    }
+}
+
+TaskProfiler::~TaskProfiler() {
+    if (taskHandle) {
+        vTaskDelete(taskHandle);
+        taskHandle = nullptr;
+    }
+    for (Probe& p : probes) {
+        if (p.handle) {
+            vTaskDelete(p.handle);
+            p.handle = nullptr;
+        }
+    }
+}
+
+void TaskProfiler::begin() {
+    if (taskHandle) return;
+    for (int c = 0; c < CORES; c++) startTask(probeWrapper, TASK_PROBE[c], &probes[c], &probes[c].handle);
+    startTask(taskWrapper, TASK_PROFILER, this, &taskHandle);
+}
+
+void TaskProfiler::resetLatency() {
+    for (Probe& p : probes) p.latency.reset();
+}
+
+void TaskProfiler::sample() {
+#if configUSE_TRACE_FACILITY
+    uint32_t total = 0;
+    int n = (int)uxTaskGetSystemState(status, MAX_SYSTEM_TASKS, &total);
+    uint32_t span = total - prevTotal;
+    uint32_t idle[CORES] = {};
+    uint32_t pinned[CORES] = {};
+    bool haveIdle[CORES] = {};
+
+    for (int i = 0; i < n; i++) {
+        const TaskStatus_t& st = status[i];
+        TaskLoad& t = work[i];
+        strncpy(t.name, st.pcTaskName, sizeof(t.name) - 1);
+        t.name[sizeof(t.name) - 1] = '\0';
+        t.core = -1;
+#if configTASKLIST_INCLUDE_COREID
+        if (st.xCoreID >= 0 && st.xCoreID < CORES) t.core = (int8_t)st.xCoreID;
+#endif
+        t.priority = (uint8_t)st.uxCurrentPriority;
+        t.stackFree = st.usStackHighWaterMark;
+        t.cpuPermille = CPU_UNKNOWN;
+#if configGENERATE_RUN_TIME_STATS
+        // neue Tasks zählen ab ihrem Start
+        uint32_t prev = 0;
+        for (int j = 0; j < prevCount; j++) {
+            if (prevNumber[j] == st.xTaskNumber) {
+                prev = prevRunTime[j];
+                break;
+            }
+        }
+        if (span > 0) {
+            uint64_t permille = (uint64_t)(st.ulRunTimeCounter - prev) * 1000 / span;
+            t.cpuPermille = (uint16_t)(permille > 1000 ? 1000 : permille);
+            if (t.core >= 0) {
+                if (strncmp(t.name, "IDLE", 4) == 0) {
+                    idle[t.core] += t.cpuPermille;
+                    haveIdle[t.core] = true;
+                } else {
+                    pinned[t.core] += t.cpuPermille;
+                }
+            }
+        }
+#endif
+    }
+
+    for (int i = 0; i < n; i++) {
+        prevNumber[i] = status[i].xTaskNumber;
+        prevRunTime[i] = status[i].ulRunTimeCounter;
+    }
+    prevCount = n;
+    prevTotal = total;
+
+    for (int i = 1; i < n; i++) {
+        TaskLoad t = work[i];
+        int j = i;
+        for (; j > 0 && listedBefore(t, work[j - 1]); j--) work[j] = work[j - 1];
+        work[j] = t;
+    }
+    int shown = n < MAX_TASKS ? n : MAX_TASKS;
+    for (int i = 0; i < shown; i++) tasks[i].store(work[i]);
+    count.store(shown, std::memory_order_release);
+
+#if configGENERATE_RUN_TIME_STATS
+    for (int c = 0; c < CORES; c++) {
+        uint32_t load = haveIdle[c] ? (idle[c] < 1000 ? 1000 - idle[c] : 0) : pinned[c];
+        coreLoads[c].store((uint16_t)(load > 1000 ? 1000 : load), std::memory_order_relaxed);
+    }
+#endif
+#endif
+}
+
+void TaskProfiler::taskWrapper(void* param) {
+    static_cast<TaskProfiler*>(param)->profilerTask();
+}
+
+void TaskProfiler::probeWrapper(void* param) {
+    probeTask(*static_cast<Probe*>(param));
+}
+
+void TaskProfiler::profilerTask() {
+    TickType_t wake = xTaskGetTickCount();
+    while (true) {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(INTERVAL_MS));
+        sample();
+    }
+}
+
+void TaskProfiler::probeTask(Probe& probe) {
+    const int64_t periodUs = (int64_t)PROBE_PERIOD_MS * 1000;
+    TickType_t wake = xTaskGetTickCount();
+    int64_t phase = 0;      // frühester gesehener Weckzeitpunkt, auf die erste Runde zurückgerechnet
+    uint32_t rounds = 0;
+    while (true) {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(PROBE_PERIOD_MS));
+        int64_t now = esp_timer_get_time();
+        int64_t due = phase + (int64_t)rounds * periodUs;
+        if (rounds == 0 || now < due) {
+            phase = now - (int64_t)rounds * periodUs;
+            due = now;
+        }
+        probe.latency.record((uint32_t)(now - due));
+        rounds++;
+    }
+}
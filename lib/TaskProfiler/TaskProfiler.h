@@ -0,0 +1,98 @@
+#pragma once
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <atomic>
+
+#include "LatencyHistogram.h"
+#include "SeqLock.h"
+
+/** @brief Auslastung und Stack eines Tasks im letzten Messintervall, 24 Bytes */
+struct TaskLoad {
+    char name[16];
+    int8_t core;            // -1: an keinen Kern gebunden oder unbekannt
+    uint8_t priority;
+    uint16_t cpuPermille;   // Anteil eines Kerns; TaskProfiler::CPU_UNKNOWN ohne Laufzeitstatistik
+    uint32_t stackFree;     // kleinster freier Stack seit dem Start, Bytes
+};
+
+/**
+ * @brief Laufzeitprofil aller Tasks und Planungslatenz je Kern
+ *
+ * Ein Task auf dem Systemkern liest alle INTERVAL_MS die Laufzeitstatistik von FreeRTOS
+ * (uxTaskGetSystemState) und rechnet die Zähler in Promille eines Kerns im Intervall um.
+ * Dazu kommen Priorität, Kern und der kleinste je gesehene freie Stack. Bezug ist die
+ * Gesamtlaufzeit derselben Statistik, so passen die Einheiten unabhängig davon, ob das
+ * IDF sie mit esp_timer oder dem Taktzähler führt. Die Kernlast ist 1000 minus Anteil
+ * des IDLE-Tasks, ohne IDLE-Task (Host) die Summe der an den Kern gebundenen Tasks.
+ * Ohne configGENERATE_RUN_TIME_STATS bleibt die CPU-Spalte CPU_UNKNOWN, ohne
+ * configUSE_TRACE_FACILITY die Liste leer.
+ *
+ * Die Planungslatenz misst je Kern ein Fühler-Task auf der Priorität des Joystick-Tasks:
+ * Er wacht alle PROBE_PERIOD_MS per vTaskDelayUntil auf und zeichnet auf, wie weit er
+ * hinter der frühesten je gesehenen Phase liegt. Das ist die Zeit, die ein Task dieser
+ * Priorität nach seinem Tick auf den Kern wartet (Interrupts, kritische Abschnitte,
+ * höhere Priorität).
+ *
+ * Jede Zeile der Liste wird einzeln veröffentlicht; ein Leser kann Zeilen aus zwei
+ * aufeinanderfolgenden Intervallen mischen, eine einzelne Zeile ist immer konsistent.
+ */
+class TaskProfiler {
+public:
+    static const int MAX_TASKS = 32;
+    static const uint32_t INTERVAL_MS = 1000;
+    static const uint32_t PROBE_PERIOD_MS = 2;
+    static const uint16_t CPU_UNKNOWN = 0xFFFF;
+    static const int CORES = 2;
+
+    TaskProfiler();
+    ~TaskProfiler();
+
+    /** @brief Startet den Profiler-Task und die Fühler auf beiden Kernen */
+    void begin();
+
+    /** @brief Tasks im letzten Intervall, nach Kern und absteigender Priorität sortiert */
+    int taskCount() const { return count.load(std::memory_order_acquire); }
+    TaskLoad task(int i) const { return tasks[i].load(); }
+
+    /** @brief Last eines Kerns in Promille ohne IDLE; CPU_UNKNOWN ohne Laufzeitstatistik */
+    uint16_t coreLoad(int core) const { return coreLoads[core].load(std::memory_order_relaxed); }
+
+    /** @brief Verspätung der Fühler-Weckungen in us seit dem letzten resetLatency() */
+    const LatencyHistogram& schedulingLatency(int core) const { return probes[core].latency; }
+    void resetLatency();
+
+    /** @brief Ein Messintervall auswerten; läuft im Profiler-Task, öffentlich für Host-Benchmarks */
+    void sample();
+
+private:
+    // Feld für uxTaskGetSystemState: dort liefert ein zu kleines Feld gar nichts
+    static const int MAX_SYSTEM_TASKS = 48;
+
+    struct Probe {
+        int core;
+        TaskHandle_t handle;
+        LatencyHistogram latency;
+    };
+
+    SeqLock<TaskLoad> tasks[MAX_TASKS];
+    std::atomic<int> count{0};
+    std::atomic<uint16_t> coreLoads[CORES];
+    Probe probes[CORES];
+
+    // nur im Profiler-Task
+#if configUSE_TRACE_FACILITY
+    TaskStatus_t status[MAX_SYSTEM_TASKS];
+#endif
+    UBaseType_t prevNumber[MAX_SYSTEM_TASKS];
+    uint32_t prevRunTime[MAX_SYSTEM_TASKS];
+    int prevCount = 0;
+    uint32_t prevTotal = 0;
+    TaskLoad work[MAX_SYSTEM_TASKS];
+
+    TaskHandle_t taskHandle = nullptr;
+
+    static void taskWrapper(void* param);
+    static void probeWrapper(void* param);
+    void profilerTask();
+    static void probeTask(Probe& probe);
+};
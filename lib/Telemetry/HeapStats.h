@@ -0,0 +1,28 @@
+#pragma once
+#include <esp_heap_caps.h>
+#include <stdint.h>
+
+/**
+ * @brief Zustand des internen Heaps
+ *
+ * Fragmentierung = Anteil des freien Speichers, der nicht im größten freien Block
+ * liegt. Steigt sie über Tage, obwohl der freie Speicher gleich bleibt, zerstückeln
+ * kurzlebige Allokationen den Heap.
+ */
+struct HeapStats {
+    uint32_t freeBytes;
+    uint32_t largestBlock;
+    uint32_t minFreeBytes;          // Tiefststand seit dem Start
+    uint16_t fragmentationPermille; // 0 = ein zusammenhängender Block
+};
+
+inline HeapStats readHeapStats() {
+    HeapStats st;
+    st.freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    st.largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    st.minFreeBytes = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    st.fragmentationPermille = st.freeBytes
+        ? (uint16_t)(1000 - (uint64_t)st.largestBlock * 1000 / st.freeBytes)
+        : 0;
+    return st;
+}
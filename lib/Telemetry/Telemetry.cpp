@@ -0,0 +1,67 @@
+#include "Telemetry.h"
+
+void collectTelemetry(Joystick& js, VescCan& vesc, uint8_t controller_id, TelemetrySample& sample) {
+    sample.timeMs = millis();
+    sample.js = js.getSnapshot();
+    sample.voltage = js.toVolts(sample.js.raw);
+
+    VescCommand cmd;
+    sample.hasSetpoint = vesc.getSetpoint(controller_id, cmd, sample.setpoint);
+
+    sample.hasStatus = vesc.getStatus(controller_id, sample.status) && sample.status.updatedMs != 0;
+    sample.statusAgeMs = sample.hasStatus ? sample.timeMs - sample.status.updatedMs : 0;
+
+    VescCan::TxStats tx = vesc.txStats();
+    sample.txSent = tx.sent;
+    sample.txFailed = tx.failed;
+    sample.txDrops = tx.drops;
+    sample.heap = readHeapStats();
+}
+
+void writeTelemetryJson(const TelemetrySample& s, JsonWriter& w) {
+    // JSON kennt kein NaN: unkalibriert wird zu null
+    w.beginObject()
+        .key("t").value(s.timeMs)
+        .key("norm").value(s.js.calibrated ? q15ToFloat(s.js.value) : NAN, 3)
+        .key("volt").value(s.voltage, 3)
+        .key("n").value(s.js.samples);
+
+    w.key("rpm");
+    if (s.hasSetpoint) w.value(s.setpoint);
+    else w.null();
+
+    w.key("vesc");
+    if (s.hasStatus) {
+        w.beginObject()
+            .key("erpm").value(s.status.erpm)
+            .key("cur").value(s.status.current, 1)
+            .key("duty").value(s.status.duty, 3)
+            .key("vin").value(s.status.inputVoltage, 1)
+            .key("tfet").value(s.status.tempFet, 1)
+            .key("tmot").value(s.status.tempMotor, 1)
+            .key("age").value(s.statusAgeMs)
+            .endObject();
+    } else {
+        w.null();
+    }
+
+    w.key("can").beginObject()
+        .key("sent").value(s.txSent)
+        .key("failed").value(s.txFailed)
+        .key("drops").value(s.txDrops)
+        .endObject();
+
+    w.key("heap").beginObject()
+        .key("free").value(s.heap.freeBytes)
+        .key("largest").value(s.heap.largestBlock)
+        .key("frag").value(s.heap.fragmentationPermille)
+        .endObject();
+
+    w.endObject();
+}
+
+size_t encodeTelemetryJson(const TelemetrySample& s, char* out, size_t capacity) {
+    JsonWriter w(out, capacity);
+    writeTelemetryJson(s, w);
+    return w.ok() ? w.length() : 0;
+}
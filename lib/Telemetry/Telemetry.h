@@ -0,0 +1,40 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "HeapStats.h"
+#include "Joystick.h"
+#include "JsonWriter.h"
+#include "VescCan.h"
+
+/**
+ * @brief Ein Telemetrie-Takt: Joystick, Sollwert und Rückmeldung eines Controllers
+ *
+ * Wird einmal pro Takt gesammelt und kodiert; alle Web-Clients erhalten dieselben Bytes.
+ */
+struct TelemetrySample {
+    uint32_t timeMs;
+    JoystickSnapshot js;
+    float voltage;              // js.raw in Volt, nur für die Anzeige
+    bool hasSetpoint;
+    int32_t setpoint;           // skaliert wie im Frame (SET_RPM: eRPM)
+    bool hasStatus;
+    VescStatus status;
+    uint32_t statusAgeMs;
+    uint32_t txSent;
+    uint32_t txFailed;
+    uint32_t txDrops;
+    HeapStats heap;
+};
+
+/** @brief Sammelt den aktuellen Zustand; liest nur veröffentlichte Schnappschüsse */
+void collectTelemetry(Joystick& js, VescCan& vesc, uint8_t controller_id, TelemetrySample& sample);
+
+/** @brief Schreibt einen Takt als JSON-Objekt */
+void writeTelemetryJson(const TelemetrySample& sample, JsonWriter& w);
+
+/**
+ * @brief Kodiert einen Takt als JSON in einen festen Puffer
+ * @return Länge ohne Nullzeichen, 0 wenn der Puffer zu klein ist
+ */
+size_t encodeTelemetryJson(const TelemetrySample& sample, char* out, size_t capacity);
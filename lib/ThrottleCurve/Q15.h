@@ -0,0 +1,20 @@
+#pragma once
+#include <math.h>
+#include <stdint.h>
+
+// Festkomma Q15: -1.0 .. 1.0 als -32767 .. 32767 (-32768 wird wie -32767 behandelt)
+typedef int16_t q15_t;
+
+static const q15_t Q15_ONE = 32767;
+
+/** @brief Float (-1..1) -> Q15, mit Begrenzung; NaN wird 0 */
+inline q15_t q15FromFloat(float x) {
+    if (!(x == x)) return 0;
+    if (x >= 1.0f) return Q15_ONE;
+    if (x <= -1.0f) return -Q15_ONE;
+    return (q15_t)lrintf(x * (float)Q15_ONE);
+}
+
+inline float q15ToFloat(q15_t q) {
+    return q * (1.0f / Q15_ONE);
+}
@@ -0,0 +1,159 @@
+#include <Arduino.h>
+#include <math.h>
+
+#include "ThrottleCurve.h"
+
+// Tabellenposition: obere Bits Index, untere FRAC_BITS Anteil zum nächsten Eintrag
+static const int FRAC_BITS = 8;
+static const uint32_t POS_MAX = (uint32_t)(ThrottleCurve::TABLE_SIZE - 1) << FRAC_BITS;
+
+ThrottleCurve::ThrottleCurve(const CurveConfig& config) {
+    CurveConfig checked = config;
+    sanitize(checked);
+    compile(checked, tables[0]);
+}
+
+bool ThrottleCurve::sanitize(CurveConfig& cfg) {
+    bool ok = true;
+    CurveSide* sides[2] = {&cfg.forward, &cfg.reverse};
+    for (CurveSide* s : sides) {
+        if (!(s->deadband >= 0.0f)) { s->deadband = 0.0f; ok = false; }
+        if (s->deadband > 0.5f) { s->deadband = 0.5f; ok = false; }
+
+        if (s->minRpm < 0) { s->minRpm = 0; ok = false; }
+        if (s->maxRpm < s->minRpm) { s->maxRpm = s->minRpm; ok = false; }
+
+        if (!(s->expo >= 0.0f)) { s->expo = 0.0f; ok = false; }
+        if (s->expo > 1.0f) { s->expo = 1.0f; ok = false; }
+
+        if (s->points > CurveSide::MAX_POINTS) { s->points = CurveSide::MAX_POINTS; ok = false; }
+        float lastX = 0.0f;
+        for (uint8_t i = 0; i < s->points; i++) {
+            CurvePoint& p = s->point[i];
+            // ohne streng steigende x gibt es keinen Polygonzug: Stützstellen verwerfen
+            if (!(p.x > lastX && p.x < 1.0f)) {
+                s->points = 0;
+                ok = false;
+                break;
+            }
+            lastX = p.x;
+            if (!(p.y >= 0.0f)) { p.y = 0.0f; ok = false; }
+            if (p.y > 1.0f) { p.y = 1.0f; ok = false; }
+        }
+    }
+    return ok;
+}
+
+// Verlauf hinter dem Totband: t = 0..1 -> 0..1
+float ThrottleCurve::shape(const CurveSide& side, float t) {
+    if (side.points == 0) {
+        return (1.0f - side.expo) * t + side.expo * t * t * t;
+    }
+    float x0 = 0.0f, y0 = 0.0f;
+    for (uint8_t i = 0; i <= side.points; i++) {
+        float x1 = i < side.points ? side.point[i].x : 1.0f;
+        float y1 = i < side.points ? side.point[i].y : 1.0f;
+        if (t <= x1) return y0 + (y1 - y0) * (t - x0) / (x1 - x0);
+        x0 = x1;
+        y0 = y1;
+    }
+    return 1.0f;
+}
+
+float ThrottleCurve::evaluate(const CurveConfig& cfg, float x) {
+    const CurveSide& side = x < 0.0f ? cfg.reverse : cfg.forward;
+    float mag = fabsf(x);
+    if (mag > 1.0f) mag = 1.0f;
+    if (!(mag > side.deadband)) return 0.0f;
+    float t = (mag - side.deadband) / (1.0f - side.deadband);
+    float rpm = side.minRpm + shape(side, t) * (side.maxRpm - side.minRpm);
+    return x < 0.0f ? -rpm : rpm;
+}
+
+void ThrottleCurve::compile(const CurveConfig& cfg, Table& table) {
+    table.cfg = cfg;
+    const CurveSide* sides[2] = {&cfg.forward, &cfg.reverse};
+    for (int s = 0; s < 2; s++) {
+        const CurveSide& side = *sides[s];
+        q15_t db = q15FromFloat(side.deadband);
+        table.deadband[s].store(db, std::memory_order_relaxed);
+        // aufgerundet, damit Vollausschlag genau den letzten Eintrag trifft
+        uint32_t span = Q15_ONE - db;
+        table.scale[s].store((uint32_t)((((uint64_t)POS_MAX << 16) + span - 1) / span),
+                             std::memory_order_relaxed);
+
+        for (int i = 0; i < TABLE_SIZE; i++) {
+            float t = (float)i / (TABLE_SIZE - 1);
+            int32_t rpm = lroundf(side.minRpm + shape(side, t) * (side.maxRpm - side.minRpm));
+            table.rpm[s][i].store(rpm, std::memory_order_relaxed);
+        }
+    }
+}
+
+// Schreiber (Web-, Serial-Task) untereinander ausschließen; map() ist davon nicht betroffen
+void ThrottleCurve::lockWriter() const {
+    while (writing.exchange(true, std::memory_order_acquire)) {
+        vTaskDelay(1);
+    }
+}
+
+void ThrottleCurve::unlockWriter() const {
+    writing.store(false, std::memory_order_release);
+}
+
+bool ThrottleCurve::setCurve(const CurveConfig& config) {
+    CurveConfig checked = config;
+    bool ok = sanitize(checked);
+
+    lockWriter();
+    uint32_t s = seq.load(std::memory_order_relaxed);
+    seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    uint8_t spare = active.load(std::memory_order_relaxed) ^ 1;
+    compile(checked, tables[spare]);
+    active.store(spare, std::memory_order_release);
+    seq.store(s + 2, std::memory_order_release);
+    unlockWriter();
+    return ok;
+}
+
+CurveConfig ThrottleCurve::curve() const {
+    lockWriter();
+    CurveConfig cfg = tables[active.load(std::memory_order_relaxed)].cfg;
+    unlockWriter();
+    return cfg;
+}
+
+// Liest nur relaxed: gültig ist das Ergebnis erst, wenn map() die Folgenummer prüft.
+// Auch mit halb geschriebenen Werten bleiben alle Indizes innerhalb der Tabelle.
+int32_t ThrottleCurve::lookup(const Table& table, int s, int32_t mag) {
+    int32_t db = table.deadband[s].load(std::memory_order_relaxed);
+    if (mag <= db) return 0;
+    uint32_t scale = table.scale[s].load(std::memory_order_relaxed);
+    uint32_t pos = (uint32_t)(((uint64_t)(mag - db) * scale) >> 16);
+    if (pos >= POS_MAX) return table.rpm[s][TABLE_SIZE - 1].load(std::memory_order_relaxed);
+
+    uint32_t i = pos >> FRAC_BITS;
+    int32_t frac = pos & ((1 << FRAC_BITS) - 1);
+    int32_t y0 = table.rpm[s][i].load(std::memory_order_relaxed);
+    int32_t y1 = table.rpm[s][i + 1].load(std::memory_order_relaxed);
+    return y0 + (((y1 - y0) * frac) >> FRAC_BITS);
+}
+
+int32_t ThrottleCurve::map(q15_t x) const {
+    int s = x < 0;
+    int32_t mag = s ? -(int32_t)x : x;
+    if (mag > Q15_ONE) mag = Q15_ONE;
+
+    // Die gelesene Tabelle wird frühestens beim übernächsten setCurve() überschrieben
+    int32_t rpm;
+    uint32_t before, after;
+    do {
+        before = seq.load(std::memory_order_acquire);
+        rpm = lookup(tables[active.load(std::memory_order_acquire)], s, mag);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = seq.load(std::memory_order_relaxed);
+    } while (after - before >= 2);
+
+    return s ? -rpm : rpm;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+#include "Q15.h"
+
+/** @brief Stützstelle einer Kennlinie hinter dem Totband */
+struct CurvePoint {
+    float x;    ///< Weg hinter dem Totband, 0..1
+    float y;    ///< Anteil zwischen minRpm und maxRpm, 0..1
+};
+
+/**
+ * @brief Kennlinie einer Richtung
+ *
+ * Bis zur Totbandgrenze wird 0 ausgegeben, direkt dahinter springt die Drehzahl auf
+ * minRpm und steigt bis Vollausschlag auf maxRpm. Dazwischen gilt die expo-Kurve oder,
+ * wenn Stützstellen angegeben sind, der Polygonzug (0,0) - Stützstellen - (1,1).
+ */
+struct CurveSide {
+    static const uint8_t MAX_POINTS = 6;
+
+    float deadband = 0.0f;          ///< Auslenkung (0..0.5), bis zu der 0 U/min gilt
+    int32_t minRpm = 1000;          ///< Drehzahl direkt hinter dem Totband
+    int32_t maxRpm = 4000;          ///< Drehzahl bei Vollausschlag
+    float expo = 0.0f;              ///< 0 = linear, 1 = kubisch (feinfühliger am Anfang)
+    uint8_t points = 0;             ///< Anzahl Stützstellen, 0 = expo-Kurve
+    CurvePoint point[MAX_POINTS] = {};  ///< x streng steigend in (0,1)
+};
+
+/** @brief Kennlinie für Vorwärts (positiver Ausschlag) und Rückwärts, Drehzahlen als Betrag */
+struct CurveConfig {
+    CurveSide forward;
+    CurveSide reverse;
+};
+
+/**
+ * @brief Joystick-Kennlinie als Q15-Tabelle mit linearer Interpolation
+ *
+ * setCurve() rechnet die Kennlinie im aufrufenden Task in die Reservetabelle um und
+ * schaltet dann auf sie um. map() rechnet nur mit Ganzzahlen und wartet nie auf den
+ * Schreiber: es liest die alte oder die neue Tabelle und wiederholt nur, wenn während
+ * des Nachschlagens zweimal umgeschaltet wurde (wie bei SeqLock).
+ */
+class ThrottleCurve {
+public:
+    static const int TABLE_BITS = 7;
+    static const int TABLE_SIZE = (1 << TABLE_BITS) + 1;
+
+    explicit ThrottleCurve(const CurveConfig& config = CurveConfig());
+
+    /**
+     * @brief Übernimmt eine neue Kennlinie
+     * @return false, wenn Werte außerhalb der Grenzen lagen (sie werden begrenzt)
+     */
+    bool setCurve(const CurveConfig& config);
+    CurveConfig curve() const;
+
+    /** @brief Begrenzt Einstellungen auf gültige Werte; false, wenn etwas geändert wurde */
+    static bool sanitize(CurveConfig& config);
+
+    /** @brief Normierter Ausschlag -> Drehzahl (negativ für rückwärts) */
+    int32_t map(q15_t x) const;
+
+    /** @brief Dieselbe Kennlinie direkt in Float gerechnet, ohne Tabelle */
+    static float evaluate(const CurveConfig& config, float x);
+
+private:
+    // Einträge atomar (relaxed), weil map() sie während eines Umschreibens lesen darf
+    struct Table {
+        CurveConfig cfg;                              // nur unter lockWriter()
+        std::atomic<int32_t> deadband[2];             // Q15; Index 0 vorwärts, 1 rückwärts
+        std::atomic<uint32_t> scale[2];               // (Ausschlag - Totband) -> Tabellenposition, Q16
+        std::atomic<int32_t> rpm[2][TABLE_SIZE];
+    };
+
+    Table tables[2];
+    std::atomic<uint8_t> active{0};
+    std::atomic<uint32_t> seq{0};                     // ungerade während setCurve()
+    mutable std::atomic<bool> writing{false};
+
+    static float shape(const CurveSide& side, float t);
+    static void compile(const CurveConfig& config, Table& table);
+    static int32_t lookup(const Table& table, int s, int32_t mag);
+    void lockWriter() const;
+    void unlockWriter() const;
+};
@@ -0,0 +1,80 @@
+#include "CanTxQueue.h"
+
+int CanTxQueue::findSlot(uint32_t id) {
+    for (int i = 0; i < slotCount_; i++) {
+        if (slots_[i].id == id) return i;
+    }
+    if (slotCount_ == SLOT_COUNT) return -1;
+    slots_[slotCount_].id = id;
+    return slotCount_++;
+}
+
+bool CanTxQueue::pushEntry(const Entry& entry) {
+    if (!ring_.push(entry)) {
+        drops_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    size_t depth = ring_.size();
+    if (depth > highWater_.load(std::memory_order_relaxed)) {
+        highWater_.store(depth, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool CanTxQueue::push(const CanFrame& frame, bool coalesce) {
+    bool ok = true;
+    portENTER_CRITICAL(&producerMux_);
+
+    int slot = coalesce ? findSlot(frame.id) : -1;
+    if (slot < 0) {
+        // kein Slot (mehr) frei: als gewöhnlicher Frame anhängen
+        Entry entry;
+        entry.frame = frame;
+        entry.slot = -1;
+        ok = pushEntry(entry);
+    } else {
+        Slot& s = slots_[slot];
+        Payload p;
+        p.len = frame.len;
+        memcpy(p.data, frame.data, sizeof(p.data));
+        p.originUs = frame.originUs;
+        p.queuedUs = frame.queuedUs;
+        s.payload.store(p);
+
+        if (s.pending.exchange(true, std::memory_order_acq_rel)) {
+            // Vorgänger wartet noch und sendet nun den neuen Inhalt
+            coalesced_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            Entry entry;
+            entry.frame.id = frame.id;
+            entry.frame.len = 0;
+            entry.slot = (int8_t)slot;
+            ok = pushEntry(entry);
+            if (!ok) s.pending.store(false, std::memory_order_release);
+        }
+    }
+
+    portEXIT_CRITICAL(&producerMux_);
+    return ok;
+}
+
+bool CanTxQueue::pop(CanFrame& frame) {
+    Entry entry;
+    if (!ring_.pop(entry)) return false;
+    if (entry.slot < 0) {
+        frame = entry.frame;
+        return true;
+    }
+
+    // Erst freigeben, dann lesen: ein Sollwert, der danach eintrifft, wird neu eingereiht
+    // und geht damit garantiert noch raus.
+    Slot& s = slots_[entry.slot];
+    s.pending.exchange(false, std::memory_order_acq_rel);
+    Payload p = s.payload.load();
+    frame.id = s.id;
+    frame.len = p.len;
+    memcpy(frame.data, p.data, sizeof(frame.data));
+    frame.originUs = p.originUs;
+    frame.queuedUs = p.queuedUs;
+    return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+#include "SeqLock.h"
+#include "SpscRing.h"
+
+/** @brief Ein CAN-Frame mit erweiterter ID, wie er an twai_transmit geht */
+struct CanFrame {
+    uint32_t id;
+    uint8_t len;
+    uint8_t data[8];
+    uint32_t originUs;      // esp_timer-Zeit der auslösenden Messung (Latenzmessung), 0 = keine
+    uint32_t queuedUs;      // esp_timer-Zeit beim Einreihen, nur zusammen mit originUs
+};
+
+/**
+ * @brief Sendewarteschlange zwischen Aufrufern und dem CAN-Sendetask
+ *
+ * Frames laufen über einen lock-freien SPSC-Ring. Sollwert-Frames (coalesce=true)
+ * belegen pro erweiterter ID — also pro (Kommando, Controller) — einen Slot: solange
+ * der Slot noch auf den Versand wartet, wird nur sein Inhalt überschrieben, sodass
+ * immer der neueste Wert als nächstes rausgeht und der Ring nicht mit veralteten
+ * Sollwerten vollläuft.
+ *
+ * Es gibt mehrere Produzenten (loop(), Heartbeat-Task, ...). Sie werden durch einen
+ * kurzen kritischen Abschnitt serialisiert, der nie auf den Bus wartet. Der einzige
+ * Konsument ist der Sendetask und kommt ohne Sperre aus.
+ */
+class CanTxQueue {
+public:
+    static const size_t RING_SIZE = 32;
+    static const int SLOT_COUNT = 16;
+
+    /**
+     * @brief Reiht einen Frame ein, blockiert nie
+     * @param coalesce true: wartenden Frame mit gleicher ID ersetzen statt anzuhängen
+     * @return false, wenn der Frame verworfen wurde (Ring voll)
+     */
+    bool push(const CanFrame& frame, bool coalesce);
+
+    /** @brief Entnimmt den nächsten zu sendenden Frame (nur Sendetask) */
+    bool pop(CanFrame& frame);
+
+    /** @brief Aktuelle Anzahl wartender Frames */
+    size_t depth() const { return ring_.size(); }
+    /** @brief Höchste bisher beobachtete Anzahl wartender Frames */
+    size_t highWater() const { return highWater_.load(std::memory_order_relaxed); }
+    /** @brief Verworfene Frames, weil der Ring voll war */
+    uint32_t drops() const { return drops_.load(std::memory_order_relaxed); }
+    /** @brief Sollwerte, die einen noch wartenden Vorgänger überschrieben haben */
+    uint32_t coalesced() const { return coalesced_.load(std::memory_order_relaxed); }
+
+private:
+    struct Payload {
+        uint8_t len;
+        uint8_t data[8];
+        uint32_t originUs;
+        uint32_t queuedUs;
+    };
+
+    struct Slot {
+        uint32_t id = 0;
+        SeqLock<Payload> payload;
+        std::atomic<bool> pending{false};
+    };
+
+    struct Entry {
+        CanFrame frame;
+        int8_t slot;    // -1: Frame steht direkt im Eintrag
+    };
+
+    SpscRing<Entry, RING_SIZE> ring_;
+    Slot slots_[SLOT_COUNT];
+    int slotCount_ = 0;
+    portMUX_TYPE producerMux_ = portMUX_INITIALIZER_UNLOCKED;
+
+    std::atomic<size_t> highWater_{0};
+    std::atomic<uint32_t> drops_{0};
+    std::atomic<uint32_t> coalesced_{0};
+
+    int findSlot(uint32_t id);
+    bool pushEntry(const Entry& entry);
+};
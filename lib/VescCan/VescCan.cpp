@@ -1,112 +1,307 @@
+#include <esp_timer.h>
+
 #include "VescCan.h"
+#include "TaskPlacement.h"
+
+VescCan::VescCan(gpio_num_t tx_pin, gpio_num_t rx_pin, int baud)
+    : open_ok(false), txPin(tx_pin), rxPin(rx_pin), baudRate(baud) {
+    memset(slotById, -1, sizeof(slotById));
+}
+
+VescCan::~VescCan() {
+    stopHeartbeatTask();
+    if (busTaskHandle) {
+        vTaskDelete(busTaskHandle);
+        busTaskHandle = nullptr;
+    }
+    if (txTaskHandle) {
+        vTaskDelete(txTaskHandle);
+        txTaskHandle = nullptr;
+    }
+    if (rxTaskHandle) {
+        vTaskDelete(rxTaskHandle);
+        rxTaskHandle = nullptr;
+    }
+    if (open_ok) {
+        twai_stop();
+        twai_driver_uninstall();
+    }
+}
 
-static const uint32_t CAN_PACKET_SET_DUTY     = 0;
-static const uint32_t CAN_PACKET_SET_CURRENT  = 1;
-static const uint32_t CAN_PACKET_SET_RPM      = 3;
-static const uint32_t CAN_PACKET_HEARTBEAT    = 9;
+bool VescCan::addController(uint8_t controller_id, int refresh_ms) {
+    if (slotById[controller_id] >= 0) return setRefreshPeriod(controller_id, refresh_ms);
+    if (open_ok || controllerCount == MAX_CONTROLLERS) return false;
+    Controller &c = controllers[controllerCount];
+    c.id = controller_id;
+    c.setpoint.store(Setpoint{SETPOINT_NONE, 0, 0});
+    c.refreshMs.store(refresh_ms > 0 ? refresh_ms : 0, std::memory_order_relaxed);
+    memset(&c.work, 0, sizeof(c.work));
+    slotById[controller_id] = controllerCount++;
+    return true;
+}
+
+// VESC-Frames tragen die Absender-ID in den Bits 0..7 und das Paket in den Bits 8..15.
+// Ein einzelner Filter vergleicht die Bits 16..28 (immer 0) und alle Bits der
+// Absender-ID, in denen die angemeldeten Controller übereinstimmen. Bei einem Controller
+// ist das exakt, bei mehreren eine Obermenge, die handleRx() nachprüft.
+twai_filter_config_t VescCan::rxFilter() const {
+    if (controllerCount == 0) {
+        twai_filter_config_t f = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+        return f;
+    }
+    uint8_t agree = 0xFF;
+    for (int i = 1; i < controllerCount; i++) agree &= ~(controllers[i].id ^ controllers[0].id);
+
+    uint32_t compare = 0x1FFF0000u | agree;        // 1 = Bit wird verglichen
+    twai_filter_config_t f;
+    f.acceptance_code = (uint32_t)(controllers[0].id & agree) << 3;                // RTR = 0
+    f.acceptance_mask = (~compare & 0x1FFFFFFFu) << 3 | 0x3;                    // 1 = egal
+    f.single_filter = true;
+    return f;
+}
+
+bool VescCan::begin() {
+    if (open_ok) return true;
 
-VescCan::VescCan(gpio_num_t tx_pin, gpio_num_t rx_pin, int baud) : open_ok(false) {
-    twai_general_config_t g_config = TWAI_GENERAL_CONFIG_DEFAULT(tx_pin, rx_pin, TWAI_MODE_NORMAL);
+    twai_general_config_t g_config = TWAI_GENERAL_CONFIG_DEFAULT(txPin, rxPin, TWAI_MODE_NORMAL);
 
     twai_timing_config_t t_config;
-    if (baud == 250000) {
+    if (baudRate == 250000) {
         t_config = TWAI_TIMING_CONFIG_250KBITS();
-    } else if (baud == 1000000) {
+    } else if (baudRate == 1000000) {
         t_config = TWAI_TIMING_CONFIG_1MBITS();
     } else {
         t_config = TWAI_TIMING_CONFIG_500KBITS();
     }
 
-    twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+    twai_filter_config_t f_config = rxFilter();
 
-    if (twai_driver_install(&g_config, &t_config, &f_config) == ESP_OK &&
-        twai_start() == ESP_OK) {
-        open_ok = true;
-    }
-}
-
-VescCan::~VescCan() {
-    stopHeartbeatTask();
-    if (open_ok) {
-        twai_stop();
+    if (twai_driver_install(&g_config, &t_config, &f_config) != ESP_OK) return false;
+    if (twai_start() != ESP_OK) {
         twai_driver_uninstall();
+        return false;
     }
+    open_ok = true;
+    busUp.store(true, std::memory_order_relaxed);
+    busWork.state = BUS_ACTIVE;
+    busWork.refreshStretch = 1;
+    health.store(busWork);
+
+    startTask(txTask, TASK_VESC_TX, this, &txTaskHandle);
+    startTask(rxTask, TASK_VESC_RX, this, &rxTaskHandle);
+    startTask(busTask, TASK_VESC_BUS, this, &busTaskHandle);
+    return true;
 }
 
 bool VescCan::isOpen() const {
-    return open_ok;
+    return open_ok && busUp.load(std::memory_order_relaxed);
 }
 
-void VescCan::appendInt32BE(uint8_t *buf, int32_t val) {
-    buf[0] = (val >> 24) & 0xFF;
-    buf[1] = (val >> 16) & 0xFF;
-    buf[2] = (val >> 8)  & 0xFF;
-    buf[3] = val & 0xFF;
+bool VescCan::enqueueFrame(const CanFrame &frame, bool coalesce) {
+    if (!open_ok) return false;
+    return txQueue.push(frame, coalesce);
 }
 
-bool VescCan::sendCanFrame(uint32_t extended_id, const uint8_t *data, uint8_t len) {
-    if (!open_ok) return false;
+bool VescCan::sendFrame(const CanFrame &frame, bool coalesce) {
+    if (!enqueueFrame(frame, coalesce)) return false;
+    if (txTaskHandle) xTaskNotifyGive(txTaskHandle);
+    return true;
+}
+
+bool VescCan::transmitFrame(const CanFrame &frame) {
     twai_message_t msg{};
-    msg.identifier = extended_id;
+    msg.identifier = frame.id;
     msg.extd = 1;
     msg.rtr = 0;
-    msg.data_length_code = len;
-    if (len > 0) memcpy(msg.data, data, len);
-    return (twai_transmit(&msg, pdMS_TO_TICKS(50)) == ESP_OK);
+    msg.data_length_code = frame.len;
+    memcpy(msg.data, frame.data, frame.len);
+    bool traced = frame.originUs != 0 && frame.queuedUs != 0;
+    uint32_t startUs = traced ? (uint32_t)esp_timer_get_time() : 0;
+
+    // Darf blockieren: wartet nur der Sendetask, nie der Aufrufer von setRpm & Co.
+    esp_err_t err = twai_transmit(&msg, pdMS_TO_TICKS(50));
+    bool ok = err == ESP_OK;
+    (ok ? txSent : txFailed).fetch_add(1, std::memory_order_relaxed);
+    if (ok) busBits.fetch_add(frameBits(frame.len), std::memory_order_relaxed);
+
+    if (ok && traced) {
+        uint32_t endUs = (uint32_t)esp_timer_get_time();
+        trace[TX_QUEUE].record(startUs - frame.queuedUs);
+        trace[TX_TRANSMIT].record(endUs - startUs);
+        trace[TX_TOTAL].record(endUs - frame.originUs);
+    }
+    // nach der Latenzmessung, damit der Mitschnitt nicht in TX_TOTAL eingeht
+    if (canTrace) canTrace->recordTx(msg, err);
+    return ok;
+}
+
+void VescCan::resetTxTrace() {
+    for (LatencyHistogram &h : trace) h.reset();
+    hbJitter.reset();
+}
+
+VescCan::TxStats VescCan::txStats() const {
+    TxStats st;
+    st.depth = txQueue.depth();
+    st.highWater = txQueue.highWater();
+    st.drops = txQueue.drops();
+    st.coalesced = txQueue.coalesced();
+    st.sent = txSent.load(std::memory_order_relaxed);
+    st.failed = txFailed.load(std::memory_order_relaxed);
+    return st;
+}
+
+bool VescCan::getStatus(uint8_t controller_id, VescStatus &status) const {
+    int8_t slot = slotById[controller_id];
+    if (slot < 0) return false;
+    status = controllers[slot].published.load();
+    return true;
+}
+
+void VescCan::handleRx(const twai_message_t &msg) {
+    int8_t slot = msg.extd && !msg.rtr ? slotById[msg.identifier & 0xFF] : -1;
+    if (slot < 0) {
+        rxIgnoredCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Controller &c = controllers[slot];
+    if (!decodeVescStatus((msg.identifier >> 8) & 0xFF, msg.data, msg.data_length_code, c.work)) {
+        rxIgnoredCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    c.work.updatedMs = millis();
+    c.published.store(c.work);
+    rxFrameCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void VescCan::rxTask(void *param) {
+    auto *self = static_cast<VescCan*>(param);
+    twai_message_t msg;
+    while (true) {
+        if (twai_receive(&msg, portMAX_DELAY) == ESP_OK) {
+            self->busBits.fetch_add(frameBits(msg.data_length_code), std::memory_order_relaxed);
+            if (self->canTrace) self->canTrace->recordRx(msg);
+            self->handleRx(msg);
+        }
+    }
+}
+
+void VescCan::txTask(void *param) {
+    auto *self = static_cast<VescCan*>(param);
+    CanFrame frame;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (self->txQueue.pop(frame)) {
+            self->transmitFrame(frame);
+        }
+    }
 }
 
 bool VescCan::setDuty(uint8_t controller_id, float duty) {
-    int32_t v = (int32_t)(duty * 100000.0f);
-    uint8_t buf[4];
-    appendInt32BE(buf, v);
-    uint32_t eid = (CAN_PACKET_SET_DUTY << 8) | controller_id;
-    return sendCanFrame(eid, buf, 4);
+    return send<VescCommand::SET_DUTY>(controller_id, duty);
 }
 
 bool VescCan::setCurrent(uint8_t controller_id, float current) {
-    int32_t v = (int32_t)(current * 1000.0f);
-    uint8_t buf[4];
-    appendInt32BE(buf, v);
-    uint32_t eid = (CAN_PACKET_SET_CURRENT << 8) | controller_id;
-    return sendCanFrame(eid, buf, 4);
+    return send<VescCommand::SET_CURRENT>(controller_id, current);
+}
+
+bool VescCan::sendRpm(uint8_t controller_id, int32_t rpm) {
+    CanFrame frame;
+    encodeVescRaw<VescCommand::SET_RPM>(frame, controller_id, rpm);
+    return sendFrame(frame);
+}
+
+// -------- Sollwerttabelle --------
+bool VescCan::setSetpoint(uint8_t controller_id, VescCommand cmd, float value) {
+    int8_t slot = slotById[controller_id];
+    Setpoint sp;
+    if (slot < 0 || vescArgs(cmd) != 1 || !vescScale(cmd, value, sp.value)) return false;
+    sp.cmd = (uint8_t)cmd;
+    sp.setMs = millis();
+    controllers[slot].setpoint.store(sp);
+    return true;
 }
 
 bool VescCan::setRpm(uint8_t controller_id, int32_t rpm) {
-    rpm_ = rpm;
+    int8_t slot = slotById[controller_id];
+    if (slot < 0) return false;
+    controllers[slot].setpoint.store(Setpoint{(uint8_t)VescCommand::SET_RPM, rpm, (uint32_t)millis()});
     return true;
 }
 
-bool VescCan::sendRpm(uint8_t controller_id, int32_t rpm) {
-    uint8_t buf[4];
-    appendInt32BE(buf, rpm);
-    uint32_t eid = (CAN_PACKET_SET_RPM << 8) | controller_id;
-    return sendCanFrame(eid, buf, 4);
+bool VescCan::setRefreshPeriod(uint8_t controller_id, int refresh_ms) {
+    int8_t slot = slotById[controller_id];
+    if (slot < 0) return false;
+    controllers[slot].refreshMs.store(refresh_ms > 0 ? refresh_ms : 0, std::memory_order_relaxed);
+    if (hbTaskHandle) xTaskNotifyGive(hbTaskHandle);   // Wartezeit neu berechnen
+    return true;
+}
+
+bool VescCan::setFailsafe(uint8_t controller_id, int timeout_ms) {
+    int8_t slot = slotById[controller_id];
+    if (slot < 0) return false;
+    controllers[slot].failsafeMs.store(timeout_ms > 0 ? timeout_ms : 0, std::memory_order_relaxed);
+    return true;
+}
+
+bool VescCan::isFailsafe(uint8_t controller_id) const {
+    int8_t slot = slotById[controller_id];
+    return slot >= 0 && controllers[slot].stale.load(std::memory_order_relaxed);
+}
+
+bool VescCan::getSetpoint(uint8_t controller_id, VescCommand &cmd, int32_t &value) const {
+    int8_t slot = slotById[controller_id];
+    if (slot < 0) return false;
+    Setpoint sp = controllers[slot].setpoint.load();
+    if (sp.cmd == SETPOINT_NONE) return false;
+    cmd = (VescCommand)sp.cmd;
+    value = sp.value;
+    return true;
+}
+
+bool VescCan::enqueueSetpoint(Controller &c, uint32_t origin_us) {
+    Setpoint sp = c.setpoint.load();
+    if (sp.cmd == SETPOINT_NONE) return false;
+
+    // Totmannschaltung: ein alter Sollwert wird nicht endlos wiederholt
+    uint32_t timeout = c.failsafeMs.load(std::memory_order_relaxed);
+    bool stale = timeout > 0 && millis() - sp.setMs > timeout;
+    if (c.stale.exchange(stale, std::memory_order_relaxed) != stale && stale) {
+        failsafeCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (stale) {
+        sp.cmd = (uint8_t)VescCommand::SET_CURRENT;
+        sp.value = 0;
+        origin_us = 0;
+    }
+
+    CanFrame frame;
+    frame.id = ((uint32_t)sp.cmd << 8) | c.id;
+    frame.len = 4;
+    vescPutInt32BE(frame.data, sp.value);
+    bool traced = origin_us != 0 && tracing.load(std::memory_order_relaxed);
+    frame.originUs = traced ? origin_us : 0;
+    frame.queuedUs = traced ? (uint32_t)esp_timer_get_time() : 0;
+    return enqueueFrame(frame, true);
+}
+
+bool VescCan::sendSetpoint(uint8_t controller_id, uint32_t origin_us) {
+    int8_t slot = slotById[controller_id];
+    if (slot < 0 || !enqueueSetpoint(controllers[slot], origin_us)) return false;
+    if (txTaskHandle) xTaskNotifyGive(txTaskHandle);
+    return true;
 }
 
-bool VescCan::sendHeartbeat(uint8_t controller_id, int32_t state, int32_t fault) {
-    uint8_t buf[8];
-    appendInt32BE(buf, state);
-    appendInt32BE(buf+4, fault);
-    uint32_t eid = (CAN_PACKET_HEARTBEAT << 8) | controller_id;
-    //sendCanFrame(eid, buf, 8);
-    return VescCan::sendRpm(controller_id, rpm_);
+// VESC kennt kein eigenes Heartbeat-Paket: der Sollwert selbst hält den Timeout offen.
+bool VescCan::sendHeartbeat(uint8_t controller_id) {
+    return sendSetpoint(controller_id);
 }
 
 // -------- Hintergrund-Heartbeat --------
-void VescCan::startHeartbeatTask(uint8_t controller_id, int interval_ms) {
+void VescCan::startHeartbeatTask() {
     stopHeartbeatTask(); // evtl. altes stoppen
-    hbControllerId = controller_id;
-    hbInterval = interval_ms;
 
-    xTaskCreatePinnedToCore(
-        heartbeatTask,
-        "vesc_heartbeat",
-        2048,
-        this,
-        1,
-        &hbTaskHandle,
-        1
-    );
+    startTask(heartbeatTask, TASK_VESC_HEARTBEAT, this, &hbTaskHandle);
 }
 
 void VescCan::stopHeartbeatTask() {
@@ -116,10 +311,164 @@ void VescCan::stopHeartbeatTask() {
     }
 }
 
+// Ein Durchlauf: alle fälligen Sollwerte direkt hintereinander einreihen und den
+// Sendetask einmal wecken. Liefert den nächsten Fälligkeitszeitpunkt. Gerechnet wird
+// in Ticks, damit das Aufwachen auf den Tick-Interrupt fällt und nicht um bis zu
+// einen Tick hinter einem Mikrosekunden-Termin herläuft. Die Termine sind absolut:
+// Laufzeit und Verspätung eines Durchlaufs verschieben die folgenden nicht.
+TickType_t VescCan::refreshDue(TickType_t now) {
+    TickType_t nextWake = now + pdMS_TO_TICKS(1000);
+    bool queued = false;
+    int64_t nowUs = esp_timer_get_time();
+    for (int i = 0; i < controllerCount; i++) {
+        Controller &c = controllers[i];
+        TickType_t period = pdMS_TO_TICKS(stretchedRefreshMs(c.refreshMs.load(std::memory_order_relaxed)));
+        if (period == 0) {
+            c.lastRefreshUs = 0;
+            continue;
+        }
+
+        if ((int32_t)(c.nextDue - now) > (int32_t)period) {                          // Periode verkürzt
+            c.nextDue = now + period;
+            c.lastRefreshUs = 0;
+        }
+        if ((int32_t)(now - c.nextDue) >= 0) {
+            queued |= enqueueSetpoint(c);
+            if (c.lastRefreshUs != 0) {
+                int64_t deviation = (nowUs - c.lastRefreshUs) - (int64_t)period * portTICK_PERIOD_MS * 1000;
+                hbJitter.record((uint32_t)(deviation >= 0 ? deviation : -deviation));
+            }
+            c.lastRefreshUs = nowUs;
+            c.nextDue += period;
+            if ((int32_t)(c.nextDue - now) <= 0) {                                    // zu spät, neu einrasten
+                c.nextDue = now + period;
+                c.lastRefreshUs = 0;
+            }
+        }
+        if ((int32_t)(c.nextDue - nextWake) < 0) nextWake = c.nextDue;
+    }
+    if (queued && txTaskHandle) xTaskNotifyGive(txTaskHandle);
+    return nextWake;
+}
+
+// Unter Last nur kurze Perioden strecken, und nie über MAX_STRETCHED_REFRESH_MS hinaus
+uint32_t VescCan::stretchedRefreshMs(uint32_t refresh_ms) const {
+    uint32_t stretch = refreshStretch.load(std::memory_order_relaxed);
+    if (stretch <= 1 || refresh_ms == 0 || refresh_ms >= MAX_STRETCHED_REFRESH_MS) return refresh_ms;
+    uint32_t stretched = refresh_ms * stretch;
+    return stretched < MAX_STRETCHED_REFRESH_MS ? stretched : MAX_STRETCHED_REFRESH_MS;
+}
+
 void VescCan::heartbeatTask(void *param) {
     auto *self = static_cast<VescCan*>(param);
+    // gleicher Startpunkt: Controller mit gleicher Periode gehen im selben Durchlauf raus
+    TickType_t start = xTaskGetTickCount();
+    for (int i = 0; i < self->controllerCount; i++) {
+        self->controllers[i].nextDue = start;
+        self->controllers[i].lastRefreshUs = 0;
+    }
+
+    while (true) {
+        TickType_t wake = self->refreshDue(xTaskGetTickCount());
+        int32_t wait = (int32_t)(wake - xTaskGetTickCount());
+        if (wait > 0) ulTaskNotifyTake(pdTRUE, (TickType_t)wait);
+    }
+}
+
+// -------- Busüberwachung --------
+void VescCan::checkBus() {
+    twai_status_info_t st;
+    if (twai_get_status_info(&st) != ESP_OK) return;
+    uint32_t nowMs = millis();
+    int64_t nowUs = esp_timer_get_time();
+    BusState prev = busWork.state;
+
+    switch (st.state) {
+    case TWAI_STATE_BUS_OFF:
+        if (prev != BUS_OFF) {
+            busWork.busOffs++;
+            busOffMs = nowMs;
+            // kurz nach dem letzten Wiederanlauf erneut: Ursache besteht fort, länger warten
+            if (busWork.recoveries > 0 && nowMs - runningMs < 10 * BUS_CHECK_MS) {
+                recoveryDelayMs = recoveryDelayMs ? recoveryDelayMs * 2 : BUS_CHECK_MS;
+                if (recoveryDelayMs > MAX_RECOVERY_DELAY_MS) recoveryDelayMs = MAX_RECOVERY_DELAY_MS;
+            } else {
+                recoveryDelayMs = 0;
+            }
+        }
+        busWork.state = BUS_OFF;
+        if (nowMs - busOffMs >= recoveryDelayMs && twai_initiate_recovery() == ESP_OK) {
+            busWork.recoveries++;
+            busWork.state = BUS_RECOVERING;
+            recovering = true;
+        }
+        break;
+    case TWAI_STATE_RECOVERING:
+        busWork.state = BUS_RECOVERING;
+        break;
+    case TWAI_STATE_STOPPED:
+        // nach dem Wiederanlauf steht der Controller; starten nur, was wir selbst angestoßen haben
+        busWork.state = BUS_STOPPED;
+        if (recovering && twai_start() == ESP_OK) {
+            recovering = false;
+            busWork.state = BUS_ACTIVE;
+            runningMs = nowMs;
+        }
+        break;
+    case TWAI_STATE_RUNNING: {
+        if (prev == BUS_OFF || prev == BUS_RECOVERING || prev == BUS_STOPPED) runningMs = nowMs;
+        uint32_t errors = st.tx_error_counter > st.rx_error_counter ? st.tx_error_counter : st.rx_error_counter;
+        busWork.state = errors >= 128 ? BUS_PASSIVE : errors >= 96 ? BUS_WARNING : BUS_ACTIVE;
+        break;
+    }
+    }
+    busUp.store(busWork.state == BUS_ACTIVE || busWork.state == BUS_WARNING || busWork.state == BUS_PASSIVE,
+                std::memory_order_relaxed);
+
+    busWork.txErrors = st.tx_error_counter;
+    busWork.rxErrors = st.rx_error_counter;
+    busWork.arbLost = st.arb_lost_count;
+    busWork.busErrors = st.bus_error_count;
+    busWork.rxMissed = st.rx_missed_count + st.rx_overrun_count;
+
+    // Last im Intervall, geglättet mit Gewicht 1/4
+    uint32_t bits = busBits.load(std::memory_order_relaxed);
+    int64_t spanUs = nowUs - lastCheckUs;
+    if (lastCheckUs != 0 && spanUs > 0) {
+        uint64_t instant = (uint64_t)(bits - lastBits) * 1000000000ull / ((uint64_t)baudRate * spanUs);
+        if (instant > 1000) instant = 1000;
+        busWork.loadPermille = (uint16_t)((3u * busWork.loadPermille + (uint32_t)instant + 2) / 4);
+    }
+    lastBits = bits;
+    lastCheckUs = nowUs;
+
+    // Streckung in Zweierschritten, je Schritt erst die Wirkung abwarten
+    uint32_t stretch = refreshStretch.load(std::memory_order_relaxed);
+    uint32_t next = stretch;
+    if (nowMs - stretchMs >= 5 * BUS_CHECK_MS) {
+        if (busWork.loadPermille > BUS_LOAD_HIGH && stretch < (uint32_t)MAX_REFRESH_STRETCH) next = stretch * 2;
+        else if (busWork.loadPermille < BUS_LOAD_LOW && stretch > 1) next = stretch / 2;
+    }
+    if (next != stretch) {
+        refreshStretch.store(next, std::memory_order_relaxed);
+        stretchMs = nowMs;
+        if (hbTaskHandle) xTaskNotifyGive(hbTaskHandle);   // Wartezeit neu berechnen
+    }
+    busWork.refreshStretch = (uint8_t)next;
+
+    health.store(busWork);
+}
+
+void VescCan::busTask(void *param) {
+    auto *self = static_cast<VescCan*>(param);
+    TickType_t wake = xTaskGetTickCount();
     while (true) {
-        self->sendHeartbeat(self->hbControllerId, 1, 0);
-        vTaskDelay(pdMS_TO_TICKS(self->hbInterval));
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(BUS_CHECK_MS));
+        self->checkBus();
+        // der Wiederanlauf dauert wenige ms: so lange eng nachsehen, um gleich zu starten
+        for (int i = 0; i < 10 && self->recovering; i++) {
+            vTaskDelay(pdMS_TO_TICKS(5));
+            self->checkBus();
+        }
     }
 }
@@ -1,34 +1,242 @@
 #pragma once
 #include <Arduino.h>
 #include <driver/twai.h>
+#include <atomic>
+
+#include "CanTrace.h"
+#include "CanTxQueue.h"
+#include "LatencyHistogram.h"
+#include "SeqLock.h"
+#include "VescCommands.h"
+#include "VescStatus.h"
 
 class VescCan {
 public:
     VescCan(gpio_num_t tx_pin, gpio_num_t rx_pin, int baud = 500000);
     ~VescCan();
 
+    static const int MAX_CONTROLLERS = 8;
+
+    /**
+     * Meldet einen Controller an: Sollwert-Eintrag in der Tabelle und Empfang seiner
+     * STATUS-Frames. Muss vor begin() erfolgen, weil daraus der Hardware-Akzeptanzfilter
+     * entsteht.
+     * @param refresh_ms Periode, mit der der Heartbeat-Task den Sollwert wiederholt (0 = nie)
+     */
+    bool addController(uint8_t controller_id, int refresh_ms = 100);
+
+    /** Installiert den TWAI-Treiber und startet Sende- und Empfangstask. */
+    bool begin();
+
+    /** true, solange der Treiber läuft und der Bus nicht abgeschaltet ist (Bus-Off, Wiederanlauf) */
     bool isOpen() const;
 
+    // Einmalige Frames werden nur eingereiht und blockieren nie (false = verworfen)
     bool setDuty(uint8_t controller_id, float duty);
     bool setCurrent(uint8_t controller_id, float current);
-    bool setRpm(uint8_t controller_id, int32_t rpm);
     bool sendRpm(uint8_t controller_id, int32_t rpm);
 
-    // Heartbeat-API
-    bool sendHeartbeat(uint8_t controller_id, int32_t state = 1, int32_t fault = 0);
-    void startHeartbeatTask(uint8_t controller_id, int interval_ms = 100);
+    /** Beliebiges Kommando aus VESC_CAN_COMMANDS einmalig senden, z. B. send<VescCommand::SET_POS>(1, 90.0f) */
+    template <VescCommand C>
+    bool send(uint8_t controller_id, float a, float b = 0.0f) {
+        CanFrame frame;
+        encodeVesc<C>(frame, controller_id, a, b);
+        return sendFrame(frame);
+    }
+
+    // Sollwerttabelle: der Heartbeat-Task sendet den Eintrag periodisch.
+    // Zulässig sind alle Kommandos mit genau einem Argument.
+    bool setSetpoint(uint8_t controller_id, VescCommand cmd, float value);
+    bool setRpm(uint8_t controller_id, int32_t rpm);
+    bool setRefreshPeriod(uint8_t controller_id, int refresh_ms);
+    /**
+     * Liest den Tabelleneintrag, skaliert wie im Frame (bei SET_RPM also eRPM).
+     * @return false, wenn der Controller nicht angemeldet ist oder noch keinen Sollwert hat
+     */
+    bool getSetpoint(uint8_t controller_id, VescCommand &cmd, int32_t &value) const;
+    /**
+     * Sendet den Tabelleneintrag sofort, statt auf den Heartbeat zu warten.
+     * @param origin_us esp_timer-Zeit der auslösenden Messung für txTrace() (0 = nicht messen)
+     */
+    bool sendSetpoint(uint8_t controller_id, uint32_t origin_us = 0);
+
+    /**
+     * Totmannschaltung: kam länger als timeout_ms kein neuer Sollwert (setSetpoint/setRpm),
+     * geht statt des letzten Eintrags SET_CURRENT 0 hinaus, bis wieder einer gesetzt wird.
+     * Geprüft wird bei jedem Senden des Eintrags, also spätestens mit dem nächsten Heartbeat.
+     * @param timeout_ms 0 = aus (Standard)
+     */
+    bool setFailsafe(uint8_t controller_id, int timeout_ms);
+    /** true, solange der Controller wegen veraltetem Sollwert stromlos geschaltet ist */
+    bool isFailsafe(uint8_t controller_id) const;
+    /** Wie oft die Totmannschaltung insgesamt ausgelöst hat */
+    uint32_t failsafeTrips() const { return failsafeCount.load(std::memory_order_relaxed); }
+
+    // Heartbeat-API: ein Task für alle Controller
+    bool sendHeartbeat(uint8_t controller_id);
+    void startHeartbeatTask();
     void stopHeartbeatTask();
 
+    // Statistik der Sendewarteschlange
+    struct TxStats {
+        uint32_t depth;       // aktuell wartende Frames
+        uint32_t highWater;   // Maximum von depth
+        uint32_t drops;       // verworfen, Warteschlange voll
+        uint32_t coalesced;   // durch neueren Sollwert ersetzt
+        uint32_t sent;        // von twai_transmit angenommen
+        uint32_t failed;      // von twai_transmit abgelehnt
+    };
+    TxStats txStats() const;
+
+    // Latenzverfolgung im Sendepfad, nur Frames mit origin_us
+    enum TxStage {
+        TX_QUEUE,             // eingereiht -> Sendetask holt den Frame ab
+        TX_TRANSMIT,          // Dauer von twai_transmit
+        TX_TOTAL,             // auslösende Messung -> twai_transmit fertig
+        TX_STAGES
+    };
+    const LatencyHistogram &txTrace(TxStage stage) const { return trace[stage]; }
+    /** Abweichung der Heartbeat-Abstände von der Periode (Betrag), alle Controller */
+    const LatencyHistogram &heartbeatJitter() const { return hbJitter; }
+    /** Leert txTrace() und heartbeatJitter() */
+    void resetTxTrace();
+    /** Schaltet die Zeitstempel im Sendepfad ein oder aus (Standard: ein) */
+    void setTracing(bool on) { tracing.store(on, std::memory_order_relaxed); }
+
+    /**
+     * Busüberwachung: ein Task auf dem Systemkern liest alle BUS_CHECK_MS den Zustand des
+     * TWAI-Controllers. Nach Bus-Off startet er sofort den Wiederanlauf
+     * (twai_initiate_recovery, danach twai_start). Folgt binnen einer Sekunde das nächste
+     * Bus-Off, wartet er erst BUS_CHECK_MS und verdoppelt die Wartezeit mit jedem weiteren,
+     * bis MAX_RECOVERY_DELAY_MS.
+     *
+     * Die Buslast schätzt er aus den gesendeten und empfangenen Frames (Länge mit
+     * höchstmöglicher Zahl Stopfbits) und der Bitrate. Frames, die der Akzeptanzfilter
+     * verwirft, sieht er nicht; die Last ist also eine Untergrenze, wenn fremde Geräte am
+     * Bus hängen. Über BUS_LOAD_HIGH werden zuerst die Heartbeat-Auffrischungen gestreckt
+     * (Faktor 2, dann 4), aber nur Perioden unter MAX_STRETCHED_REFRESH_MS und höchstens
+     * bis dorthin: der Timeout des VESC läuft so nicht ab. Neue Sollwerte von sendSetpoint()
+     * und die Totmannschaltung gehen unverändert sofort hinaus.
+     */
+    enum BusState : uint8_t {
+        BUS_STOPPED,          // Treiber nicht gestartet
+        BUS_ACTIVE,           // läuft, Fehlerzähler unter 96
+        BUS_WARNING,          // ein Fehlerzähler ab 96
+        BUS_PASSIVE,          // ein Fehlerzähler ab 128, meist fehlt das ACK: Controller stromlos?
+        BUS_OFF,              // abgeschaltet, der Wiederanlauf folgt
+        BUS_RECOVERING,       // Wiederanlauf läuft (128 x 11 rezessive Bits)
+    };
+    struct BusHealth {
+        BusState state;
+        uint8_t refreshStretch;     // Faktor auf kurze Heartbeat-Perioden, 1 = normal
+        uint16_t loadPermille;      // geschätzte Buslast, über etwa 400 ms geglättet
+        uint32_t txErrors;          // Fehlerzähler des Controllers (TEC)
+        uint32_t rxErrors;          // dito Empfang (REC)
+        uint32_t arbLost;           // verlorene Arbitrierungen seit begin()
+        uint32_t busErrors;         // Bit-, Stopf-, Form- und ACK-Fehler seit begin()
+        uint32_t rxMissed;          // verloren, Empfangswarteschlange oder FIFO des Treibers voll
+        uint32_t busOffs;           // Bus-Off-Ereignisse
+        uint32_t recoveries;        // gestartete Wiederanläufe
+    };
+    static const uint32_t BUS_CHECK_MS = 100;
+    static const uint16_t BUS_LOAD_HIGH = 600;          // Promille: Auffrischungen strecken
+    static const uint16_t BUS_LOAD_LOW = 350;           // Promille: Streckung zurücknehmen
+    static const int MAX_REFRESH_STRETCH = 4;
+    static const uint32_t MAX_STRETCHED_REFRESH_MS = 250;
+    static const uint32_t MAX_RECOVERY_DELAY_MS = 5000;
+    BusHealth busHealth() const { return health.load(); }
+
+    /** Bits eines Frames mit erweiterter ID und len Datenbytes, Stopfbits im ungünstigsten Fall */
+    static uint32_t frameBits(uint8_t len) {
+        // 67 Bit Rahmen samt Pause, dazu höchstens ein Stopfbit je 4 der 54 + 8 * len gestopften Bits
+        return 67 + 8u * len + (54 + 8u * len - 1) / 4;
+    }
+
+    /**
+     * Letzte Rückmeldung eines angemeldeten Controllers, ohne Sperre lesbar.
+     * @return false, wenn der Controller nicht angemeldet ist
+     */
+    bool getStatus(uint8_t controller_id, VescStatus &status) const;
+
+    /** Mitschnitt aller gesendeten und empfangenen Frames; vor begin() setzen (nullptr = aus) */
+    void setCanTrace(CanTrace *trace) { canTrace = trace; }
+
+    // Empfangsstatistik
+    uint32_t rxFrames() const { return rxFrameCount.load(std::memory_order_relaxed); }
+    uint32_t rxIgnored() const { return rxIgnoredCount.load(std::memory_order_relaxed); }
+
 private:
     bool open_ok;
-    void appendInt32BE(uint8_t *buf, int32_t val);
-    bool sendCanFrame(uint32_t extended_id, const uint8_t *data, uint8_t len);
-    
+    gpio_num_t txPin, rxPin;
+    int baudRate;
+    bool sendFrame(const CanFrame &frame, bool coalesce = true);
+    bool enqueueFrame(const CanFrame &frame, bool coalesce);
+    bool transmitFrame(const CanFrame &frame);
+
+    // Sendepfad
+    CanTxQueue txQueue;
+    static void txTask(void *param);
+    TaskHandle_t txTaskHandle = nullptr;
+    std::atomic<uint32_t> txSent{0};
+    std::atomic<uint32_t> txFailed{0};
+    std::atomic<bool> tracing{true};
+    LatencyHistogram trace[TX_STAGES];   // nur der Sendetask schreibt
+    CanTrace *canTrace = nullptr;
+
+    // Controller-Tabelle: Sollwert und Rückmeldung je angemeldetem Controller
+    static const uint8_t SETPOINT_NONE = 0xFF;
+    struct Setpoint {
+        uint8_t cmd;                 // VescCommand oder SETPOINT_NONE
+        int32_t value;               // skaliert, wie er im Frame steht
+        uint32_t setMs;              // millis() beim Setzen, für die Totmannschaltung
+    };
+    struct Controller {
+        uint8_t id;
+        SeqLock<Setpoint> setpoint;
+        std::atomic<uint32_t> refreshMs{0};
+        std::atomic<uint32_t> failsafeMs{0};
+        std::atomic<bool> stale{false};
+        TickType_t nextDue = 0;      // nur vom Heartbeat-Task benutzt
+        int64_t lastRefreshUs = 0;   // dito, 0 = Abstand nicht auswerten
+        VescStatus work;             // nur vom Empfangstask benutzt
+        SeqLock<VescStatus> published;
+    };
+    Controller controllers[MAX_CONTROLLERS];
+    int controllerCount = 0;
+    int8_t slotById[256];            // Controller-ID -> Index in controllers, -1 = unbekannt
+    std::atomic<uint32_t> failsafeCount{0};
+    bool enqueueSetpoint(Controller &c, uint32_t origin_us = 0);
+
+    // Empfangspfad
+    twai_filter_config_t rxFilter() const;
+    void handleRx(const twai_message_t &msg);
+    static void rxTask(void *param);
+    TaskHandle_t rxTaskHandle = nullptr;
+    std::atomic<uint32_t> rxFrameCount{0};
+    std::atomic<uint32_t> rxIgnoredCount{0};
 
     // Task-Handling
     static void heartbeatTask(void *param);
+    TickType_t refreshDue(TickType_t now);
+    uint32_t stretchedRefreshMs(uint32_t refresh_ms) const;
     TaskHandle_t hbTaskHandle = nullptr;
-    uint8_t hbControllerId = 1;
-    int hbInterval = 100;
-    int rpm_= 0;
+    LatencyHistogram hbJitter;               // nur der Heartbeat-Task schreibt
+
+    // Busüberwachung
+    static void busTask(void *param);
+    void checkBus();
+    TaskHandle_t busTaskHandle = nullptr;
+    std::atomic<bool> busUp{false};
+    std::atomic<uint32_t> busBits{0};        // Sende- und Empfangstask addieren
+    std::atomic<uint32_t> refreshStretch{1};
+    SeqLock<BusHealth> health;
+    // nur der Überwachungstask
+    BusHealth busWork = {};
+    bool recovering = false;
+    uint32_t busOffMs = 0;
+    uint32_t runningMs = 0;
+    uint32_t recoveryDelayMs = 0;
+    uint32_t stretchMs = 0;
+    uint32_t lastBits = 0;
+    int64_t lastCheckUs = 0;
 };
@@ -0,0 +1,97 @@
+#pragma once
+#include <stdint.h>
+
+#include "CanTxQueue.h"
+
+// VESC-CAN-Kommandos mit festem Nutzdatenformat: 1 oder 2 big-endian int32,
+// jeweils Wert * Skalierung. Ein neues Kommando ist eine neue Zeile.
+//
+//  Name                          Paket  Args  Skalierung
+#define VESC_CAN_COMMANDS(X) \
+    X(SET_DUTY,                       0,    1,  100000.0f) \
+    X(SET_CURRENT,                    1,    1,    1000.0f) \
+    X(SET_CURRENT_BRAKE,              2,    1,    1000.0f) \
+    X(SET_RPM,                        3,    1,       1.0f) \
+    X(SET_POS,                        4,    1, 1000000.0f) \
+    X(SET_CURRENT_REL,               10,    1,  100000.0f) \
+    X(SET_CURRENT_BRAKE_REL,         11,    1,  100000.0f) \
+    X(SET_CURRENT_HANDBRAKE,         12,    1,    1000.0f) \
+    X(SET_CURRENT_HANDBRAKE_REL,     13,    1,  100000.0f) \
+    X(CONF_CURRENT_LIMITS,           21,    2,    1000.0f) \
+    X(CONF_STORE_CURRENT_LIMITS,     22,    2,    1000.0f) \
+    X(CONF_CURRENT_LIMITS_IN,        23,    2,    1000.0f) \
+    X(CONF_STORE_CURRENT_LIMITS_IN,  24,    2,    1000.0f) \
+    X(CONF_FOC_ERPMS,                25,    2,    1000.0f) \
+    X(CONF_STORE_FOC_ERPMS,          26,    2,    1000.0f) \
+    X(CONF_BATTERY_CUT,              29,    2,    1000.0f) \
+    X(CONF_STORE_BATTERY_CUT,        30,    2,    1000.0f)
+
+enum class VescCommand : uint8_t {
+#define VESC_COMMAND_ENUM(name, packet, args, scale) name = packet,
+    VESC_CAN_COMMANDS(VESC_COMMAND_ENUM)
+#undef VESC_COMMAND_ENUM
+};
+
+/** @brief Beschreibung eines Kommandos, zur Compile-Zeit aus der Tabelle erzeugt */
+template <VescCommand C> struct VescCommandInfo;
+
+#define VESC_COMMAND_INFO(cmd, packet, nargs, factor) \
+    template <> struct VescCommandInfo<VescCommand::cmd> { \
+        static constexpr uint8_t args = nargs; \
+        static constexpr float scale = factor; \
+        static constexpr const char *name() { return #cmd; } \
+    };
+VESC_CAN_COMMANDS(VESC_COMMAND_INFO)
+#undef VESC_COMMAND_INFO
+
+inline void vescPutInt32BE(uint8_t *buf, int32_t val) {
+    buf[0] = (val >> 24) & 0xFF;
+    buf[1] = (val >> 16) & 0xFF;
+    buf[2] = (val >> 8)  & 0xFF;
+    buf[3] = val & 0xFF;
+}
+
+/**
+ * @brief Kodiert ein Kommando mit bereits skalierten Werten
+ *
+ * Alle Fallunterscheidungen hängen nur von C ab und verschwinden beim Übersetzen.
+ */
+template <VescCommand C>
+inline void encodeVescRaw(CanFrame &frame, uint8_t controller_id, int32_t a, int32_t b = 0) {
+    frame.id = ((uint32_t)C << 8) | controller_id;
+    frame.len = VescCommandInfo<C>::args * 4;
+    frame.originUs = 0;
+    frame.queuedUs = 0;
+    vescPutInt32BE(frame.data, a);
+    if (VescCommandInfo<C>::args == 2) vescPutInt32BE(frame.data + 4, b);
+}
+
+/** @brief Kodiert ein Kommando in physikalischen Einheiten (A, Duty, eRPM, °, V) */
+template <VescCommand C>
+inline void encodeVesc(CanFrame &frame, uint8_t controller_id, float a, float b = 0.0f) {
+    encodeVescRaw<C>(frame, controller_id,
+                     (int32_t)(a * VescCommandInfo<C>::scale),
+                     (int32_t)(b * VescCommandInfo<C>::scale));
+}
+
+/** @brief Laufzeitvariante der Skalierung, z. B. für die Sollwerttabelle */
+inline bool vescScale(VescCommand cmd, float value, int32_t &scaled) {
+    switch (cmd) {
+#define VESC_COMMAND_SCALE(name, packet, args, scale) \
+    case VescCommand::name: scaled = (int32_t)(value * scale); return true;
+    VESC_CAN_COMMANDS(VESC_COMMAND_SCALE)
+#undef VESC_COMMAND_SCALE
+    }
+    return false;
+}
+
+/** @brief Anzahl der int32-Argumente eines Kommandos (0 = unbekannt) */
+inline uint8_t vescArgs(VescCommand cmd) {
+    switch (cmd) {
+#define VESC_COMMAND_ARGS(name, packet, nargs, scale) \
+    case VescCommand::name: return nargs;
+    VESC_CAN_COMMANDS(VESC_COMMAND_ARGS)
+#undef VESC_COMMAND_ARGS
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "VescStatus.h"
+
+static const uint8_t CAN_PACKET_STATUS   = 9;
+static const uint8_t CAN_PACKET_STATUS_2 = 14;
+static const uint8_t CAN_PACKET_STATUS_3 = 15;
+static const uint8_t CAN_PACKET_STATUS_4 = 16;
+static const uint8_t CAN_PACKET_STATUS_5 = 27;
+
+static int32_t readInt32BE(const uint8_t *buf) {
+    return (int32_t)((uint32_t)buf[0] << 24 | (uint32_t)buf[1] << 16 | (uint32_t)buf[2] << 8 | buf[3]);
+}
+
+static int16_t readInt16BE(const uint8_t *buf) {
+    return (int16_t)((uint16_t)buf[0] << 8 | buf[1]);
+}
+
+bool decodeVescStatus(uint8_t packet, const uint8_t *data, uint8_t len, VescStatus &st) {
+    switch (packet) {
+    case CAN_PACKET_STATUS:
+        if (len < 8) return false;
+        st.erpm    = readInt32BE(data);
+        st.current = readInt16BE(data + 4) / 10.0f;
+        st.duty    = readInt16BE(data + 6) / 1000.0f;
+        st.rxMask |= VESC_STATUS_1;
+        break;
+    case CAN_PACKET_STATUS_2:
+        if (len < 8) return false;
+        st.ampHours        = readInt32BE(data) / 10000.0f;
+        st.ampHoursCharged = readInt32BE(data + 4) / 10000.0f;
+        st.rxMask |= VESC_STATUS_2;
+        break;
+    case CAN_PACKET_STATUS_3:
+        if (len < 8) return false;
+        st.wattHours        = readInt32BE(data) / 10000.0f;
+        st.wattHoursCharged = readInt32BE(data + 4) / 10000.0f;
+        st.rxMask |= VESC_STATUS_3;
+        break;
+    case CAN_PACKET_STATUS_4:
+        if (len < 8) return false;
+        st.tempFet   = readInt16BE(data) / 10.0f;
+        st.tempMotor = readInt16BE(data + 2) / 10.0f;
+        st.currentIn = readInt16BE(data + 4) / 10.0f;
+        st.pidPos    = readInt16BE(data + 6) / 50.0f;
+        st.rxMask |= VESC_STATUS_4;
+        break;
+    case CAN_PACKET_STATUS_5:
+        if (len < 6) return false;
+        st.tachometer   = readInt32BE(data);
+        st.inputVoltage = readInt16BE(data + 4) / 10.0f;
+        st.rxMask |= VESC_STATUS_5;
+        break;
+    default:
+        return false;
+    }
+    st.frames++;
+    return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * @brief Rückmeldung eines VESC, zusammengesetzt aus CAN_PACKET_STATUS bis STATUS_5
+ *
+ * Jeder STATUS-Frame aktualisiert nur seine Felder; rxMask zeigt, welche Frames
+ * schon mindestens einmal empfangen wurden.
+ */
+struct VescStatus {
+    uint32_t updatedMs;         // millis() des letzten Frames, 0 = noch nie
+    uint32_t frames;            // Anzahl empfangener STATUS-Frames
+    uint8_t  rxMask;            // Bit n: STATUS_(n+1) empfangen (Bit 0 = STATUS)
+
+    // STATUS
+    int32_t  erpm;
+    float    current;           // A (Motorstrom)
+    float    duty;              // -1..1
+    // STATUS_2
+    float    ampHours;
+    float    ampHoursCharged;
+    // STATUS_3
+    float    wattHours;
+    float    wattHoursCharged;
+    // STATUS_4
+    float    tempFet;           // °C
+    float    tempMotor;         // °C
+    float    currentIn;         // A (Eingangsstrom)
+    float    pidPos;            // °
+    // STATUS_5
+    int32_t  tachometer;        // Schritte
+    float    inputVoltage;      // V
+};
+
+static const uint8_t VESC_STATUS_1 = 1 << 0;
+static const uint8_t VESC_STATUS_2 = 1 << 1;
+static const uint8_t VESC_STATUS_3 = 1 << 2;
+static const uint8_t VESC_STATUS_4 = 1 << 3;
+static const uint8_t VESC_STATUS_5 = 1 << 4;
+
+/**
+ * @brief Dekodiert einen STATUS-Frame in st
+ * @param packet Kommando-Teil der erweiterten ID (Bits 8..15)
+ * @return false, wenn packet kein STATUS-Frame ist oder die Länge nicht passt
+ */
+bool decodeVescStatus(uint8_t packet, const uint8_t *data, uint8_t len, VescStatus &st);
@@ -0,0 +1,369 @@
+#include <math.h>
+
+#include "NativeHal.h"
+#include "VescSim.h"
+
+namespace {
+
+const uint8_t CAN_PACKET_STATUS   = 9;
+const uint8_t CAN_PACKET_STATUS_4 = 16;
+const uint8_t CAN_PACKET_STATUS_5 = 27;
+
+int32_t readInt32BE(const uint8_t* buf) {
+    return (int32_t)((uint32_t)buf[0] << 24 | (uint32_t)buf[1] << 16 | (uint32_t)buf[2] << 8 | buf[3]);
+}
+
+void putInt16BE(uint8_t* buf, float value) {
+    int16_t v = (int16_t)lroundf(fmaxf(-32768.0f, fminf(32767.0f, value)));
+    buf[0] = (uint16_t)v >> 8;
+    buf[1] = (uint16_t)v & 0xFF;
+}
+
+float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+twai_message_t statusFrame(uint8_t packet, uint8_t id) {
+    twai_message_t msg = {};
+    msg.extd = 1;
+    msg.identifier = ((uint32_t)packet << 8) | id;
+    msg.data_length_code = 8;
+    return msg;
+}
+
+}  // namespace
+
+VescSim::VescSim(const VescSimParams& params)
+    : p(params), ke(60.0f / (2.0f * (float)M_PI * params.kv)), busVoltage(params.supplyVoltage) {}
+
+VescSim::~VescSim() {
+    end();
+}
+
+bool VescSim::addController(uint8_t id) {
+    if (controllerCount >= MAX_CONTROLLERS || find(id)) return false;
+    Controller& c = controllers[controllerCount++];
+    c.id = id;
+    c.mode = VescCommand::SET_CURRENT;
+    c.command = 0.0f;
+    c.lastCommandUs = 0;
+    c.hasCommand = false;
+    c.omega = c.current = c.duty = c.currentIn = c.integral = 0.0f;
+    c.tempFet = p.ambient;
+    c.tachometer = 0.0;
+    c.stepOpen = false;
+    return true;
+}
+
+void VescSim::begin() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        simUs = nativehal::nowUs();
+    }
+    nativehal::setTwaiTxHook([this](const twai_message_t& msg) {
+        if (msg.extd) onFrame(msg.identifier, msg.data, msg.data_length_code);
+        return ESP_OK;
+    });
+    xTaskCreatePinnedToCore(taskWrapper, "vesc_sim", 4096, this, 1, &taskHandle, 0);
+}
+
+void VescSim::end() {
+    if (taskHandle) {
+        nativehal::setTwaiTxHook(nullptr);
+        vTaskDelete(taskHandle);
+        taskHandle = nullptr;
+    }
+}
+
+VescSim::Controller* VescSim::find(uint8_t id) {
+    for (int i = 0; i < controllerCount; i++) {
+        if (controllers[i].id == id) return &controllers[i];
+    }
+    return nullptr;
+}
+
+float VescSim::erpmOf(const Controller& c) const {
+    return c.omega * (60.0f / (2.0f * (float)M_PI)) * p.polePairs;
+}
+
+// -------- Modell --------
+
+void VescSim::advanceTo(int64_t us) {
+    const float dt = SUB_STEP_US * 1e-6f;
+    while (simUs + SUB_STEP_US <= us) {
+        float totalIn = 0.0f;
+        for (int i = 0; i < controllerCount; i++) {
+            step(controllers[i], dt);
+            totalIn += controllers[i].currentIn;
+        }
+        busVoltage = p.supplyVoltage - totalIn * p.supplyResistance;
+        simUs += SUB_STEP_US;
+
+        for (int i = 0; i < controllerCount; i++) {
+            Controller& c = controllers[i];
+            if (!c.stepOpen || c.trace.size() >= TRACE_MAX_MS) continue;
+            if (simUs - c.stepStartUs >= (int64_t)c.trace.size() * 1000) c.trace.push_back(erpmOf(c));
+        }
+    }
+}
+
+void VescSim::step(Controller& c, float dt) {
+    bool timedOut = !c.hasCommand || simUs - c.lastCommandUs > (int64_t)p.timeoutMs * 1000;
+    float target = 0.0f;
+    if (timedOut) {
+        c.integral = 0.0f;
+    } else {
+        switch (c.mode) {
+        case VescCommand::SET_CURRENT:
+            target = c.command;
+            break;
+        case VescCommand::SET_CURRENT_REL:
+            target = c.command * p.currentMax;
+            break;
+        case VescCommand::SET_CURRENT_BRAKE:
+            // Bremsstrom wirkt immer gegen die Drehrichtung
+            target = c.omega > 0.1f ? -fabsf(c.command) : (c.omega < -0.1f ? fabsf(c.command) : 0.0f);
+            break;
+        case VescCommand::SET_DUTY: {
+            float volts = clampf(c.command, -p.dutyMax, p.dutyMax) * busVoltage;
+            target = (volts - ke * c.omega) / p.resistance;
+            break;
+        }
+        case VescCommand::SET_RPM: {
+            float error = c.command - erpmOf(c);
+            c.integral = clampf(c.integral + p.rpmKi * error * dt, -1.0f, 1.0f);
+            target = clampf(p.rpmKp * error + c.integral, -1.0f, 1.0f) * p.currentMax;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    // Stromgrenze und erreichbare Klemmenspannung
+    target = clampf(target, -p.currentMax, p.currentMax);
+    float vMax = p.dutyMax * busVoltage;
+    float emf = ke * c.omega;
+    target = clampf(target, (-vMax - emf) / p.resistance, (vMax - emf) / p.resistance);
+    c.current += (target - c.current) * (dt / p.currentTau);
+
+    float drive = ke * c.current - p.propCoeff * c.omega * fabsf(c.omega);
+    float torque;
+    if (c.omega > 0.0f) {
+        torque = drive - p.friction;
+    } else if (c.omega < 0.0f) {
+        torque = drive + p.friction;
+    } else {
+        // Haftreibung
+        torque = fabsf(drive) <= p.friction ? 0.0f : drive - copysignf(p.friction, drive);
+    }
+    float omega = c.omega + torque / p.inertia * dt;
+    // Reibung allein kehrt die Drehrichtung nicht um
+    if ((c.omega > 0.0f && omega < 0.0f) || (c.omega < 0.0f && omega > 0.0f)) {
+        if (fabsf(ke * c.current) <= p.friction) omega = 0.0f;
+    }
+    c.omega = omega;
+
+    float volts = ke * c.omega + p.resistance * c.current;
+    c.duty = clampf(volts / busVoltage, -1.0f, 1.0f);
+    c.currentIn = c.duty * c.current;
+    c.tempFet += (p.fetHeating * c.current * c.current - (c.tempFet - p.ambient) / p.fetCoolingTau) * dt;
+    c.tachometer += erpmOf(c) * (6.0 / 60.0) * dt;
+}
+
+void VescSim::onFrame(uint32_t identifier, const uint8_t* data, uint8_t len) {
+    std::lock_guard<std::mutex> lock(mutex);
+    int64_t now = nativehal::nowUs();
+    advanceTo(now);
+    Controller* c = find(identifier & 0xFF);
+    if (!c) return;
+    frames++;
+
+    VescCommand cmd = (VescCommand)((identifier >> 8) & 0xFF);
+    switch (cmd) {
+    case VescCommand::SET_DUTY:
+    case VescCommand::SET_CURRENT:
+    case VescCommand::SET_CURRENT_BRAKE:
+    case VescCommand::SET_RPM:
+    case VescCommand::SET_CURRENT_REL:
+        break;
+    default:
+        ignored++;
+        return;
+    }
+    int32_t scale;
+    if (len < 4 || !vescScale(cmd, 1.0f, scale)) {
+        ignored++;
+        return;
+    }
+    float value = readInt32BE(data) / (float)scale;
+    if (cmd != c->mode) c->integral = 0.0f;
+    c->mode = cmd;
+    c->command = value;
+    c->lastCommandUs = now;
+    c->hasCommand = true;
+    if (c->stepOpen && c->stepCommandUs < 0 && (cmd != c->stepMode || value != c->stepCommand)) {
+        c->stepCommandUs = now;
+    }
+}
+
+// -------- Status-Frames --------
+
+void VescSim::statusFrames(const Controller& c, twai_message_t* out) const {
+    out[0] = statusFrame(CAN_PACKET_STATUS, c.id);
+    vescPutInt32BE(out[0].data, (int32_t)lroundf(erpmOf(c)));
+    putInt16BE(out[0].data + 4, c.current * 10.0f);
+    putInt16BE(out[0].data + 6, c.duty * 1000.0f);
+
+    out[1] = statusFrame(CAN_PACKET_STATUS_4, c.id);
+    putInt16BE(out[1].data, c.tempFet * 10.0f);
+    putInt16BE(out[1].data + 2, p.ambient * 10.0f);
+    putInt16BE(out[1].data + 4, c.currentIn * 10.0f);
+    putInt16BE(out[1].data + 6, 0.0f);
+
+    out[2] = statusFrame(CAN_PACKET_STATUS_5, c.id);
+    vescPutInt32BE(out[2].data, (int32_t)c.tachometer);
+    putInt16BE(out[2].data + 4, busVoltage * 10.0f);
+}
+
+void VescSim::taskWrapper(void* param) {
+    static_cast<VescSim*>(param)->statusTask();
+}
+
+void VescSim::statusTask() {
+    TickType_t last = xTaskGetTickCount();
+    twai_message_t out[MAX_CONTROLLERS * STATUS_FRAMES];
+    while (true) {
+        vTaskDelayUntil(&last, pdMS_TO_TICKS(p.statusPeriodMs));
+        int count;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            advanceTo(nativehal::nowUs());
+            count = controllerCount * STATUS_FRAMES;
+            for (int i = 0; i < controllerCount; i++) statusFrames(controllers[i], out + i * STATUS_FRAMES);
+        }
+        // außerhalb der Sperre: twaiInjectRx weckt den Empfangstask von VescCan
+        for (int i = 0; i < count; i++) nativehal::twaiInjectRx(out[i]);
+    }
+}
+
+bool VescSim::state(uint8_t id, State& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    advanceTo(nativehal::nowUs());
+    Controller* c = find(id);
+    if (!c) return false;
+    out.erpm = erpmOf(*c);
+    out.current = c->current;
+    out.duty = c->duty;
+    out.currentIn = c->currentIn;
+    out.inputVoltage = busVoltage;
+    out.tempFet = c->tempFet;
+    out.mode = c->mode;
+    out.command = c->command;
+    out.timedOut = !c->hasCommand || simUs - c->lastCommandUs > (int64_t)p.timeoutMs * 1000;
+    return true;
+}
+
+uint32_t VescSim::commandFrames() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return frames;
+}
+
+uint32_t VescSim::ignoredFrames() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ignored;
+}
+
+// -------- Sprungantworten --------
+
+void VescSim::stimulus(uint8_t id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    int64_t now = nativehal::nowUs();
+    advanceTo(now);
+    Controller* c = find(id);
+    if (!c) return;
+    closeStep(*c);
+    c->stepOpen = true;
+    c->stepStartUs = now;
+    c->stepFrom = erpmOf(*c);
+    c->stepMode = c->mode;
+    c->stepCommand = c->command;
+    c->stepCommandUs = -1;
+    c->trace.clear();
+}
+
+void VescSim::finish() {
+    std::lock_guard<std::mutex> lock(mutex);
+    advanceTo(nativehal::nowUs());
+    for (int i = 0; i < controllerCount; i++) closeStep(controllers[i]);
+}
+
+// Endwert ist der kommandierte Drehzahlsollwert; bei Strom- oder Duty-Betrieb die
+// zuletzt erreichte Drehzahl.
+void VescSim::closeStep(Controller& c) {
+    if (!c.stepOpen) return;
+    c.stepOpen = false;
+    if (c.trace.empty()) return;
+
+    float from = c.stepFrom;
+    float to = c.mode == VescCommand::SET_RPM && c.hasCommand ? c.command : c.trace.back();
+    float delta = to - from;
+    if (fabsf(delta) < MIN_STEP_ERPM) return;
+
+    float band = fmaxf(fabsf(delta) * SETTLE_PERCENT / 100.0f, (float)SETTLE_MIN_ERPM);
+    uint32_t t10 = UINT32_MAX, t90 = UINT32_MAX, lastOutside = 0;
+    bool everOutside = false;
+    float peak = 0.0f;
+    for (uint32_t ms = 0; ms < c.trace.size(); ms++) {
+        float progress = (c.trace[ms] - from) / delta;
+        if (t10 == UINT32_MAX && progress >= 0.1f) t10 = ms;
+        if (t90 == UINT32_MAX && progress >= 0.9f) t90 = ms;
+        if (progress > peak) peak = progress;
+        if (fabsf(c.trace[ms] - to) > band) {
+            lastOutside = ms;
+            everOutside = true;
+        }
+    }
+
+    Step s;
+    s.fromErpm = (int32_t)lroundf(from);
+    s.toErpm = (int32_t)lroundf(to);
+    s.commandUs = c.stepCommandUs >= 0 ? (uint32_t)(c.stepCommandUs - c.stepStartUs) : UINT32_MAX;
+    s.responseMs = t10;
+    s.riseMs = t10 != UINT32_MAX && t90 != UINT32_MAX ? t90 - t10 : UINT32_MAX;
+    s.settleMs = lastOutside + 1 >= c.trace.size() ? UINT32_MAX : (everOutside ? lastOutside + 1 : 0);
+    s.overshootPct = peak > 1.0f ? (peak - 1.0f) * 100.0f : 0.0f;
+    c.done.push_back(s);
+
+    if (s.commandUs != UINT32_MAX) c.commandHist.record(s.commandUs);
+    if (s.responseMs != UINT32_MAX) c.responseHist.record(s.responseMs);
+    if (s.riseMs != UINT32_MAX) c.riseHist.record(s.riseMs);
+    if (s.settleMs != UINT32_MAX) c.settleHist.record(s.settleMs);
+}
+
+bool VescSim::metrics(uint8_t id, Metrics& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Controller* c = find(id);
+    if (!c) return false;
+    out.steps = c->done.size();
+    out.unsettled = 0;
+    out.overshootMaxPct = 0.0f;
+    float sum = 0.0f;
+    for (const Step& s : c->done) {
+        if (s.settleMs == UINT32_MAX) out.unsettled++;
+        out.overshootMaxPct = fmaxf(out.overshootMaxPct, s.overshootPct);
+        sum += s.overshootPct;
+    }
+    out.overshootMeanPct = out.steps ? sum / out.steps : 0.0f;
+    out.commandUs = c->commandHist.summary();
+    out.responseMs = c->responseHist.summary();
+    out.riseMs = c->riseHist.summary();
+    out.settleMs = c->settleHist.summary();
+    return true;
+}
+
+std::vector<VescSim::Step> VescSim::steps(uint8_t id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Controller* c = find(id);
+    return c ? c->done : std::vector<Step>();
+}
@@ -0,0 +1,164 @@
+#pragma once
+// Host-Simulation von VESC-Controllern samt Motor und Propeller (nur env:native).
+
+#include <stdint.h>
+#include <mutex>
+#include <vector>
+
+#include "LatencyHistogram.h"
+#include "VescCommands.h"
+#include "freertos/task.h"
+
+/**
+ * @brief Modell je Controller: BLDC-Motor mit Stromregler, Propeller als quadratische Last
+ *
+ *   J dω/dt = kt·i − c·ω|ω| − Reibung,   di/dt = (i_soll − i) / τ
+ *
+ * i_soll kommt aus dem Kommando (Strom, Bremsstrom, Duty über U = d·U_bus, Drehzahl
+ * über den PI-Regler der VESC-Firmware) und wird auf Stromgrenze und erreichbaren Duty
+ * begrenzt. Ohne Kommando für timeoutMs fällt der Strom auf 0 wie bei app timeout.
+ * Die Standardwerte beschreiben grob einen Außenläufer am Bugstrahlruder-Propeller
+ * an 24 V; 4000 eRPM brauchen im Wasser etwa 30 A.
+ */
+struct VescSimParams {
+    float kv = 40.0f;                 // U/min je Volt (mechanisch)
+    int polePairs = 7;                // eRPM = U/min · polePairs
+    float resistance = 0.05f;         // Ohm
+    float inertia = 0.02f;            // kg·m², Motor, Welle und mitbewegtes Wasser
+    float propCoeff = 2.0e-3f;        // N·m je (rad/s)²
+    float friction = 0.05f;           // N·m
+    float supplyVoltage = 24.0f;      // V im Leerlauf
+    float supplyResistance = 0.02f;   // Ohm, Akku und Leitungen
+    float currentMax = 60.0f;         // A, Motorstrom in beide Richtungen
+    float currentTau = 0.002f;        // s, Stromregler
+    float dutyMax = 0.95f;
+    float rpmKp = 0.004f;             // Drehzahlregler wie VESC s_pid_kp/ki: Ausgang 1 = currentMax
+    float rpmKi = 0.004f;
+    float fetHeating = 0.004f;        // °C/s je A²
+    float fetCoolingTau = 60.0f;      // s
+    float ambient = 25.0f;            // °C
+    uint32_t timeoutMs = 1000;
+    uint32_t statusPeriodMs = 20;     // STATUS, STATUS_4 und STATUS_5
+};
+
+/**
+ * @brief Simuliert die VESCs am Bus der TWAI-Attrappe, für Regelkreistests auf dem Host
+ *
+ * begin() hängt sich als Sende-Hook in twai_transmit: jedes Kommando von VescCan wirkt
+ * sofort auf das Modell. Ein Task antwortet alle statusPeriodMs mit STATUS-Frames
+ * über twaiInjectRx(). Zusammen mit nativehal::virtualTime(true) läuft ein Manöver
+ * von Minuten in Sekunden.
+ *
+ * Messung: stimulus() markiert den Eingriff (z. B. Joystick bewegt). Bis zum nächsten
+ * stimulus() oder finish() wird der Drehzahlverlauf mitgeschrieben und dann gegen den
+ * zuletzt kommandierten Sollwert ausgewertet.
+ */
+class VescSim {
+public:
+    static const int MAX_CONTROLLERS = 8;
+    static const int32_t MIN_STEP_ERPM = 200;    // kleinere Sprünge werden nicht ausgewertet
+    static const int32_t SETTLE_PERCENT = 5;     // Band um den Endwert, Anteil des Sprungs,
+    static const int32_t SETTLE_MIN_ERPM = 50;   // aber mindestens so breit
+    static const uint32_t TRACE_MAX_MS = 120000; // längere Abschnitte werden abgeschnitten
+    static const int64_t SUB_STEP_US = 100;      // Integrationsschritt
+
+    explicit VescSim(const VescSimParams& params = VescSimParams());
+    ~VescSim();
+
+    /** @brief Controller mit dieser ID simulieren; vor begin() */
+    bool addController(uint8_t id);
+    void begin();
+    void end();
+
+    struct State {
+        float erpm;
+        float current;       // A, Motor
+        float duty;
+        float currentIn;     // A, Akku
+        float inputVoltage;
+        float tempFet;
+        VescCommand mode;
+        float command;       // Wert des letzten Kommandos, skaliert wie im Aufruf
+        bool timedOut;
+    };
+    bool state(uint8_t id, State& out);
+
+    /** @brief Eingriff jetzt; wertet den vorigen Abschnitt dieses Controllers aus */
+    void stimulus(uint8_t id);
+    /** @brief Wertet die offenen Abschnitte aller Controller aus */
+    void finish();
+
+    struct Step {
+        int32_t fromErpm, toErpm;
+        uint32_t commandUs;      // Eingriff -> erstes geändertes Kommando auf dem Bus
+        uint32_t responseMs;     // Eingriff -> 10 % des Sprungs
+        uint32_t riseMs;         // 10 % -> 90 %
+        uint32_t settleMs;       // Eingriff -> bleibt im Band; UINT32_MAX = nie
+        float overshootPct;
+    };
+    struct Metrics {
+        uint32_t steps;
+        uint32_t unsettled;
+        float overshootMaxPct;
+        float overshootMeanPct;
+        LatencyHistogram::Summary commandUs;
+        LatencyHistogram::Summary responseMs;
+        LatencyHistogram::Summary riseMs;
+        LatencyHistogram::Summary settleMs;
+    };
+    bool metrics(uint8_t id, Metrics& out);
+    /** @brief Ausgewertete Abschnitte eines Controllers in zeitlicher Reihenfolge */
+    std::vector<Step> steps(uint8_t id);
+
+    uint32_t commandFrames() const;
+    uint32_t ignoredFrames() const;
+
+private:
+    struct Controller {
+        uint8_t id;
+        // Kommando
+        VescCommand mode;
+        float command;
+        int64_t lastCommandUs;
+        bool hasCommand;
+        // Zustand
+        float omega;             // rad/s mechanisch
+        float current;
+        float duty;
+        float currentIn;
+        float tempFet;
+        float integral;          // Drehzahlregler
+        double tachometer;
+        // Messabschnitt
+        bool stepOpen;
+        int64_t stepStartUs;
+        float stepFrom;
+        VescCommand stepMode;    // Kommando beim Eingriff
+        float stepCommand;
+        int64_t stepCommandUs;   // -1 = noch kein geändertes Kommando
+        std::vector<float> trace;    // eRPM je Millisekunde ab stepStartUs
+        std::vector<Step> done;
+        LatencyHistogram commandHist, responseHist, riseHist, settleHist;
+    };
+
+    VescSimParams p;
+    float ke;                    // V·s/rad = N·m/A
+    float busVoltage;
+    int64_t simUs = 0;           // bis hierhin integriert
+    Controller controllers[MAX_CONTROLLERS];
+    int controllerCount = 0;
+    uint32_t frames = 0, ignored = 0;
+    mutable std::mutex mutex;
+    TaskHandle_t taskHandle = nullptr;
+
+    Controller* find(uint8_t id);
+    float erpmOf(const Controller& c) const;
+    void advanceTo(int64_t us);
+    void step(Controller& c, float dt);
+    void onFrame(uint32_t identifier, const uint8_t* data, uint8_t len);
+    void closeStep(Controller& c);
+    static const int STATUS_FRAMES = 3;
+    void statusFrames(const Controller& c, twai_message_t* out) const;
+    static void taskWrapper(void* param);
+    void statusTask();
+};
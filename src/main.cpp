@@ -1,20 +1,28 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include <ESPAsyncWebServer.h>
+#include <LittleFS.h>
 
 #include "VescCan.h"
+#include "ControlLoop.h"
 #include "SerialCommands.h"
+#include "SerialCommandTask.h"
 #include "Joystick.h"
 #include "JoystickWebServer.h"
+#include "TelemetryPush.h"
+#include "HeapStats.h"
+#include "ThrottleCurve.h"
+#include "BinaryLink.h"
+#include "CanTrace.h"
+#include "FlightLog.h"
+#include "TaskPlacement.h"
+#include "TaskProfiler.h"
 
 #define CAN_TX GPIO_NUM_14
 #define CAN_RX GPIO_NUM_13
 
 #define JOYSTICK_PIN GPIO_NUM_10
 
-#define MIN_RPM 1000
-#define MAX_RPM 4000
-
 // WLAN-Daten (anpassen!)
 const char* ssid = "ESP32_JOYSTICK";
 const char* password = "12345678";
@@ -26,10 +34,57 @@ JoystickWebServer web(js, ssid,password);
 
 VescCan vesc(CAN_TX, CAN_RX, 500000);
 
+// Mitschnitt aller CAN-Frames nach LittleFS, Download unter /cantrace.bin
+CanTrace cantrace(LittleFS);
+
+// Kennlinie: Standard 0 / 1000..4000 U/min in beide Richtungen, umschaltbar mit "curve"
+ThrottleCurve curve;
+
+int32_t joystickToRpm(q15_t value) {
+  return curve.map(value);
+}
+
+ControlLoop control(js, vesc, 1, joystickToRpm);
+
+TelemetryPush telemetry(js, vesc, 1);
+
 
 
-char serial_command_buffer_[32];
+char serial_command_buffer_[96];
 SerialCommands serial_commands_(&Serial, serial_command_buffer_, sizeof(serial_command_buffer_), "\r\n", " ");
+SerialCommandTask serial_task_(Serial, serial_commands_);
+
+// Binärrahmen vom PC auf derselben Schnittstelle wie die Textbefehle
+BinaryLink binlink(Serial, js, vesc, &control);
+
+// Flugschreiber: ein Takt aus den veröffentlichten Schnappschüssen, Download unter /flight.bin
+bool sampleFlight(FlightLogRecord& rec) {
+  memset(&rec, 0, sizeof(rec));
+  JoystickSnapshot s = js.getSnapshot();
+  if (s.calibrated) {
+    rec.stick = s.value;
+    rec.flags |= FLIGHT_LOG_CALIBRATED;
+  }
+  VescCommand cmd;
+  if (vesc.getSetpoint(1, cmd, rec.rpm)) rec.flags |= FLIGHT_LOG_SETPOINT;
+  VescStatus st;
+  // ältere Rückmeldungen nicht fortschreiben: Controller aus oder Bus gestört
+  if (vesc.getStatus(1, st) && st.updatedMs != 0 && millis() - st.updatedMs < 500) {
+    rec.erpm = st.erpm;
+    rec.current = (int16_t)lroundf(st.current * 10.0f);
+    rec.duty = (int16_t)lroundf(st.duty * 1000.0f);
+    rec.vin = (int16_t)lroundf(st.inputVoltage * 10.0f);
+    rec.flags |= FLIGHT_LOG_STATUS;
+  }
+  if (binlink.hostControl()) rec.flags |= FLIGHT_LOG_HOST;
+  return true;
+}
+
+FlightLog flightlog(LittleFS, sampleFlight);
+const char* const FLIGHT_LOG_FILES[] = {FlightLog::OLD_FILE_PATH, FlightLog::FILE_PATH};
+
+// CPU-Anteil und Stack je Task, Planungslatenz je Kern
+TaskProfiler profiler;
 
 //This is the default handler, and gets called when no other command matches. 
 void cmd_unrecognized(SerialCommands* sender, const char* cmd)
@@ -44,73 +99,470 @@ void cmd_set_rpm(SerialCommands* sender)
 {
 	//Note: Every call to Next moves the pointer to next parameter
 
-	char* rpm_str = sender->Next();
-	if (rpm_str == NULL)
+	long rpm;
+	if (!sender->NextInt(rpm))
 	{
 		sender->GetSerial()->println("ERROR WRONG PARAMETER");
 		return;
 	}
 
-	int rpm = atoi(rpm_str);
-	
   vesc.setRpm(1, rpm);
 
 	sender->GetSerial()->print("RPM set to ");
 	sender->GetSerial()->print(rpm);
 }
 
-// Mapping-Funktion:
-// [-1,0)  -> [-4000,-1000]
-// 0       -> 0
-// (0,1]   -> [1000,4000]
-double mapSplit(double x) {
-  if (x == 0.0) return 0.0;
-  return std::copysign(1000.0 + std::fabs(x) * 3000.0, x);
+//prints the last STATUS feedback of controller 1
+void cmd_status(SerialCommands* sender)
+{
+	VescStatus st;
+	if (!vesc.getStatus(1, st) || st.updatedMs == 0)
+	{
+		sender->GetSerial()->println("NO STATUS");
+		return;
+	}
+	sender->GetSerial()->printf("eRPM %ld  I %.1f A  Duty %.3f  Vin %.1f V  FET %.1f C  Motor %.1f C  Tacho %ld  Alter %lu ms\n",
+		(long)st.erpm, st.current, st.duty, st.inputVoltage, st.tempFet, st.tempMotor,
+		(long)st.tachometer, millis() - st.updatedMs);
+	if (vesc.isFailsafe(1))
+	{
+		sender->GetSerial()->printf("Totmannschaltung aktiv: kein neuer Sollwert (%lu mal ausgelöst)\n",
+			(unsigned long)vesc.failsafeTrips());
+	}
+}
+
+const char* const BUS_STATE_NAMES[] = {"gestoppt", "aktiv", "Warnung", "passiv", "Bus-Off", "Wiederanlauf"};
+
+void busJson(JsonWriter& w) {
+  VescCan::BusHealth h = vesc.busHealth();
+  w.beginObject()
+    .key("state").value(BUS_STATE_NAMES[h.state])
+    .key("load").value(h.loadPermille / 10.0f, 1)
+    .key("stretch").value((unsigned)h.refreshStretch)
+    .key("tec").value(h.txErrors)
+    .key("rec").value(h.rxErrors)
+    .key("arb_lost").value(h.arbLost)
+    .key("bus_errors").value(h.busErrors)
+    .key("rx_missed").value(h.rxMissed)
+    .key("bus_off").value(h.busOffs)
+    .key("recoveries").value(h.recoveries)
+    .endObject();
+}
+
+//prints the CAN controller state, error counters and estimated bus load
+void cmd_bus(SerialCommands* sender)
+{
+	VescCan::BusHealth h = vesc.busHealth();
+	sender->GetSerial()->printf("CAN %s  Last %u.%u %%  Auffrischung x%u  TEC %lu  REC %lu\n",
+		BUS_STATE_NAMES[h.state], h.loadPermille / 10, h.loadPermille % 10, (unsigned)h.refreshStretch,
+		(unsigned long)h.txErrors, (unsigned long)h.rxErrors);
+	sender->GetSerial()->printf("Arbitrierung verloren %lu  Busfehler %lu  Empfang verloren %lu  Bus-Off %lu  Wiederanläufe %lu\n",
+		(unsigned long)h.arbLost, (unsigned long)h.busErrors, (unsigned long)h.rxMissed,
+		(unsigned long)h.busOffs, (unsigned long)h.recoveries);
+}
+
+// Latenz je Stufe des Pfads Messung -> CAN, in der Reihenfolge des Durchlaufs
+struct TraceRow {
+  const char* name;
+  LatencyHistogram::Summary s;
+};
+const int TRACE_ROWS = 7;
+
+void collectTrace(TraceRow rows[TRACE_ROWS]) {
+  rows[0] = {"wake", control.trace(ControlLoop::STAGE_WAKE).summary()};
+  rows[1] = {"map", control.trace(ControlLoop::STAGE_MAP).summary()};
+  rows[2] = {"enqueue", control.trace(ControlLoop::STAGE_ENQUEUE).summary()};
+  rows[3] = {"queue", vesc.txTrace(VescCan::TX_QUEUE).summary()};
+  rows[4] = {"transmit", vesc.txTrace(VescCan::TX_TRANSMIT).summary()};
+  rows[5] = {"total", vesc.txTrace(VescCan::TX_TOTAL).summary()};
+  rows[6] = {"heartbeat", vesc.heartbeatJitter().summary()};   // Abweichung von der Periode
+}
+
+void traceJson(JsonWriter& w) {
+  TraceRow rows[TRACE_ROWS];
+  collectTrace(rows);
+  w.beginObject();
+  for (int i = 0; i < TRACE_ROWS; i++) {
+    w.key(rows[i].name).beginObject()
+      .key("n").value(rows[i].s.count)
+      .key("p50").value(rows[i].s.p50)
+      .key("p99").value(rows[i].s.p99)
+      .key("max").value(rows[i].s.max)
+      .endObject();
+  }
+  w.endObject();
+}
+
+//prints p50/p99/max per stage of the control path in us, then resets the histograms
+void cmd_latency(SerialCommands* sender)
+{
+	TraceRow rows[TRACE_ROWS];
+	collectTrace(rows);
+	for (int i = 0; i < TRACE_ROWS; i++)
+	{
+		sender->GetSerial()->printf("%-9s n=%-7lu p50 %6lu us  p99 %6lu us  max %6lu us\n",
+			rows[i].name, (unsigned long)rows[i].s.count, (unsigned long)rows[i].s.p50,
+			(unsigned long)rows[i].s.p99, (unsigned long)rows[i].s.max);
+	}
+	sender->GetSerial()->printf("Durchläufe: Messung %lu, Auffrischung %lu\n",
+		(unsigned long)control.sampleWakeups(), (unsigned long)control.refreshWakeups());
+	control.resetTrace();
+	vesc.resetTxTrace();
+}
+
+// Promille als Prozent mit einer Stelle; -1 ohne Laufzeitstatistik
+float permilleToPercent(uint16_t permille) {
+  return permille == TaskProfiler::CPU_UNKNOWN ? -1.0f : permille / 10.0f;
+}
+
+void tasksJson(JsonWriter& w) {
+  w.beginObject().key("cores").beginArray();
+  for (int c = 0; c < TaskProfiler::CORES; c++) {
+    LatencyHistogram::Summary s = profiler.schedulingLatency(c).summary();
+    w.beginObject()
+      .key("load").value(permilleToPercent(profiler.coreLoad(c)), 1)
+      .key("lat_p50").value(s.p50)
+      .key("lat_p99").value(s.p99)
+      .key("lat_max").value(s.max)
+      .endObject();
+  }
+  w.endArray().key("tasks").beginArray();
+  for (int i = 0; i < profiler.taskCount(); i++) {
+    TaskLoad t = profiler.task(i);
+    w.beginObject()
+      .key("name").value(t.name)
+      .key("core").value((int)t.core)
+      .key("prio").value((unsigned)t.priority)
+      .key("cpu").value(permilleToPercent(t.cpuPermille), 1)
+      .key("stack_free").value(t.stackFree)
+      .endObject();
+  }
+  w.endArray().endObject();
+}
+
+//prints cpu share, priority and free stack per task, then the scheduling latency per core and resets it
+void cmd_tasks(SerialCommands* sender)
+{
+	sender->GetSerial()->println("Task             Kern Prio   CPU %  Stack frei");
+	for (int i = 0; i < profiler.taskCount(); i++)
+	{
+		TaskLoad t = profiler.task(i);
+		char core[4] = "-";
+		if (t.core >= 0) snprintf(core, sizeof(core), "%d", t.core);
+		sender->GetSerial()->printf("%-16s %4s %4u  %6.1f  %10lu\n", t.name, core, (unsigned)t.priority,
+			permilleToPercent(t.cpuPermille), (unsigned long)t.stackFree);
+	}
+	for (int c = 0; c < TaskProfiler::CORES; c++)
+	{
+		LatencyHistogram::Summary s = profiler.schedulingLatency(c).summary();
+		sender->GetSerial()->printf("Kern %d: Last %5.1f %%  Planungslatenz p50 %lu us  p99 %lu us  max %lu us\n",
+			c, permilleToPercent(profiler.coreLoad(c)), (unsigned long)s.p50,
+			(unsigned long)s.p99, (unsigned long)s.max);
+	}
+	profiler.resetLatency();
+}
+
+//filter [median average iir_alpha [kalman_q kalman_r]]: sets or prints the joystick filter chain
+void cmd_filter(SerialCommands* sender)
+{
+	if (sender->ArgCount() > 0)
+	{
+		long median, average;
+		FilterConfig cfg;
+		bool ok = sender->NextInt(median) && sender->NextInt(average) && sender->NextFloat(cfg.iirAlpha);
+		if (ok && sender->ArgCount() > 3)
+		{
+			ok = sender->NextFloat(cfg.kalmanQ) && sender->NextFloat(cfg.kalmanR);
+		}
+		if (!ok || median < 1 || median > 255 || average < 1 || average > 255)
+		{
+			sender->GetSerial()->println("ERROR WRONG PARAMETER");
+			return;
+		}
+
+		cfg.median = median;
+		cfg.average = average;
+		if (!js.setFilter(cfg))
+		{
+			sender->GetSerial()->println("Werte begrenzt");
+		}
+	}
+
+	FilterConfig cfg = js.getFilter();
+	sender->GetSerial()->printf("Filter: Median %u  Mittelwert %u  IIR %.3f  Kalman Q %g R %g  Verzögerung %.1f ms\n",
+		cfg.median, cfg.average, cfg.iirAlpha, cfg.kalmanQ, cfg.kalmanR, js.getFilterDelayMs());
+}
+
+//autocal [on|off]: switches or prints the joystick self-calibration
+void cmd_autocal(SerialCommands* sender)
+{
+	if (sender->ArgCount() > 0)
+	{
+		char* arg = sender->Next();
+		if (strcmp(arg, "on") == 0) js.setAutoCalibration(true);
+		else if (strcmp(arg, "off") == 0) js.setAutoCalibration(false);
+		else
+		{
+			sender->GetSerial()->println("ERROR WRONG PARAMETER");
+			return;
+		}
+	}
+
+	AutoCalibration::Status st = js.getAutoStatus();
+	JoystickCalibration cal = js.getCalibration();
+	float mvPerUnit = js.toVolts(ADC_FULL_SCALE) * 1000.0f / ADC_FULL_SCALE;
+	sender->GetSerial()->printf("Selbstkalibrierung %s: Totzone %.1f %%  Rauschen %.2f mV  Rückstellfehler %.1f mV  %lu mal gesichert\n",
+		js.getAutoCalibration() ? "an" : "aus", q15ToFloat(js.getDeadzone()) * 100.0f,
+		st.noise * mvPerUnit, st.returnError * mvPerUnit, (unsigned long)js.getAutoSaves());
+	sender->GetSerial()->printf("Min %.3f V  Mitte %.3f V  Max %.3f V  Ruhe seit %lu Messungen\n",
+		cal.minVal == -1 ? NAN : js.toVolts(cal.minVal), cal.center == -1 ? NAN : js.toVolts(cal.center),
+		cal.maxVal == -1 ? NAN : js.toVolts(cal.maxVal), (unsigned long)st.restSamples);
+	// only refines a complete manual calibration, never creates one
+	if (js.getAutoCalibration() && !js.isCalibrated())
+		sender->GetSerial()->println("Wartet auf Kalibrierung von Hand (Mitte, Min, Max)");
+}
+
+//tele [rate_hz]: sets or prints the WebSocket telemetry rate and counters
+void cmd_telemetry(SerialCommands* sender)
+{
+	if (sender->ArgCount() > 0)
+	{
+		long rate;
+		if (!sender->NextInt(rate))
+		{
+			sender->GetSerial()->println("ERROR WRONG PARAMETER");
+			return;
+		}
+		telemetry.setRate(rate);
+	}
+
+	TelemetryPush::Stats st = telemetry.stats();
+	sender->GetSerial()->printf("Telemetrie: %d Hz  Clients %lu  Takte %lu  gesendet %lu  verworfen %lu\n",
+		telemetry.rate(), (unsigned long)st.clients, (unsigned long)st.frames,
+		(unsigned long)st.sent, (unsigned long)st.dropped);
+}
+
+//prints free heap, largest free block and fragmentation
+void cmd_heap(SerialCommands* sender)
+{
+	HeapStats st = readHeapStats();
+	sender->GetSerial()->printf("Heap: frei %lu  größter Block %lu  Minimum %lu  Fragmentierung %u.%u %%  Laufzeit %lu s\n",
+		(unsigned long)st.freeBytes, (unsigned long)st.largestBlock, (unsigned long)st.minFreeBytes,
+		st.fragmentationPermille / 10, st.fragmentationPermille % 10, millis() / 1000);
+}
+
+//curve [lin | expo <0..1> | db <0..0.5> | fwd <min> <max> | rev <min> <max>]: changes or prints the throttle curve
+void cmd_curve(SerialCommands* sender)
+{
+	char* what = sender->Next();
+	if (what != NULL)
+	{
+		CurveConfig cfg = curve.curve();
+		float a;
+		long lo, hi;
+		if (strcmp(what, "lin") == 0)
+		{
+			cfg.forward.expo = cfg.reverse.expo = 0.0f;
+			cfg.forward.points = cfg.reverse.points = 0;
+		}
+		else if (strcmp(what, "expo") == 0 && sender->NextFloat(a))
+		{
+			cfg.forward.expo = cfg.reverse.expo = a;
+			cfg.forward.points = cfg.reverse.points = 0;
+		}
+		else if (strcmp(what, "db") == 0 && sender->NextFloat(a))
+		{
+			cfg.forward.deadband = cfg.reverse.deadband = a;
+		}
+		else if ((strcmp(what, "fwd") == 0 || strcmp(what, "rev") == 0) && sender->NextInt(lo) && sender->NextInt(hi))
+		{
+			CurveSide& side = what[0] == 'f' ? cfg.forward : cfg.reverse;
+			side.minRpm = lo;
+			side.maxRpm = hi;
+		}
+		else
+		{
+			sender->GetSerial()->println("ERROR WRONG PARAMETER");
+			return;
+		}
+		if (!curve.setCurve(cfg))
+		{
+			sender->GetSerial()->println("Werte begrenzt");
+		}
+	}
+
+	CurveConfig cfg = curve.curve();
+	const CurveSide* sides[2] = {&cfg.forward, &cfg.reverse};
+	for (int i = 0; i < 2; i++)
+	{
+		const CurveSide& s = *sides[i];
+		sender->GetSerial()->printf("%s: Totband %.3f  %ld..%ld U/min  ",
+			i == 0 ? "Vorwärts" : "Rückwärts", s.deadband, (long)s.minRpm, (long)s.maxRpm);
+		if (s.points) sender->GetSerial()->printf("%u Stützstellen\n", s.points);
+		else sender->GetSerial()->printf("Expo %.2f\n", s.expo);
+	}
+}
+
+//trace [on | off | clear | flush]: CAN trace recording, page and write counters
+void cmd_trace(SerialCommands* sender)
+{
+	char* what = sender->Next();
+	if (what != NULL)
+	{
+		if (strcmp(what, "on") == 0) cantrace.setEnabled(true);
+		else if (strcmp(what, "off") == 0) cantrace.setEnabled(false);
+		else if (strcmp(what, "clear") == 0) cantrace.clear();
+		else if (strcmp(what, "flush") == 0) cantrace.requestFlush();
+		else
+		{
+			sender->GetSerial()->println("ERROR WRONG PARAMETER");
+			return;
+		}
+	}
+
+	CanTrace::Stats st = cantrace.stats();
+	sender->GetSerial()->printf("CAN-Mitschnitt: %s  %lu Frames  verloren %lu  %lu Blöcke  Seiten %lu (vorzeitig %lu)  Datei %lu B  Schreibfehler %lu\n",
+		cantrace.isEnabled() ? "an" : "aus", (unsigned long)st.frames, (unsigned long)st.lost,
+		(unsigned long)st.blocks, (unsigned long)st.pages, (unsigned long)st.partialPages,
+		(unsigned long)st.fileBytes, (unsigned long)st.writeErrors);
+	sender->GetSerial()->printf("Schreibverstärkung %.3f  (%lu B Frames, %lu B geschrieben)\n",
+		st.writeAmplification, (unsigned long)st.frameBytes, (unsigned long)st.bytes);
+}
+
+//log [on | off | clear | flush | <rate_hz>]: flight recorder control, rate and write counters
+void cmd_log(SerialCommands* sender)
+{
+	char* what = sender->Next();
+	if (what != NULL)
+	{
+		if (strcmp(what, "on") == 0) flightlog.setEnabled(true);
+		else if (strcmp(what, "off") == 0) flightlog.setEnabled(false);
+		else if (strcmp(what, "clear") == 0) flightlog.clear();
+		else if (strcmp(what, "flush") == 0) flightlog.requestFlush();
+		else if (atoi(what) > 0) flightlog.setRate(atoi(what));
+		else
+		{
+			sender->GetSerial()->println("ERROR WRONG PARAMETER");
+			return;
+		}
+	}
+
+	FlightLog::Stats st = flightlog.stats();
+	sender->GetSerial()->printf("Flugschreiber: %s %d Hz  %lu Takte (%.1f/s)  verloren %lu  Seiten %lu (vorzeitig %lu)  Datei %lu B  Schreibfehler %lu\n",
+		flightlog.isEnabled() ? "an" : "aus", flightlog.rate(), (unsigned long)st.records, st.recordsPerSec,
+		(unsigned long)st.lost, (unsigned long)st.pages, (unsigned long)st.partialPages,
+		(unsigned long)st.fileBytes, (unsigned long)st.writeErrors);
+	sender->GetSerial()->printf("Kompression %.2fx  Schreibverstärkung %.3f  (%lu B Datensätze, %lu B geschrieben)\n",
+		st.compression, st.writeAmplification, (unsigned long)st.recordBytes, (unsigned long)st.bytes);
+}
+
+//prints binary protocol counters
+void cmd_bin(SerialCommands* sender)
+{
+	BinaryLink::Stats st = binlink.stats();
+	sender->GetSerial()->printf("Binär: %lu Rahmen  CRC-Fehler %lu  Formatfehler %lu  Sollwerte %lu (abgelehnt %lu)\n",
+		(unsigned long)st.frames, (unsigned long)st.crcErrors, (unsigned long)st.formatErrors,
+		(unsigned long)st.setpoints, (unsigned long)st.rejected);
+	sender->GetSerial()->printf("Telemetrie %lu (%d Hz)  Pong %lu  Zeitüberschreitungen %lu  Steuerung: %s\n",
+		(unsigned long)st.telemetry, binlink.streamRate(), (unsigned long)st.pongs,
+		(unsigned long)st.hostTimeouts, binlink.hostControl() ? "PC" : "Joystick");
 }
 
 SerialCommand cmd_set_rpm_("rpm", cmd_set_rpm);
+SerialCommand cmd_status_("status", cmd_status);
+SerialCommand cmd_latency_("lat", cmd_latency);
+SerialCommand cmd_filter_("filter", cmd_filter);
+SerialCommand cmd_autocal_("autocal", cmd_autocal);
+SerialCommand cmd_telemetry_("tele", cmd_telemetry);
+SerialCommand cmd_heap_("heap", cmd_heap);
+SerialCommand cmd_curve_("curve", cmd_curve);
+SerialCommand cmd_bin_("bin", cmd_bin);
+SerialCommand cmd_trace_("trace", cmd_trace);
+SerialCommand cmd_log_("log", cmd_log);
+SerialCommand cmd_tasks_("tasks", cmd_tasks);
+SerialCommand cmd_bus_("bus", cmd_bus);
 
 void setup() {
-  Serial.begin(115200);
-  if (!vesc.isOpen()) {
+  // 921600 Baud für 1-kHz-Telemetrie; TX-Puffer vor begin(), damit Rahmen nicht blockieren
+  Serial.setTxBufferSize(1024);
+  Serial.begin(921600);
+  // setup() und loop() gehören auf den Systemkern (ARDUINO_RUNNING_CORE in platformio.ini)
+  if (xPortGetCoreID() == CONTROL_CORE) Serial.println("⚠️ loop() läuft auf dem Regelkern");
+  vesc.addController(1, 500);
+  // ohne neuen Sollwert von Joystick oder PC nach 300 ms stromlos statt die letzte Drehzahl zu halten
+  vesc.setFailsafe(1, 300);
+  vesc.setCanTrace(&cantrace);
+  if (!vesc.begin()) {
     printf("❌ Fehler beim Starten von CAN");
     while (true);
   }
   Serial.println("✅ CAN bereit");
 
+  // -D JOYSTICK_ADC_POLLING: analogRead statt DMA, zum Vergleich der CPU-Last ("tasks")
+#ifdef JOYSTICK_ADC_POLLING
+  js.begin(Joystick::ADC_POLLING);
+#else
   js.begin();
+#endif
+  Serial.printf("Joystick-ADC: %s, alle %lu us\n", js.getAdcName(), (unsigned long)js.getSamplePeriodUs());
+  // LittleFS hat js.begin() gemountet
+  cantrace.begin();
+  flightlog.begin(50);
+
+  web.addJsonRoute("/latency", traceJson);
+  web.addJsonRoute("/tasks", tasksJson);
+  web.addJsonRoute("/bus", busJson);
+  web.addDownload("/cantrace.bin", LittleFS, CanTrace::FILE_PATH);
+  web.addDownload("/cantrace.1.bin", LittleFS, CanTrace::OLD_FILE_PATH);
+  web.addDownload("/flight.bin", LittleFS, FLIGHT_LOG_FILES, 2);
+  web.addHandler(telemetry.handler());
   web.begin();
+  telemetry.begin(20);
+
+  // Joystick -> Drehzahl -> CAN bei jeder neuen Messung, spätestens alle 100 ms
+  control.begin(100);
 
-  // Heartbeat automatisch alle 100ms senden
-  vesc.startHeartbeatTask(1, 500);
+  // Heartbeat: Sollwerte aller Controller periodisch senden (Periode je Controller)
+  vesc.startHeartbeatTask();
+
+  profiler.begin();
 
   delay(1000);
   
   serial_commands_.SetDefaultHandler(cmd_unrecognized);
 	serial_commands_.AddCommand(&cmd_set_rpm_);
+	serial_commands_.AddCommand(&cmd_status_);
+	serial_commands_.AddCommand(&cmd_latency_);
+	serial_commands_.AddCommand(&cmd_filter_);
+	serial_commands_.AddCommand(&cmd_autocal_);
+	serial_commands_.AddCommand(&cmd_telemetry_);
+	serial_commands_.AddCommand(&cmd_heap_);
+	serial_commands_.AddCommand(&cmd_curve_);
+	serial_commands_.AddCommand(&cmd_bin_);
+	serial_commands_.AddCommand(&cmd_trace_);
+	serial_commands_.AddCommand(&cmd_log_);
+	serial_commands_.AddCommand(&cmd_tasks_);
+	serial_commands_.AddCommand(&cmd_bus_);
+	binlink.attach(serial_commands_);
+	serial_task_.begin();
+	binlink.begin();
 
   Serial.println("Ready ...!");
 }
 
 void loop() {
-  static unsigned long lastTime = 0;
-  unsigned long now = millis();
-
-  serial_commands_.ReadSerial();
-
   //web.handle(); // DNS für Captive Portal
 
-  if (now - lastTime >= 100) {  // alle 100ms
-      lastTime = now;
+  // Befehle verarbeitet serial_task_; hier nur noch alle 100 ms die Ausgabe, ohne Dauerabfrage
+  delay(100);
+  // solange der PC Telemetrie abruft, keine Textzeilen dazwischen
+  if (binlink.streamRate()) return;
 
-      float val = js.getValue();
-      float volt = js.getVoltage();
+  JoystickSnapshot s = js.getSnapshot();
 
-      if (isnan(val) || isnan(volt)) {
-          //Serial.println("Joystick noch nicht kalibriert!");
-      } else {
-          Serial.printf("Normiert: %.2f   Spannung: %.2f V\n", val, volt);
-          vesc.setRpm(1, mapSplit(val));
-      }
+  if (!s.calibrated) {
+      //Serial.println("Joystick noch nicht kalibriert!");
+  } else {
+      Serial.printf("Normiert: %.2f   Spannung: %.2f V\n", q15ToFloat(s.value), js.toVolts(s.raw));
   }
 }
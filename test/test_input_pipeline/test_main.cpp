@@ -0,0 +1,191 @@
+// Genauigkeit der ganzzahligen Eingabekette vom ADC-Wert bis Q15:
+//   pio test -e native
+// Dieselben Grenzen wie Joystick_mapAccuracy und Filter_* in bench/, hier als Prüfung.
+
+#include <math.h>
+#include <stdio.h>
+#include <unity.h>
+#include <algorithm>
+
+#include "AxisFilterBank.h"
+#include "Joystick.h"
+
+namespace {
+
+const float V_REF = 3.3f;
+
+uint16_t counts(float volts) {
+    return (uint16_t)lrintf(volts / V_REF * ADC_FULL_SCALE);
+}
+
+// Kalibrierung bei 0,4 / 1,65 / 2,9 V ohne Glättung, jeder Wert wird sofort übernommen
+void calibrate(Joystick& js) {
+    FilterConfig passthrough;
+    passthrough.average = 1;
+    js.setFilter(passthrough);
+    js.update(counts(1.65f));
+    js.calibrateCenter();
+    js.update(counts(0.4f));
+    js.calibrateMin();
+    js.update(counts(2.9f));
+    js.calibrateMax();
+}
+
+// Verrauschte Messreihe mit gelegentlichen Ausreißern, wie in FilterBench
+const int SIGNAL_LEN = 1024;
+
+void noisySignal(uint16_t* signal) {
+    uint32_t seed = 12345;
+    for (int i = 0; i < SIGNAL_LEN; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = ((seed >> 8) & 0xFFFF) / 65536.0f - 0.5f;
+        float volts = 1.65f + 0.8f * sinf(i * 0.01f) + 0.02f * noise;
+        if (i % 97 == 0) volts += 1.0f;
+        signal[i] = (uint16_t)std::min((int32_t)lrintf(volts / V_REF * ADC_FULL_SCALE), (int32_t)ADC_FULL_SCALE);
+    }
+}
+
+// Dieselbe Kette in double als Maßstab
+class ReferenceChain {
+public:
+    explicit ReferenceChain(const FilterConfig& cfg) : cfg(cfg) {}
+
+    double process(double x) {
+        if (!primed) {
+            for (int i = 0; i < cfg.median; i++) med[i] = x;
+            for (int i = 0; i < cfg.average; i++) avg[i] = x;
+            iir = kalmanX = x;
+            kalmanP = cfg.kalmanR;
+            primed = true;
+        }
+        if (cfg.median > 1) {
+            med[medIndex] = x;
+            medIndex = (medIndex + 1) % cfg.median;
+            double sorted[FilterChain::MAX_MEDIAN];
+            for (int i = 0; i < cfg.median; i++) {
+                int k = i;
+                for (; k > 0 && sorted[k - 1] > med[i]; k--) sorted[k] = sorted[k - 1];
+                sorted[k] = med[i];
+            }
+            x = sorted[cfg.median / 2];
+        }
+        if (cfg.average > 1) {
+            avg[avgIndex] = x;
+            avgIndex = (avgIndex + 1) % cfg.average;
+            double sum = 0;
+            for (int i = 0; i < cfg.average; i++) sum += avg[i];
+            x = sum / cfg.average;
+        }
+        if (cfg.iirAlpha < 1.0f) x = iir += cfg.iirAlpha * (x - iir);
+        if (cfg.kalmanR > 0.0f) {
+            kalmanP += cfg.kalmanQ;
+            double k = kalmanP / (kalmanP + cfg.kalmanR);
+            x = kalmanX += k * (x - kalmanX);
+            kalmanP *= 1.0 - k;
+        }
+        return x;
+    }
+
+private:
+    FilterConfig cfg;
+    bool primed = false;
+    double med[FilterChain::MAX_MEDIAN], avg[FilterChain::MAX_AVERAGE];
+    int medIndex = 0, avgIndex = 0;
+    double iir = 0, kalmanX = 0, kalmanP = 0;
+};
+
+FilterConfig makeConfig(uint8_t median, uint8_t average, float alpha, float q = 0, float r = 0) {
+    FilterConfig cfg;
+    cfg.median = median;
+    cfg.average = average;
+    cfg.iirAlpha = alpha;
+    cfg.kalmanQ = q;
+    cfg.kalmanR = r;
+    return cfg;
+}
+
+}  // namespace
+
+void setUp() {}
+void tearDown() {}
+
+// Die Mitte liegt auf die Messung genau im NVS, nicht auf ganze Volt abgeschnitten
+void test_center_stored_exactly() {
+    {
+        Joystick js(GPIO_NUM_10);
+        calibrate(js);
+    }
+    Joystick js(GPIO_NUM_10);
+    js.begin(Joystick::ADC_POLLING);
+    JoystickCalibration cal = js.getCalibration();
+    TEST_ASSERT_EQUAL_INT32(counts(1.65f), cal.center);
+    TEST_ASSERT_EQUAL_INT32(counts(0.4f), cal.minVal);
+    TEST_ASSERT_EQUAL_INT32(counts(2.9f), cal.maxVal);
+    TEST_ASSERT_TRUE(js.isCalibrated());
+}
+
+// Jeder ADC-Wert gegen eine Rechnung in double: höchstens die Rundung des Q15-Werts
+void test_map_error_within_half_lsb() {
+    Joystick js(GPIO_NUM_10);
+    calibrate(js);
+    JoystickCalibration cal = js.getCalibration();
+    q15_t deadzone = q15FromFloat(0.05f);
+
+    double worst = 0;
+    uint32_t worstRaw = 0;
+    for (uint32_t raw = 0; raw <= ADC_FULL_SCALE; raw++) {
+        js.update((uint16_t)raw);
+        JoystickSnapshot s = js.getSnapshot();
+        TEST_ASSERT_TRUE(s.calibrated);
+        double d = (double)raw - cal.center;
+        double ref = d / (d >= 0 ? cal.maxVal - cal.center : cal.center - cal.minVal);
+        ref = fmax(-1.0, fmin(1.0, ref));
+        if (fabs(ref) * Q15_ONE < deadzone) ref = 0;
+        double err = fabs(s.value - ref * Q15_ONE);
+        if (err > worst) {
+            worst = err;
+            worstRaw = raw;
+        }
+    }
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%.4f LSB bei raw %u", worst, (unsigned)worstRaw);
+    TEST_ASSERT_TRUE_MESSAGE(worst <= 0.5 + 1e-9, msg);
+}
+
+// Festkomma-Kette gegen double: höchstens 0,68 ADC-Einheiten (1/16 Zählwert)
+void test_filter_error_within_limit() {
+    const FilterConfig configs[] = {
+        makeConfig(1, 32, 1.0f),
+        makeConfig(1, 8, 1.0f),
+        makeConfig(1, 1, 0.1f),
+        makeConfig(5, 1, 1.0f),
+        makeConfig(5, 1, 0.2f),
+        makeConfig(1, 1, 1.0f, 1e-5f, 4e-4f),
+        makeConfig(9, 16, 1.0f, 1e-5f, 4e-4f),
+    };
+    static uint16_t signal[SIGNAL_LEN];
+    noisySignal(signal);
+
+    for (const FilterConfig& cfg : configs) {
+        AxisFilterBank<1> bank(cfg);
+        ReferenceChain ref(cfg);
+        double worst = 0;
+        for (int i = 0; i < 4 * SIGNAL_LEN; i++) {
+            uint16_t x = signal[i & (SIGNAL_LEN - 1)], out;
+            bank.process(&x, &out);
+            worst = std::max(worst, fabs(out - ref.process(x)));
+        }
+        char msg[96];
+        snprintf(msg, sizeof(msg), "Median %u Mittelwert %u IIR %.2f Kalman R %g: %.4f LSB",
+                 cfg.median, cfg.average, cfg.iirAlpha, cfg.kalmanR, worst);
+        TEST_ASSERT_TRUE_MESSAGE(worst <= 0.68, msg);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_center_stored_exactly);
+    RUN_TEST(test_map_error_within_half_lsb);
+    RUN_TEST(test_filter_error_within_limit);
+    return UNITY_END();
+}
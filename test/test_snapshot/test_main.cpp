@@ -0,0 +1,91 @@
+// Belastungsprobe des Joystick-Schnappschusses:
+//   pio test -e native
+// Ein Schreiber im Dauerlauf, vier Leser auf eigenen Threads. Jeder Schnappschuss muss
+// in sich stimmig sein: der ADC-Wert gehört zur Messungsnummer, Nummer und Zeit laufen
+// für jeden Leser nie rückwärts.
+
+#include <stdio.h>
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Joystick.h"
+
+namespace {
+
+const int READERS = 4;
+const int RUN_MS = 500;
+
+// Eingabe der n-ten Messung
+uint16_t input(uint32_t n) {
+    return (uint16_t)((n % 4096) << ADC_FRACTION_BITS);
+}
+
+struct Failures {
+    std::atomic<uint32_t> torn{0};          // raw gehört nicht zu samples
+    std::atomic<uint32_t> samplesBack{0};   // Messungsnummer kleiner als beim letzten Lesen
+    std::atomic<uint32_t> timeBack{0};      // Zeit älter als beim letzten Lesen
+};
+
+void check(const JoystickSnapshot& s, JoystickSnapshot& last, Failures& f) {
+    if (s.samples > 1 && s.raw != input(s.samples)) f.torn.fetch_add(1, std::memory_order_relaxed);
+    if (s.samples < last.samples) f.samplesBack.fetch_add(1, std::memory_order_relaxed);
+    // vor der ersten Messung ist timeUs 0
+    if (last.samples != 0 && (int32_t)(s.timeUs - last.timeUs) < 0) f.timeBack.fetch_add(1, std::memory_order_relaxed);
+    last = s;
+}
+
+}  // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_snapshot_never_torn() {
+    Joystick js(GPIO_NUM_10);
+    FilterConfig passthrough;
+    passthrough.average = 1;
+    js.setFilter(passthrough);
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reads{0};
+    Failures f;
+
+    std::thread writer([&] {
+        uint32_t n = 0;
+        while (!stop.load(std::memory_order_relaxed)) js.update(input(++n));
+    });
+    std::thread readers[READERS];
+    for (std::thread& t : readers) {
+        t = std::thread([&] {
+            JoystickSnapshot last = js.getSnapshot();
+            uint64_t n = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                check(js.getSnapshot(), last, f);
+                n++;
+            }
+            reads.fetch_add(n);
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(RUN_MS));
+    stop = true;
+    writer.join();
+    for (std::thread& t : readers) t.join();
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%llu Lesezugriffe bei %lu Messungen",
+             (unsigned long long)reads.load(), (unsigned long)js.getSnapshot().samples);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE_MESSAGE(js.getSnapshot().samples > 1000, "Schreiber kam nicht voran");
+    TEST_ASSERT_TRUE_MESSAGE(reads.load() > 1000, "Leser kamen nicht voran");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, f.torn.load(), "zerrissene Schnappschüsse");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, f.samplesBack.load(), "Messungsnummer lief rückwärts");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, f.timeBack.load(), "Zeit lief rückwärts");
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_snapshot_never_torn);
+    return UNITY_END();
+}
@@ -0,0 +1,127 @@
+# Erzeugt aus web/ die eingebetteten Web-Assets (lib/JoystickWebServer/WebAssets.generated.cpp).
+#
+#  - Dateinamen erhalten einen Inhalts-Hash (materialize.min.3f2a1b9c.css), Verweise in
+#    HTML und CSS werden umgeschrieben; so können diese Dateien unbegrenzt gecacht werden.
+#  - Textdateien werden gzip-komprimiert (woff2 ist bereits komprimiert).
+#  - index.html behält ihren Pfad (/ und /index.html) und wird per ETag revalidiert.
+#
+# Läuft als PlatformIO-Vorab-Skript bei jedem Build von env:esp32-s3-devkitm-1 und
+# lässt sich auch direkt aufrufen:  python tools/build_web_assets.py
+
+import gzip
+import hashlib
+import os
+
+try:
+    Import("env")  # noqa: F821 (von PlatformIO bereitgestellt)
+    ROOT = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+WEB_DIR = os.path.join(ROOT, "web")
+OUTPUT = os.path.join(ROOT, "lib", "JoystickWebServer", "WebAssets.generated.cpp")
+
+CONTENT_TYPES = {
+    ".html": "text/html; charset=utf-8",
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".woff2": "font/woff2",
+}
+COMPRESS = {".html", ".css", ".js"}
+
+# Reihenfolge: was verwiesen wird, muss vor dem Verweisenden gehasht sein
+ORDER = [".woff2", ".js", ".css", ".html"]
+ENTRY = "/index.html"
+
+
+def collect():
+    files = []
+    for base, _, names in os.walk(WEB_DIR):
+        for name in names:
+            full = os.path.join(base, name)
+            path = "/" + os.path.relpath(full, WEB_DIR).replace(os.sep, "/")
+            ext = os.path.splitext(name)[1]
+            if ext not in CONTENT_TYPES:
+                raise SystemExit("build_web_assets: unbekannter Dateityp " + path)
+            files.append(path)
+    return sorted(files, key=lambda p: (ORDER.index(os.path.splitext(p)[1]), p))
+
+
+def build():
+    renamed = {}   # logischer Pfad -> ausgelieferter Pfad
+    assets = []
+    for path in collect():
+        ext = os.path.splitext(path)[1]
+        with open(os.path.join(WEB_DIR, path[1:]), "rb") as f:
+            content = f.read()
+        if ext in (".html", ".css"):
+            text = content.decode("utf-8")
+            for old, new in renamed.items():
+                text = text.replace(old, new)
+            content = text.encode("utf-8")
+
+        digest = hashlib.sha256(content).hexdigest()[:16]
+        if path == ENTRY:
+            served = [ENTRY, "/"]
+        else:
+            stem, _ = os.path.splitext(path)
+            served = ["%s.%s%s" % (stem, digest[:8], ext)]
+            renamed[path] = served[0]
+
+        gz = ext in COMPRESS
+        if gz:
+            content = gzip.compress(content, compresslevel=9, mtime=0)
+        for p in served:
+            assets.append({
+                "path": p,
+                "type": CONTENT_TYPES[ext],
+                "etag": '"%s"' % digest,
+                "gzip": gz,
+                "immutable": path != ENTRY,
+                "symbol": "asset_" + digest,
+                "data": content,
+            })
+    return assets
+
+
+def render(assets):
+    out = ["// Automatisch erzeugt von tools/build_web_assets.py aus web/ - nicht bearbeiten.",
+           "#include \"WebAssets.h\"", ""]
+    emitted = set()
+    for a in assets:
+        if a["symbol"] in emitted:
+            continue
+        emitted.add(a["symbol"])
+        out.append("static const uint8_t %s[] PROGMEM = {" % a["symbol"])
+        data = a["data"]
+        for i in range(0, len(data), 24):
+            out.append("    " + ",".join(str(b) for b in data[i:i + 24]) + ",")
+        out.append("};")
+        out.append("")
+    out.append("const WebAsset WEB_ASSETS[] = {")
+    for a in assets:
+        out.append('    {"%s", "%s", "%s", %s, sizeof(%s), %s, %s},' % (
+            a["path"], a["type"], a["etag"].replace('"', '\\"'), a["symbol"], a["symbol"],
+            "true" if a["gzip"] else "false", "true" if a["immutable"] else "false"))
+    out.append("};")
+    out.append("const size_t WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    assets = build()
+    text = render(assets)
+    old = None
+    if os.path.exists(OUTPUT):
+        with open(OUTPUT, "r", encoding="utf-8") as f:
+            old = f.read()
+    # nur bei Änderungen schreiben, damit der Build nicht unnötig neu übersetzt
+    if text != old:
+        with open(OUTPUT, "w", encoding="utf-8") as f:
+            f.write(text)
+    for a in assets:
+        print("web asset %-40s %7d B%s" % (a["path"], len(a["data"]), " (gzip)" if a["gzip"] else ""))
+
+
+main()
@@ -0,0 +1,102 @@
+# Wandelt den CAN-Mitschnitt des Geräts (lib/CanTrace, /cantrace.bin) in das Logformat
+# von candump -l, z. B. für canplayer, log2asc oder cantools.
+#
+#   curl -O http://192.168.4.1/cantrace.1.bin -O http://192.168.4.1/cantrace.bin
+#   python tools/cantrace2candump.py cantrace.1.bin cantrace.bin > fahrt.log
+#
+# Mehrere Dateien werden in der angegebenen Reihenfolge ausgegeben (ältere zuerst).
+# Zeitstempel sind Sekunden seit dem Start des Geräts, mit --start <Unix-Zeit> absolut.
+# Von twai_transmit abgelehnte Frames waren nie auf dem Bus und fehlen im Log; sie und
+# im Gerät verlorene Frames werden auf stderr gezählt.
+
+import argparse
+import struct
+import sys
+
+FILE_MAGIC = b"CTR1"
+BLOCK_MARKER = 0xCB
+
+TX, EXT, RTR, ERR, LEN = 0x80, 0x40, 0x20, 0x10, 0x0F
+RESULTS = {1: "timeout", 2: "invalid state", 3: "fail"}
+
+
+class TraceError(Exception):
+    pass
+
+
+def read_varint(data, pos):
+    value = shift = 0
+    while True:
+        if pos >= len(data):
+            raise TraceError("varint über Dateiende")
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if b < 0x80:
+            return value, pos
+        shift += 7
+
+
+def frames(data):
+    """Liefert (Zeit us, flags, result, id, Daten) und (None, verloren, ...) je Block."""
+    if data[:4] != FILE_MAGIC:
+        raise TraceError("kein CAN-Mitschnitt (Kopf %r)" % data[:4])
+    pos = 4
+    while pos < len(data):
+        if data[pos] != BLOCK_MARKER or pos + 13 > len(data):
+            raise TraceError("Block erwartet bei Offset %d" % pos)
+        us, count, lost = struct.unpack_from("<QHH", data, pos + 1)
+        pos += 13
+        if lost:
+            yield us, None, lost, 0, b""
+        for _ in range(count):
+            flags = data[pos]
+            pos += 1
+            result = 0
+            if flags & ERR:
+                result = data[pos]
+                pos += 1
+            delta, pos = read_varint(data, pos)
+            ident, pos = read_varint(data, pos)
+            n = 0 if flags & RTR else flags & LEN
+            payload = data[pos:pos + n]
+            pos += n
+            us += delta
+            yield us, flags, result, ident, payload
+
+
+def main():
+    ap = argparse.ArgumentParser(description="CAN-Mitschnitt (cantrace.bin) -> candump-Log")
+    ap.add_argument("files", nargs="+", help="Mitschnitte, ältere zuerst")
+    ap.add_argument("--iface", default="can0", help="Schnittstellenname im Log (Standard can0)")
+    ap.add_argument("--tx-iface", help="eigener Name für gesendete Frames, z. B. can0tx")
+    ap.add_argument("--start", type=float, default=0.0, help="Unix-Zeit des Gerätestarts")
+    args = ap.parse_args()
+
+    out = sys.stdout
+    written = failed = lost = 0
+    for name in args.files:
+        with open(name, "rb") as f:
+            data = f.read()
+        try:
+            for us, flags, result, ident, payload in frames(data):
+                if flags is None:
+                    lost += result
+                    print("%s: %d Frames vor %.6f verloren" % (name, result, us / 1e6), file=sys.stderr)
+                    continue
+                if flags & ERR:
+                    failed += 1
+                    continue
+                iface = args.tx_iface if (flags & TX) and args.tx_iface else args.iface
+                ident_hex = "%08X" % ident if flags & EXT else "%03X" % ident
+                body = "R" if flags & RTR else payload.hex().upper()
+                out.write("(%.6f) %s %s#%s\n" % (args.start + us / 1e6, iface, ident_hex, body))
+                written += 1
+        except (TraceError, IndexError) as e:
+            # abgeschnittener letzter Block (Stromausfall): Rest der Datei überspringen
+            print("%s: %s, Rest übersprungen" % (name, e), file=sys.stderr)
+
+    print("%d Frames, %d abgelehnt, %d verloren" % (written, failed, lost), file=sys.stderr)
+
+
+main()
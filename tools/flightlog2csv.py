@@ -0,0 +1,109 @@
+# Wandelt den Flugschreiber des Geräts (lib/FlightLog, /flight.bin) in CSV, z. B. für
+# eine Tabellenkalkulation oder pandas.
+#
+#   curl -o flug.bin http://192.168.4.1/flight.bin
+#   python tools/flightlog2csv.py flug.bin > flug.csv
+#
+# /flight.bin liefert beide Dateien des Geräts schon in der richtigen Reihenfolge; einzelne
+# Dateien werden in der angegebenen Reihenfolge ausgegeben (ältere zuerst). Zeitstempel
+# sind Sekunden seit dem Start des Geräts. Felder ohne gültigen Wert (Flag nicht gesetzt)
+# bleiben leer.
+
+import argparse
+import struct
+import sys
+
+PAGE_MAGIC = b"FLG1"
+RECORD_MARK = 0x80
+CALIBRATED, SETPOINT, STATUS, HOST = 0x01, 0x02, 0x04, 0x08
+FIELDS = ("stick", "rpm", "erpm", "current", "duty", "vin")
+
+
+class LogError(Exception):
+    pass
+
+
+def read_varint(data, pos):
+    value = shift = 0
+    while True:
+        if pos >= len(data):
+            raise LogError("varint über Dateiende")
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if b < 0x80:
+            return value, pos
+        shift += 7
+
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def records(data):
+    """Liefert (Zeit us, Felder als Liste, flags) je Datensatz."""
+    pos = 0
+    us = 0
+    values = [0] * len(FIELDS)
+    flags = 0
+    while pos < len(data):
+        b = data[pos]
+        if b == 0:
+            pos += 1                                # Füllung am Seitenende
+        elif data[pos:pos + 4] == PAGE_MAGIC:
+            if pos + 12 > len(data):
+                raise LogError("Seitenkopf abgeschnitten bei Offset %d" % pos)
+            (us,) = struct.unpack_from("<Q", data, pos + 4)
+            values = [0] * len(FIELDS)
+            flags = 0
+            pos += 12
+        elif b & RECORD_MARK:
+            mask = b
+            delta, pos = read_varint(data, pos + 1)
+            us += delta
+            for i in range(len(FIELDS)):
+                if mask & (1 << i):
+                    d, pos = read_varint(data, pos)
+                    values[i] = (values[i] + unzigzag(d) + 2**31) % 2**32 - 2**31
+            if mask & 0x40:
+                if pos >= len(data):
+                    raise LogError("flags über Dateiende")
+                flags = data[pos]
+                pos += 1
+            yield us, list(values), flags
+        else:
+            raise LogError("unerwartetes Byte 0x%02X bei Offset %d" % (b, pos))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Flugschreiber (flight.bin) -> CSV")
+    ap.add_argument("files", nargs="+", help="Mitschnitte, ältere zuerst")
+    args = ap.parse_args()
+
+    out = sys.stdout
+    out.write("t_s,stick,rpm,erpm,current_a,duty,vin_v,host\n")
+    written = 0
+    for name in args.files:
+        with open(name, "rb") as f:
+            data = f.read()
+        try:
+            for us, v, flags in records(data):
+                stick, rpm, erpm, current, duty, vin = v
+                cols = ["%.6f" % (us / 1e6)]
+                cols.append("%.4f" % (stick / 32767) if flags & CALIBRATED else "")
+                cols.append(str(rpm) if flags & SETPOINT else "")
+                if flags & STATUS:
+                    cols += [str(erpm), "%.1f" % (current / 10), "%.3f" % (duty / 1000), "%.1f" % (vin / 10)]
+                else:
+                    cols += ["", "", "", ""]
+                cols.append("1" if flags & HOST else "0")
+                out.write(",".join(cols) + "\n")
+                written += 1
+        except LogError as e:
+            # abgeschnittene letzte Seite (Stromausfall): Rest der Datei überspringen
+            print("%s: %s, Rest übersprungen" % (name, e), file=sys.stderr)
+
+    print("%d Datensätze" % written, file=sys.stderr)
+
+
+main()